@@ -0,0 +1,53 @@
+import os
+import logging
+
+from cutekit import shell, builder, const, project
+from cutekit.cmds import Cmd, append
+from cutekit.args import Args
+
+logger = logging.getLogger("bench")
+
+APPS = [
+    "hideo-about",
+    "hideo-calculator",
+    "hideo-clock",
+    "hideo-colorpicker",
+    "hideo-counter",
+    "hideo-file-manager",
+    "hideo-font-viewer",
+    "hideo-image-viewer",
+    "hideo-notepad",
+    "hideo-settings",
+    "hideo-shell",
+    "hideo-spreadsheet",
+]
+
+
+def benchCmd(args: Args) -> None:
+    project.chdir()
+
+    targetSpec = str(args.consumeOpt("target", "host-x86_64:o3"))
+    only = str(args.consumeOpt("app", ""))
+    apps = [only] if only else APPS
+
+    outDir = f"{const.PROJECT_CK_DIR}/bench"
+    shell.mkdir(outDir)
+
+    for app in apps:
+        logger.info(f"Benchmarking {app}...")
+        component = builder.build(app, targetSpec)
+        report = os.path.abspath(f"{outDir}/{app}.csv")
+        capture = os.path.abspath(f"{outDir}/{app}.qoi")
+        shell.exec(
+            component.outfile(),
+            "+bench",
+            "+report",
+            f"file:{report}",
+            "+capture",
+            f"file:{capture}",
+        )
+
+    print(f"Frame reports are in {outDir}")
+
+
+append(Cmd(None, "bench", "Run a scripted session of each app headlessly and report frame timings", benchCmd))
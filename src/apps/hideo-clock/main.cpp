@@ -11,8 +11,8 @@ struct Clock : public Ui::View<Clock> {
 
     Clock(Time time) : _time(time) {}
 
-    void reconcile(Clock &o) override {
-        _time = o._time;
+    bool reconcile(Clock &o) override {
+        return Ui::reconcileProp(_time, o._time);
     }
 
     void drawHand(Gfx::Context &g, f64 angle, f64 length, Gfx::Color color, f64 width) {
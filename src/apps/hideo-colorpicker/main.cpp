@@ -17,9 +17,9 @@ struct HsvPicker : public Ui::View<HsvPicker> {
     HsvPicker(Gfx::Hsv value, Ui::OnChange<Gfx::Hsv> onChange)
         : _value{value}, _onChange{std::move(onChange)} {}
 
-    void reconcile(HsvPicker &o) override {
-        _value = o._value;
+    bool reconcile(HsvPicker &o) override {
         _onChange = std::move(o._onChange);
+        return Ui::reconcileProp(_value, o._value);
     }
 
     Gfx::Hsv sampleHsv(Math::Vec2i pos) {
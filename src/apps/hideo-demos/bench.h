@@ -0,0 +1,58 @@
+#pragma once
+
+#include <karm-ui/headless.h>
+#include <karm-ui/scafold.h>
+
+#include "base.h"
+
+namespace Demos {
+
+// Measures how long full screen repaints take.
+struct BenchHost : public Ui::HeadlessHost {
+    using Ui::HeadlessHost::HeadlessHost;
+
+    TimeSpan repaint(usize frames) {
+        auto start = Sys::uptime();
+        for (usize i = 0; i < frames; i++) {
+            _dirty.pushBack(bound());
+            paint();
+        }
+        return TimeSpan::fromUSecs((Sys::uptime() - start).toUSecs() / frames);
+    }
+};
+
+inline Res<> bench(Slice<Demo *> demos) {
+    static constexpr Math::Vec2i SIZE = {3840, 2160};
+    static constexpr usize FRAMES = 16;
+
+    for (auto *demo : demos) {
+        BenchHost host{
+            Ui::scafold({
+                .icon = demo->icon,
+                .title = demo->name,
+                .body = demo->build(),
+            }),
+            SIZE,
+        };
+        host.doLayout();
+
+        host._tiled = false;
+        auto direct = host.repaint(FRAMES);
+
+        host._tiled = true;
+        auto tiled = host.repaint(FRAMES);
+
+        logInfo(
+            "{}: direct {}us, tiled {}us per {}x{} frame",
+            demo->name,
+            direct.toUSecs(),
+            tiled.toUSecs(),
+            SIZE.x,
+            SIZE.y
+        );
+    }
+
+    return Ok();
+}
+
+} // namespace Demos
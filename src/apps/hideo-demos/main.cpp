@@ -8,6 +8,7 @@
 #include <karm-ui/scroll.h>
 #include <karm-ui/view.h>
 
+#include "bench.h"
 #include "demo-circle.h"
 #include "demo-gradient.h"
 #include "demo-hello.h"
@@ -78,5 +79,8 @@ Ui::Child app() {
 } // namespace Demos
 
 Res<> entryPoint(Ctx &ctx) {
+    auto &args = useArgs(ctx);
+    if (args.has("+bench"))
+        return Demos::bench(Demos::DEMOS);
     return Ui::runApp(ctx, Demos::app());
 }
@@ -13,8 +13,10 @@ struct Table : public Ui::View<Table> {
     Table(State const &state)
         : _state(&state) {}
 
-    void reconcile(Table &o) override {
+    bool reconcile(Table &o) override {
+        // The state is changed in place, the table can't tell what moved.
         _state = o._state;
+        return true;
     }
 
     Sheet const &sheet() {
@@ -288,6 +288,26 @@ Res<> populate(Vec<Sys::UserInfo> &) {
     return Error::notImplemented();
 }
 
+Res<Strong<Sys::Thread>> spawnThread(Func<void()>) {
+    return Error::notImplemented();
+}
+
+usize cpuCount() {
+    return 1;
+}
+
+Res<Strong<Sys::Mutex>> createMutex() {
+    return Error::notImplemented();
+}
+
+Res<Strong<Sys::Sema>> createSema(usize) {
+    return Error::notImplemented();
+}
+
+Res<Strong<Sys::CondVar>> createCondVar() {
+    return Error::notImplemented();
+}
+
 TimeStamp now() {
     Efi::Time t;
     Efi::rt()->getTime(&t, nullptr).unwrap();
@@ -308,6 +328,13 @@ TimeStamp now() {
            TimeSpan::fromUSecs(t.nanosecond / 1000);
 }
 
+TimeSpan uptime() {
+    // There is no monotonic clock in boot services, count
+    // from the first time we were asked.
+    static TimeStamp start = now();
+    return now() - start;
+}
+
 Res<> sleep(TimeSpan) {
     return Error::notImplemented();
 }
@@ -1,10 +1,115 @@
 #include <karm-async/async.h>
 #include <karm-sys/proc.h>
 
+#include <errno.h>
+#include <time.h>
+#include <unistd.h>
+
+#ifdef __ck_sys_linux__
+#    include <sys/epoll.h>
+#else
+#    include <poll.h>
+#endif
+
+#include "errno.h"
+
 namespace Karm::Async::_Embed {
 
+static int _timeoutMs(TimeStamp now, TimeStamp until) {
+    if (until.isEndOfTime())
+        return -1;
+
+    if (until <= now)
+        return 0;
+
+    // NOTE: Round up so that we never wake up before the deadline.
+    auto span = until - now;
+    return min((span.toUSecs() + 999) / 1000, (usize)INT_MAX);
+}
+
+#ifdef __ck_sys_linux__
+
+struct PosixLoop : public Loop {
+    static constexpr usize MAX_EVENTS = 64;
+
+    TimeStamp _now;
+    int _epoll = -1;
+
+    PosixLoop(TimeStamp now)
+        : _now(now), _epoll(epoll_create1(EPOLL_CLOEXEC)) {}
+
+    ~PosixLoop() {
+        if (_epoll >= 0)
+            close(_epoll);
+    }
+
+    TimeStamp now() override {
+        return _now;
+    }
+
+    Res<> _arm(usize handle, Interest interest) override {
+        if (_epoll < 0)
+            return Error::notImplemented("epoll not available");
+
+        struct epoll_event ev = {};
+        if (!!(interest & Interest::READ))
+            ev.events |= EPOLLIN;
+        if (!!(interest & Interest::WRITE))
+            ev.events |= EPOLLOUT;
+        ev.data.u64 = handle;
+
+        if (epoll_ctl(_epoll, EPOLL_CTL_ADD, handle, &ev) < 0) {
+            if (errno != EEXIST)
+                return Posix::fromLastErrno();
+
+            if (epoll_ctl(_epoll, EPOLL_CTL_MOD, handle, &ev) < 0)
+                return Posix::fromLastErrno();
+        }
+
+        return Ok();
+    }
+
+    void _disarm(usize handle) override {
+        // NOTE: The fd might already be closed, in which case the
+        //       kernel already removed it from the interest list.
+        epoll_ctl(_epoll, EPOLL_CTL_DEL, handle, nullptr);
+    }
+
+    Res<> wait(TimeStamp until) override {
+        if (_epoll < 0) {
+            try$(Sys::sleepUntil(until));
+            _now = Sys::now();
+            return Ok();
+        }
+
+        Array<struct epoll_event, MAX_EVENTS> events;
+        int n = epoll_wait(_epoll, events.buf(), MAX_EVENTS, _timeoutMs(Sys::now(), until));
+        _now = Sys::now();
+
+        if (n < 0) {
+            if (errno == EINTR)
+                return Ok();
+            return Posix::fromLastErrno();
+        }
+
+        for (int i = 0; i < n; i++) {
+            Interest ready = Interest::NONE;
+            if (events[i].events & (EPOLLIN | EPOLLHUP | EPOLLERR))
+                ready |= Interest::READ;
+            if (events[i].events & (EPOLLOUT | EPOLLERR))
+                ready |= Interest::WRITE;
+            _ready(events[i].data.u64, ready);
+        }
+
+        return Ok();
+    }
+};
+
+#else
+
 struct PosixLoop : public Loop {
     TimeStamp _now;
+    Vec<struct pollfd> _fds;
 
     PosixLoop(TimeStamp now) : _now(now) {}
 
@@ -12,13 +117,57 @@ struct PosixLoop : public Loop {
         return _now;
     }
 
+    Res<> _arm(usize handle, Interest interest) override {
+        short events = 0;
+        if (!!(interest & Interest::READ))
+            events |= POLLIN;
+        if (!!(interest & Interest::WRITE))
+            events |= POLLOUT;
+
+        for (auto &fd : _fds) {
+            if (fd.fd == (int)handle) {
+                fd.events = events;
+                return Ok();
+            }
+        }
+
+        _fds.pushBack({(int)handle, events, 0});
+        return Ok();
+    }
+
+    void _disarm(usize handle) override {
+        for (usize i = 0; i < _fds.len(); i++) {
+            if (_fds[i].fd == (int)handle)
+                _fds.removeAt(i--);
+        }
+    }
+
     Res<> wait(TimeStamp until) override {
-        try$(Sys::sleepUntil(until));
+        int n = ::poll(_fds.buf(), _fds.len(), _timeoutMs(Sys::now(), until));
         _now = Sys::now();
+
+        if (n < 0) {
+            if (errno == EINTR)
+                return Ok();
+            return Posix::fromLastErrno();
+        }
+
+        for (auto &fd : _fds) {
+            Interest ready = Interest::NONE;
+            if (fd.revents & (POLLIN | POLLHUP | POLLERR))
+                ready |= Interest::READ;
+            if (fd.revents & (POLLOUT | POLLERR))
+                ready |= Interest::WRITE;
+            if (ready != Interest::NONE)
+                _ready(fd.fd, ready);
+        }
+
         return Ok();
     }
 };
 
+#endif
+
 static Opt<PosixLoop> _loop;
 Loop &loop() {
     if (not _loop) {
@@ -10,11 +10,11 @@ void relaxe() {
 }
 
 void enterCritical() {
-    // NOTE: We don't do any thread so we don't need to do anything here.
+    // NOTE: Userspace can't disable preemption, locks just spin.
 }
 
 void leaveCritical() {
-    // NOTE: We don't do any thread so we don't need to do anything here.
+    // NOTE: Userspace can't disable preemption, locks just spin.
 }
 
 } // namespace Karm::_Embed
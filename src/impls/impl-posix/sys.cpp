@@ -7,6 +7,7 @@
 #include <dirent.h>
 #include <errno.h>
 #include <fcntl.h>
+#include <pthread.h>
 #include <stdlib.h>
 #include <sys/mman.h>
 #include <sys/utsname.h>
@@ -74,6 +75,10 @@ struct PosixFd : public Sys::Fd {
 
         return Ok(makeStrong<PosixFd>(duped));
     }
+
+    Opt<usize> handle() const override {
+        return static_cast<usize>(_raw);
+    }
 };
 
 Res<Url::Path> resolve(Url::Url url) {
@@ -298,6 +303,157 @@ Res<> populate(Vec<Sys::UserInfo> &infos) {
     return Ok();
 }
 
+/* --- Threading ------------------------------------------------------------ */
+
+struct PosixThread : public Sys::Thread {
+    pthread_t _thread;
+    bool _joinable = true;
+
+    PosixThread(pthread_t thread) : _thread(thread) {}
+
+    ~PosixThread() {
+        if (_joinable)
+            pthread_detach(_thread);
+    }
+
+    Res<> join() override {
+        if (not _joinable)
+            return Error::invalidInput("thread is not joinable");
+
+        isize err = pthread_join(_thread, nullptr);
+        if (err)
+            return Posix::fromErrno(err);
+
+        _joinable = false;
+        return Ok();
+    }
+
+    Res<> detach() override {
+        if (not _joinable)
+            return Error::invalidInput("thread is not joinable");
+
+        isize err = pthread_detach(_thread);
+        if (err)
+            return Posix::fromErrno(err);
+
+        _joinable = false;
+        return Ok();
+    }
+};
+
+static void *_threadEntry(void *arg) {
+    auto *entry = static_cast<Func<void()> *>(arg);
+    (*entry)();
+    delete entry;
+    return nullptr;
+}
+
+Res<Strong<Sys::Thread>> spawnThread(Func<void()> entry) {
+    auto *arg = new Func<void()>(std::move(entry));
+
+    pthread_t thread;
+    isize err = pthread_create(&thread, nullptr, _threadEntry, arg);
+    if (err) {
+        delete arg;
+        return Posix::fromErrno(err);
+    }
+
+    return Ok(makeStrong<PosixThread>(thread));
+}
+
+usize cpuCount() {
+    long count = sysconf(_SC_NPROCESSORS_ONLN);
+    return count > 0 ? count : 1;
+}
+
+struct PosixMutex : public Sys::Mutex {
+    pthread_mutex_t _mutex = PTHREAD_MUTEX_INITIALIZER;
+
+    ~PosixMutex() {
+        pthread_mutex_destroy(&_mutex);
+    }
+
+    void lock() override {
+        pthread_mutex_lock(&_mutex);
+    }
+
+    bool tryLock() override {
+        return pthread_mutex_trylock(&_mutex) == 0;
+    }
+
+    void unlock() override {
+        pthread_mutex_unlock(&_mutex);
+    }
+};
+
+Res<Strong<Sys::Mutex>> createMutex() {
+    return Ok(makeStrong<PosixMutex>());
+}
+
+struct PosixCondVar : public Sys::CondVar {
+    pthread_cond_t _cond = PTHREAD_COND_INITIALIZER;
+
+    ~PosixCondVar() {
+        pthread_cond_destroy(&_cond);
+    }
+
+    void wait(Sys::Mutex &mutex) override {
+        pthread_cond_wait(&_cond, &static_cast<PosixMutex &>(mutex)._mutex);
+    }
+
+    void signal() override {
+        pthread_cond_signal(&_cond);
+    }
+
+    void broadcast() override {
+        pthread_cond_broadcast(&_cond);
+    }
+};
+
+Res<Strong<Sys::CondVar>> createCondVar() {
+    return Ok(makeStrong<PosixCondVar>());
+}
+
+// NOTE: Unnamed posix semaphores are not available on darwin,
+//       so we build our own on top of a mutex and a condvar.
+struct PosixSema : public Sys::Sema {
+    PosixMutex _mutex;
+    PosixCondVar _cond;
+    usize _count;
+
+    PosixSema(usize count) : _count(count) {}
+
+    void wait() override {
+        Sys::MutexScope scope(_mutex);
+        while (_count == 0)
+            _cond.wait(_mutex);
+        _count--;
+    }
+
+    bool tryWait() override {
+        Sys::MutexScope scope(_mutex);
+        if (_count == 0)
+            return false;
+        _count--;
+        return true;
+    }
+
+    void signal(usize n) override {
+        Sys::MutexScope scope(_mutex);
+        _count += n;
+        _cond.broadcast();
+    }
+
+    usize count() override {
+        Sys::MutexScope scope(_mutex);
+        return _count;
+    }
+};
+
+Res<Strong<Sys::Sema>> createSema(usize count) {
+    return Ok(makeStrong<PosixSema>(count));
+}
+
 /* --- Process Managment ---------------------------------------------------- */
 
 Res<> sleep(TimeSpan span) {
@@ -81,7 +81,8 @@ TimeStamp now() {
 }
 
 TimeSpan uptime() {
-    notImplemented();
+    // The kernel clock starts at boot and never goes back.
+    return Hj::now().unwrap() - TimeStamp::epoch();
 }
 
 /* --- Memory Managment ----------------------------------------------------- */
@@ -135,6 +136,28 @@ Res<> populate(Vec<Sys::UserInfo> &) {
     notImplemented();
 }
 
+/* --- Threading ------------------------------------------------------------ */
+
+Res<Strong<Sys::Thread>> spawnThread(Func<void()>) {
+    notImplemented();
+}
+
+usize cpuCount() {
+    return 1;
+}
+
+Res<Strong<Sys::Mutex>> createMutex() {
+    notImplemented();
+}
+
+Res<Strong<Sys::Sema>> createSema(usize) {
+    notImplemented();
+}
+
+Res<Strong<Sys::CondVar>> createCondVar() {
+    notImplemented();
+}
+
 /* --- Process Managment ---------------------------------------------------- */
 
 Res<> sleep(TimeSpan) {
@@ -94,6 +94,10 @@ union Cpuid {
         return cpuid(0x7, 0).ebx & (1 << 16);
     }
 
+    static bool hasHuge1g() {
+        return cpuid(0x80000001, 0).edx & (1 << 26);
+    }
+
     static bool xsaveSize() {
         return cpuid(0x0d, 0).ecx;
     }
@@ -65,6 +65,9 @@ struct [[gnu::packed]] Entry {
     void flags(u64 flags) { _raw = (flags & FLAGS_MASK) | paddr(); }
 
     bool present() const { return _raw & PRESENT; }
+
+    // Maps a 2MiB or 1GiB page directly instead of pointing to a lower table.
+    bool huge() const { return _raw & HUGE_PAGE; }
 };
 
 static_assert(sizeof(Entry) == 8);
@@ -74,6 +77,9 @@ struct [[gnu::packed]] Pml {
     constexpr static usize LEVEL = L;
     constexpr static usize LEN = 512;
 
+    // Size of the memory covered by one entry.
+    constexpr static usize SIZE = 1uz << (12 + (L - 1) * 9);
+
     using Lower = Pml<L - 1>;
 
     Entry pages[LEN];
@@ -97,12 +103,15 @@ struct [[gnu::packed]] Pml {
             return NONE;
         }
 
-        if (LEVEL == 1) {
-            return page.paddr() + (virt & 0x1ff);
-        }
+        if constexpr (LEVEL == 1) {
+            return page.paddr() + (virt & (SIZE - 1));
+        } else {
+            if (page.huge())
+                return page.paddr() + (virt & (SIZE - 1));
 
-        auto *pml = (Lower *)page.paddr();
-        return pml->virt2phys(virt);
+            auto *pml = (Lower *)page.paddr();
+            return pml->virt2phys(virt);
+        }
     }
 
     Entry pageAt(usize vaddr) {
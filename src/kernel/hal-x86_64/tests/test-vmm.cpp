@@ -0,0 +1,183 @@
+#include <hal-x86_64/vmm.h>
+#include <karm-base/buf.h>
+#include <karm-base/vec.h>
+#include <karm-test/macros.h>
+
+namespace x86_64::Tests {
+
+// Page tables live in host memory, leaf addresses are never touched
+// so they can point anywhere.
+struct ArenaPmm : public Hal::Pmm {
+    Buf<u8> _arena;
+    Vec<usize> _free;
+    usize _used = 0;
+
+    ArenaPmm(usize pages)
+        : _arena(Buf<u8>::init((pages + 1) * Hal::PAGE_SIZE)) {
+        auto base = alignUp((usize)_arena.buf(), Hal::PAGE_SIZE);
+        for (usize i = 0; i < pages; i++)
+            _free.pushBack(base + i * Hal::PAGE_SIZE);
+    }
+
+    Res<Hal::PmmRange> allocRange(usize size, Hal::PmmFlags) override {
+        if (size != Hal::PAGE_SIZE or _free.len() == 0)
+            return Error::outOfMemory();
+        _used++;
+        return Ok(Hal::PmmRange{_free.popBack(), Hal::PAGE_SIZE});
+    }
+
+    Res<> used(Hal::PmmRange, Hal::PmmFlags) override {
+        return Error::notImplemented();
+    }
+
+    Res<> free(Hal::PmmRange range) override {
+        _used--;
+        _free.pushBack(range.start);
+        return Ok();
+    }
+};
+
+// Counts every time the vmm steps into a table.
+struct CountingMapper {
+    usize *_walks;
+
+    template <typename T>
+    T map(T addr) {
+        (*_walks)++;
+        return addr;
+    }
+
+    template <typename T>
+    T unmap(T addr) { return addr; }
+};
+
+struct Sim {
+    ArenaPmm pmm;
+    usize walks = 0;
+    Pml<4> *pml4;
+    Vmm<CountingMapper> vmm;
+
+    Sim(usize pages, usize hugeLevel)
+        : pmm(pages),
+          pml4((Pml<4> *)pmm.allocRange(Hal::PAGE_SIZE, Hal::PmmFlags::NONE).unwrap().start),
+          vmm(pmm, pml4, {&walks}) {
+        memset(pml4, 0, Hal::PAGE_SIZE);
+        vmm._hugeLevel = hugeLevel;
+    }
+
+    Opt<usize> translate(usize vaddr) {
+        return pml4->virt2phys(vaddr);
+    }
+};
+
+static constexpr usize GIB = 1uz << 30;
+static constexpr usize MIB = 1uz << 20;
+
+test$(vmmHugePages) {
+    Sim sim{16, 3};
+
+    // 2GiB + 2MiB + 4KiB, aligned so every page size gets used.
+    usize size = 2 * GIB + 2 * MIB + Hal::PAGE_SIZE;
+    try$(sim.vmm.mapRange({GIB, size}, {4 * GIB, size}, Hal::VmmFlags::WRITE));
+
+    // One pml3, one pml2 and one pml1.
+    expectEq$(sim.pmm._used, 4uz);
+
+    auto &pml3 = *(*sim.pml4)[0].as<Pml<3>>();
+    expect$(pml3[1].huge());
+    expect$(pml3[2].huge());
+    expect$(not pml3[3].huge());
+
+    auto &pml2 = *pml3[3].as<Pml<2>>();
+    expect$(pml2[0].huge());
+    expect$(not pml2[1].huge());
+
+    expectEq$(sim.translate(GIB + 0x1234).unwrap(), 4 * GIB + 0x1234);
+    expectEq$(sim.translate(3 * GIB + MIB).unwrap(), 6 * GIB + MIB);
+    expectEq$(sim.translate(3 * GIB + 2 * MIB).unwrap(), 6 * GIB + 2 * MIB);
+    expect$(not sim.translate(3 * GIB + 2 * MIB + Hal::PAGE_SIZE));
+
+    try$(sim.vmm.free({GIB, size}));
+    expectEq$(sim.pmm._used, 1uz);
+
+    return Ok();
+}
+
+test$(vmmMisaligned) {
+    Sim sim{16, 3};
+
+    // The physical range isn't 2MiB aligned, so only 4KiB pages fit.
+    try$(sim.vmm.mapRange({2 * MIB, 2 * MIB}, {Hal::PAGE_SIZE, 2 * MIB}, Hal::VmmFlags::WRITE));
+    expectEq$(sim.pmm._used, 4uz);
+    expectEq$(sim.translate(4 * MIB - 1).unwrap(), 2 * MIB + Hal::PAGE_SIZE - 1);
+
+    return Ok();
+}
+
+// Maps the kernel the way Mem::init does, with 4KiB pages only.
+test$(vmmWalks) {
+    Sim sim{2048, 1};
+
+    usize size = 2 * GIB - 2 * Hal::PAGE_SIZE;
+    try$(sim.vmm.mapRange({0xffffffff80000000 + Hal::PAGE_SIZE, size}, {Hal::PAGE_SIZE, size}, Hal::VmmFlags::WRITE));
+
+    usize tables = sim.pmm._used - 1;
+    usize pages = size / Hal::PAGE_SIZE;
+    logInfo("{} pages, {} tables, {} walks", pages, tables, sim.walks);
+
+    // Every table is stepped into once, plus once to clear it.
+    expectEq$(sim.walks, tables * 2);
+    expect$(sim.walks < pages / 128);
+
+    sim.walks = 0;
+    try$(sim.vmm.free({0xffffffff80000000 + Hal::PAGE_SIZE, size}));
+    expectEq$(sim.walks, tables);
+    expectEq$(sim.pmm._used, 1uz);
+
+    return Ok();
+}
+
+test$(vmmSplit) {
+    Sim sim{16, 2};
+
+    try$(sim.vmm.mapRange({2 * MIB, 4 * MIB}, {8 * MIB, 4 * MIB}, Hal::VmmFlags::WRITE));
+    expectEq$(sim.pmm._used, 3uz);
+
+    // Unmapping a page in the middle of a huge page splits it.
+    try$(sim.vmm.free({4 * MIB + Hal::PAGE_SIZE, Hal::PAGE_SIZE}));
+    expectEq$(sim.pmm._used, 4uz);
+
+    expect$(not sim.translate(4 * MIB + Hal::PAGE_SIZE));
+    expectEq$(sim.translate(4 * MIB).unwrap(), 10 * MIB);
+    expectEq$(sim.translate(4 * MIB + 2 * Hal::PAGE_SIZE).unwrap(), 10 * MIB + 2 * Hal::PAGE_SIZE);
+    expectEq$(sim.translate(2 * MIB + 0x10).unwrap(), 8 * MIB + 0x10);
+
+    try$(sim.vmm.free({2 * MIB, 4 * MIB}));
+    expectEq$(sim.pmm._used, 1uz);
+
+    return Ok();
+}
+
+test$(vmmUpdate) {
+    Sim sim{16, 2};
+
+    try$(sim.vmm.mapRange({0, 4 * MIB}, {0, 4 * MIB}, Hal::VmmFlags::WRITE));
+    try$(sim.vmm.update({2 * MIB, Hal::PAGE_SIZE}, Hal::VmmFlags::USER));
+
+    auto &pml2 = *(*(*sim.pml4)[0].as<Pml<3>>())[0].as<Pml<2>>();
+    expect$(pml2[0].huge());
+    expect$(not(pml2[0].flags() & Entry::USER));
+
+    // The second huge page got split to change a single page.
+    auto &pml1 = *pml2[1].as<Pml<1>>();
+    expect$(pml1[0].flags() & Entry::USER);
+    expect$(not(pml1[0].flags() & Entry::WRITE));
+    expect$(pml1[1].flags() & Entry::WRITE);
+    expectEq$(sim.translate(2 * MIB + Hal::PAGE_SIZE).unwrap(), 2 * MIB + Hal::PAGE_SIZE);
+
+    expect$(not sim.vmm.update({8 * MIB, Hal::PAGE_SIZE}, Hal::VmmFlags::USER));
+
+    return Ok();
+}
+
+} // namespace x86_64::Tests
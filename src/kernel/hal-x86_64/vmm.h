@@ -12,10 +12,17 @@ namespace x86_64 {
 
 template <typename Mapper = Hal::IdentityMapper>
 struct Vmm : public Hal::Vmm {
+    // Past this many pages, reloading cr3 is cheaper than an invlpg per page.
+    static constexpr usize FLUSH_THRESHOLD = 32;
+
     Hal::Pmm &_pmm;
     Pml<4> *_pml4 = nullptr;
     Mapper _mapper;
 
+    // Highest level at which a range can be mapped directly,
+    // 2 for 2MiB pages, 3 for 1GiB pages, 1 to only use 4KiB pages.
+    usize _hugeLevel = 2;
+
     Vmm(Hal::Pmm &pmm, Pml<4> *pml4, Mapper mapper = {})
         : _pmm(pmm),
           _pml4(pml4),
@@ -36,6 +43,10 @@ struct Vmm : public Hal::Vmm {
     Res<Pml<L - 1> *> pmlOrAlloc(Pml<L> &upper, usize vaddr) {
         auto page = upper.pageAt(vaddr);
 
+        if (page.present() and page.huge()) {
+            return _split(upper, vaddr);
+        }
+
         if (page.present()) {
             return Ok(_mapper.map(page.template as<Pml<L - 1>>()));
         }
@@ -46,64 +57,146 @@ struct Vmm : public Hal::Vmm {
         return Ok(_mapper.map((Pml<L - 1> *)lower));
     }
 
-    Res<> allocPage(usize vaddr, usize paddr, Hal::VmmFlags flags) {
-        auto pml3 = try$(pmlOrAlloc(*_pml4, vaddr));
-        auto pml2 = try$(pmlOrAlloc(*pml3, vaddr));
-        auto pml1 = try$(pmlOrAlloc(*pml2, vaddr));
+    // Replaces a huge page by a lower table mapping the same memory.
+    template <usize L>
+    Res<Pml<L - 1> *> _split(Pml<L> &upper, usize vaddr) {
+        auto page = upper.pageAt(vaddr);
+        auto flags = page.flags();
+        if constexpr (L - 1 == 1)
+            flags &= ~Entry::HUGE_PAGE;
 
-        pml1->putPage(vaddr, {paddr, Entry::makeFlags(flags) | Entry::PRESENT});
+        usize lower = try$(_pmm.allocRange(Hal::PAGE_SIZE, Hal::PmmFlags::NONE)).start;
+        auto *pml = _mapper.map((Pml<L - 1> *)lower);
+        for (usize i = 0; i < Pml<L - 1>::LEN; i++)
+            (*pml)[i] = {page.paddr() + i * Pml<L - 1>::SIZE, flags};
 
-        return Ok();
+        upper.putPage(vaddr, {lower, Entry::WRITE | Entry::PRESENT | Entry::USER});
+        return Ok(pml);
+    }
+
+    // End of the entry containing vaddr, clamped to end.
+    template <usize L>
+    static usize _next(usize vaddr, usize end) {
+        usize next = alignDown(vaddr, Pml<L>::SIZE) + Pml<L>::SIZE;
+        if (next > end or next == 0)
+            return end;
+        return next;
     }
 
-    Res<> freePage(usize vaddr) {
-        auto pml3 = try$(pml(*_pml4, vaddr));
-        auto pml2 = try$(pml(*pml3, vaddr));
-        auto pml1 = try$(pml(*pml2, vaddr));
-        pml1->putPage(vaddr, {});
+    /* --- Walking --- */
+
+    // Each of these visits every table touched by the range
+    // once, instead of walking from the root for every page.
 
-        if (pml1->empty()) {
-            pml2->putPage(vaddr, {});
-            try$(_pmm.free({_mapper.unmap((usize)pml1), Hal::PAGE_SIZE}));
+    template <usize L>
+    Res<> _mapRange(Pml<L> &pml, usize vaddr, usize end, usize paddr, u64 flags) {
+        while (vaddr < end) {
+            usize next = _next<L>(vaddr, end);
+
+            if constexpr (L == 1) {
+                pml.putPage(vaddr, {paddr, flags | Entry::PRESENT});
+            } else {
+                bool fits = next - vaddr == Pml<L>::SIZE and
+                            isAlign(paddr, Pml<L>::SIZE) and
+                            L <= _hugeLevel and
+                            not pml.pageAt(vaddr).present();
+
+                if (fits) {
+                    pml.putPage(vaddr, {paddr, flags | Entry::PRESENT | Entry::HUGE_PAGE});
+                } else {
+                    auto lower = try$(pmlOrAlloc(pml, vaddr));
+                    try$(_mapRange(*lower, vaddr, next, paddr, flags));
+                }
+            }
+
+            paddr += next - vaddr;
+            vaddr = next;
         }
 
-        if (pml2->empty()) {
-            pml3->putPage(vaddr, {});
-            try$(_pmm.free({_mapper.unmap((usize)pml2), Hal::PAGE_SIZE}));
+        return Ok();
+    }
+
+    template <usize L>
+    Res<> _freeRange(Pml<L> &pml, usize vaddr, usize end) {
+        while (vaddr < end) {
+            usize next = _next<L>(vaddr, end);
+            auto page = pml.pageAt(vaddr);
+
+            if constexpr (L == 1) {
+                pml.putPage(vaddr, {});
+            } else if (not page.present()) {
+                // Nothing mapped here.
+            } else if (page.huge() and next - vaddr == Pml<L>::SIZE) {
+                pml.putPage(vaddr, {});
+            } else {
+                auto lower = try$(pmlOrAlloc(pml, vaddr));
+                try$(_freeRange(*lower, vaddr, next));
+
+                if (lower->empty()) {
+                    pml.putPage(vaddr, {});
+                    try$(_pmm.free({_mapper.unmap((usize)lower), Hal::PAGE_SIZE}));
+                }
+            }
+
+            vaddr = next;
         }
 
-        if (pml3->empty()) {
-            _pml4->putPage(vaddr, {});
-            try$(_pmm.free({_mapper.unmap((usize)pml3), Hal::PAGE_SIZE}));
+        return Ok();
+    }
+
+    template <usize L>
+    Res<> _updateRange(Pml<L> &pml, usize vaddr, usize end, u64 flags) {
+        while (vaddr < end) {
+            usize next = _next<L>(vaddr, end);
+            auto page = pml.pageAt(vaddr);
+
+            if (not page.present()) {
+                return Error::invalidInput("page not present");
+            }
+
+            if constexpr (L == 1) {
+                page.flags(flags | Entry::PRESENT);
+                pml.putPage(vaddr, page);
+            } else if (page.huge() and next - vaddr == Pml<L>::SIZE) {
+                page.flags(flags | Entry::PRESENT | Entry::HUGE_PAGE);
+                pml.putPage(vaddr, page);
+            } else {
+                auto lower = try$(pmlOrAlloc(pml, vaddr));
+                try$(_updateRange(*lower, vaddr, next, flags));
+            }
+
+            vaddr = next;
         }
 
         return Ok();
     }
 
+    /* --- Hal::Vmm --- */
+
     Res<Hal::VmmRange> mapRange(Hal::VmmRange vaddr, Hal::PmmRange paddr, Hal::VmmFlags flags) override {
         if (paddr.size != vaddr.size) {
             return Error::invalidInput();
         }
 
-        for (usize page = 0; page < vaddr.size; page += Hal::PAGE_SIZE) {
-            try$(allocPage(vaddr.start + page, paddr.start + page, flags));
-        }
-
+        try$(_mapRange(*_pml4, vaddr.start, vaddr.end(), paddr.start, Entry::makeFlags(flags)));
         return Ok(vaddr);
     }
 
     Res<> free(Hal::VmmRange vaddr) override {
-        for (usize page = 0; page < vaddr.size; page += Hal::PAGE_SIZE) {
-            try$(freePage(vaddr.start + page));
-        }
-        return Ok();
+        return _freeRange(*_pml4, vaddr.start, vaddr.end());
     }
 
-    Res<> update(Hal::VmmRange, Hal::VmmFlags) override {
-        notImplemented();
+    Res<> update(Hal::VmmRange vaddr, Hal::VmmFlags flags) override {
+        return _updateRange(*_pml4, vaddr.start, vaddr.end(), Entry::makeFlags(flags));
     }
 
     Res<> flush(Hal::VmmRange vaddr) override {
+        // NOTE: This doesn't flush global pages, but we don't map any.
+        if (vaddr.size / Hal::PAGE_SIZE > FLUSH_THRESHOLD) {
+            x86_64::wrcr3(x86_64::rdcr3());
+            return Ok();
+        }
+
         for (usize i = 0; i < vaddr.size; i += Hal::PAGE_SIZE) {
             x86_64::invlpg(vaddr.start + i);
         }
@@ -121,28 +214,28 @@ struct Vmm : public Hal::Vmm {
         usize pstart = 0;
         usize pend = 0;
 
-        void next(usize vaddr, usize paddr) {
+        void next(usize vaddr, usize paddr, usize size = Hal::PAGE_SIZE) {
             if (vstart == (usize)-1) {
                 vstart = vaddr;
-                vend = vaddr;
+                vend = vaddr + size;
 
                 pstart = paddr;
-                pend = paddr;
+                pend = paddr + size;
                 return;
             }
 
-            if ((vend + Hal::PAGE_SIZE != vaddr) or
-                (pend + Hal::PAGE_SIZE != paddr)) {
+            if ((vend != vaddr) or
+                (pend != paddr)) {
 
-                logInfo("x86_64: vmm: {x}-{x} {x}-{x}", vstart, vend + Hal::PAGE_SIZE, pstart, pend + Hal::PAGE_SIZE);
+                logInfo("x86_64: vmm: {x}-{x} {x}-{x}", vstart, vend, pstart, pend);
                 vstart = vaddr;
-                vend = vaddr;
+                vend = vaddr + size;
 
                 pstart = paddr;
-                pend = paddr;
+                pend = paddr + size;
             } else {
-                vend += Hal::PAGE_SIZE;
-                pend += Hal::PAGE_SIZE;
+                vend += size;
+                pend += size;
             }
         }
     };
@@ -157,6 +250,8 @@ struct Vmm : public Hal::Vmm {
                 if (page.present()) {
                     ctx.next(curr, page.paddr());
                 }
+            } else if (page.present() and page.huge()) {
+                ctx.next(curr, page.paddr(), Pml<L>::SIZE);
             } else if (page.present()) {
                 auto &lower = *_mapper.map(page.template as<Pml<L - 1>>());
                 _dumpPml(ctx, lower, curr);
@@ -2,6 +2,7 @@
 
 #include <karm-base/string.h>
 
+#include "pipe.h"
 #include "syscalls.h"
 
 namespace Hj {
@@ -240,6 +241,20 @@ struct Channel : public Object {
     Res<> recv(Msg &msg, Domain &to) {
         return _recv(_cap, &msg, to);
     }
+
+    // Returns how many of the messages were sent.
+    Res<usize> sendBatch(Slice<Msg> msgs, Domain &from) {
+        usize sent = 0;
+        try$(_sendBatch(_cap, msgs.buf(), msgs.len(), &sent, from));
+        return Ok(sent);
+    }
+
+    // Returns how many messages were received, zero if the channel is empty.
+    Res<usize> recvBatch(MutSlice<Msg> msgs, Domain &to) {
+        usize received = 0;
+        try$(_recvBatch(_cap, msgs.buf(), msgs.len(), &received, to));
+        return Ok(received);
+    }
 };
 
 struct Irq : public Object {
@@ -284,4 +299,125 @@ struct Listener : public Object {
     }
 };
 
+// One end of a pipe, a ring buffer in a vmo shared by two tasks. Data
+// doesn't go through the kernel, syscalls are only made to put an end
+// to sleep when the pipe is empty or full, and to wake it back up.
+struct Pipe {
+    // Label of the message used to hand a pipe over a channel.
+    static constexpr Arg LABEL = PipeHeader::MAGIC;
+
+    Vmo _vmo;
+    Mapped _mapped;
+    Listener _listener;
+    PipeRing _ring;
+    Sigs _listening = Sigs::NONE;
+
+    static Res<Pipe> _make(Vmo vmo, Mapped mapped, PipeRing ring) {
+        auto listener = try$(Listener::create(ROOT));
+        return Ok(Pipe{std::move(vmo), std::move(mapped), std::move(listener), ring});
+    }
+
+    static Res<Pipe> create(usize len) {
+        auto vmo = try$(Vmo::create(ROOT, 0, len, VmoFlags::UPPER));
+        try$(vmo.label("pipe"));
+        auto mapped = try$(map(vmo, MapFlags::READ | MapFlags::WRITE));
+        auto ring = try$(PipeRing::init(mapped.mutBytes()));
+        return _make(std::move(vmo), std::move(mapped), ring);
+    }
+
+    static Res<Pipe> open(Vmo vmo) {
+        auto mapped = try$(map(vmo, MapFlags::READ | MapFlags::WRITE));
+        auto ring = try$(PipeRing::attach(mapped.mutBytes()));
+        return _make(std::move(vmo), std::move(mapped), ring);
+    }
+
+    // Hands the other end of the pipe to whoever is on the other side of the channel.
+    Res<> share(Channel &chan, Domain &from) {
+        Msg msg{LABEL};
+        msg.storeCap(0, _vmo);
+        return chan.send(msg, from);
+    }
+
+    // Opens a pipe shared by the other side of the channel.
+    static Res<Pipe> accept(Channel &chan, Domain &to) {
+        Msg msg;
+        try$(chan.recv(msg, to));
+        if (msg.label != LABEL)
+            return Error::invalidData("expected a pipe");
+        return open(Vmo{try$(msg.loadCap(0))});
+    }
+
+    bool closed() {
+        return _ring.closed();
+    }
+
+    Res<> close() {
+        _ring.close();
+        return _vmo.signal(Sigs::READABLE | Sigs::WRITABLE, Sigs::NONE);
+    }
+
+    // Sleeps until the other end raises the signal.
+    Res<> _wait(Sigs sig) {
+        if (_listening != sig) {
+            try$(_listener.listen(_vmo, sig, Sigs::NONE));
+            _listening = sig;
+        }
+
+        try$(_listener.poll(TimeStamp::endOfTime()));
+        return _vmo.signal(Sigs::NONE, sig);
+    }
+
+    // Writes as much as fits without blocking.
+    Res<usize> write(Bytes bytes) {
+        usize n = try$(_ring.write(bytes));
+        if (n and _ring.unparkReader())
+            try$(_vmo.signal(Sigs::READABLE, Sigs::NONE));
+        return Ok(n);
+    }
+
+    // Reads what's available without blocking.
+    Res<usize> read(MutBytes bytes) {
+        usize n = try$(_ring.read(bytes));
+        if (n and _ring.unparkWriter())
+            try$(_vmo.signal(Sigs::WRITABLE, Sigs::NONE));
+        return Ok(n);
+    }
+
+    // Blocks until all the bytes are written.
+    Res<> writeAll(Bytes bytes) {
+        while (bytes.len()) {
+            if (closed())
+                return Error::brokenPipe("pipe closed");
+
+            usize n = try$(write(bytes));
+            bytes = next(bytes, n);
+            if (n)
+                continue;
+
+            _ring.parkWriter();
+            if (not _ring.space())
+                try$(_wait(Sigs::WRITABLE));
+        }
+
+        return Ok();
+    }
+
+    // Blocks until some bytes are read, returns
+    // zero once the pipe is closed and empty.
+    Res<usize> readSome(MutBytes bytes) {
+        while (true) {
+            usize n = try$(read(bytes));
+            if (n or bytes.len() == 0)
+                return Ok(n);
+
+            if (closed())
+                return _ring.read(bytes);
+
+            _ring.parkReader();
+            if (not _ring.available() and not closed())
+                try$(_wait(Sigs::READABLE));
+        }
+    }
+};
+
 } // namespace Hj
@@ -0,0 +1,168 @@
+#pragma once
+
+#include <karm-base/atomic.h>
+#include <karm-base/clamp.h>
+#include <karm-base/res.h>
+#include <karm-base/slice.h>
+
+namespace Hj {
+
+// Sits at the start of the memory shared by the two ends of a pipe,
+// followed by the data. head and tail only ever grow, the difference
+// between them is how many bytes are in the pipe. Each one lives on
+// its own cache line so that the two ends don't fight over them.
+struct PipeHeader {
+    static constexpr u32 MAGIC = 0x65706970; // "pipe"
+
+    u32 magic;
+    u32 _pad;
+    usize cap;
+
+    alignas(64) Atomic<usize> head{};
+    alignas(64) Atomic<usize> tail{};
+
+    // Set by an end that is about to sleep, so that
+    // the other end knows it has to signal it.
+    alignas(64) Atomic<bool> readerWaiting{};
+    Atomic<bool> writerWaiting{};
+    Atomic<bool> closed{};
+};
+
+// A single producer, single consumer byte ring in shared memory.
+// Moving data doesn't involve the kernel at all, it's only needed to
+// wake up an end that went to sleep on an empty or full pipe.
+//
+// The other end can write anything to the header at any time, so the
+// capacity is checked once and kept here, and head and tail are checked
+// before they are used to index the data.
+struct PipeRing {
+    PipeHeader *_hdr = nullptr;
+    u8 *_data = nullptr;
+    usize _cap = 0;
+
+    // Formats the memory as an empty pipe, the data
+    // part is rounded down to a power of two.
+    static Res<PipeRing> init(MutBytes mem) {
+        if (mem.len() <= sizeof(PipeHeader))
+            return Error::invalidInput("pipe too small");
+
+        usize cap = 1;
+        while (cap * 2 <= mem.len() - sizeof(PipeHeader))
+            cap *= 2;
+
+        auto *hdr = new (mem.buf()) PipeHeader{};
+        hdr->magic = PipeHeader::MAGIC;
+        hdr->cap = cap;
+
+        return Ok(PipeRing{hdr, mem.buf() + sizeof(PipeHeader), cap});
+    }
+
+    // Uses memory formatted by the other end.
+    static Res<PipeRing> attach(MutBytes mem) {
+        if (mem.len() < sizeof(PipeHeader))
+            return Error::invalidInput("pipe too small");
+
+        auto *hdr = reinterpret_cast<PipeHeader *>(mem.buf());
+        if (hdr->magic != PipeHeader::MAGIC)
+            return Error::invalidData("not a pipe");
+
+        usize cap = hdr->cap;
+        if (cap == 0 or
+            (cap & (cap - 1)) or
+            cap > mem.len() - sizeof(PipeHeader))
+            return Error::invalidData("pipe capacity out of bounds");
+
+        return Ok(PipeRing{hdr, mem.buf() + sizeof(PipeHeader), cap});
+    }
+
+    usize cap() const {
+        return _cap;
+    }
+
+    // Bytes between tail and head, clamped to what the pipe can hold.
+    usize _used(usize head, usize tail) const {
+        return clamp((isize)(head - tail), (isize)0, (isize)_cap);
+    }
+
+    Res<usize> _checkedUsed(usize head, usize tail) const {
+        if (head - tail > _cap)
+            return Error::invalidData("pipe indices out of bounds");
+        return Ok(head - tail);
+    }
+
+    // Bytes waiting to be read.
+    usize available() {
+        return _used(_hdr->head.load(), _hdr->tail.load(RELAXED));
+    }
+
+    // Bytes that can be written without overwriting unread ones.
+    usize space() {
+        return _cap - _used(_hdr->head.load(RELAXED), _hdr->tail.load());
+    }
+
+    bool closed() {
+        return _hdr->closed.load(ACQUIRE);
+    }
+
+    void close() {
+        _hdr->closed.store(true, RELEASE);
+    }
+
+    /* --- Transfers --- */
+
+    // Writes as much as fits, returns how much that was.
+    Res<usize> write(Bytes bytes) {
+        usize head = _hdr->head.load(RELAXED);
+        usize used = try$(_checkedUsed(head, _hdr->tail.load()));
+        usize n = min(bytes.len(), _cap - used);
+        usize off = head & (_cap - 1);
+        usize first = min(n, _cap - off);
+
+        memcpy(_data + off, bytes.buf(), first);
+        memcpy(_data, bytes.buf() + first, n - first);
+
+        // NOTE: Sequentially consistent, so that the reader either
+        //       sees the data or we see that it's waiting for it.
+        _hdr->head.store(head + n);
+        return Ok(n);
+    }
+
+    // Reads as much as is available, returns how much that was.
+    Res<usize> read(MutBytes bytes) {
+        usize tail = _hdr->tail.load(RELAXED);
+        usize n = min(bytes.len(), try$(_checkedUsed(_hdr->head.load(), tail)));
+        usize off = tail & (_cap - 1);
+        usize first = min(n, _cap - off);
+
+        memcpy(bytes.buf(), _data + off, first);
+        memcpy(bytes.buf() + first, _data, n - first);
+
+        _hdr->tail.store(tail + n);
+        return Ok(n);
+    }
+
+    /* --- Wakeups --- */
+
+    // Called by the reader before going to sleep, it must check
+    // that the pipe is still empty afterward.
+    void parkReader() {
+        _hdr->readerWaiting.store(true);
+    }
+
+    void parkWriter() {
+        _hdr->writerWaiting.store(true);
+    }
+
+    // Returns true if the reader was sleeping and needs to be signaled.
+    bool unparkReader() {
+        return _hdr->readerWaiting.load() and
+               _hdr->readerWaiting.xchg(false);
+    }
+
+    bool unparkWriter() {
+        return _hdr->writerWaiting.load() and
+               _hdr->writerWaiting.xchg(false);
+    }
+};
+
+} // namespace Hj
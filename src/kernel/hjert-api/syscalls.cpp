@@ -80,6 +80,14 @@ Res<> _recv(Cap cap, Msg *msg, Cap to) {
     return _syscall(Syscall::RECV, cap.raw(), (Arg)msg, to.raw());
 }
 
+Res<> _sendBatch(Cap cap, Msg const *msgs, usize len, usize *sent, Cap from) {
+    return _syscall(Syscall::SEND_BATCH, cap.raw(), (Arg)msgs, len, (Arg)sent, from.raw());
+}
+
+Res<> _recvBatch(Cap cap, Msg *msgs, usize len, usize *received, Cap to) {
+    return _syscall(Syscall::RECV_BATCH, cap.raw(), (Arg)msgs, len, (Arg)received, to.raw());
+}
+
 Res<> _close(Cap cap) {
     return _syscall(Syscall::CLOSE, cap.raw());
 }
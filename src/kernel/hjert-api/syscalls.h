@@ -32,6 +32,13 @@ Res<> _send(Cap cap, Msg const *msg, Cap from);
 
 Res<> _recv(Cap cap, Msg *msg, Cap to);
 
+// Sends as many of the messages as the channel can take,
+// and stores how many that was in `sent`.
+Res<> _sendBatch(Cap cap, Msg const *msgs, usize len, usize *sent, Cap from);
+
+// Receives up to `len` messages, without blocking.
+Res<> _recvBatch(Cap cap, Msg *msgs, usize len, usize *received, Cap to);
+
 Res<> _close(Cap cap);
 
 Res<> _signal(Cap cap, Flags<Sigs> set, Flags<Sigs> unset);
@@ -0,0 +1,45 @@
+#include <hjert-api/pipe.h>
+#include <karm-base/buf.h>
+#include <karm-sys/thread.h>
+#include <karm-test/macros.h>
+
+namespace Hj::Tests {
+
+// Streams data between two threads through a 1MiB pipe, with both
+// ends spinning instead of sleeping.
+bench$(pipeThroughput) {
+    static constexpr usize TOTAL = 16 << 20;
+    static constexpr usize CHUNK = 64 << 10;
+
+    auto mem = Buf<u8>::init(sizeof(PipeHeader) + (1 << 20), 0);
+
+    b.bytes(TOTAL);
+    b.run([&] {
+        auto writer = PipeRing::init(mutSub(mem)).unwrap();
+        auto reader = PipeRing::attach(mutSub(mem)).unwrap();
+
+        auto producer = Sys::Thread::spawn([&] {
+                            auto chunk = Buf<u8>::init(CHUNK, 0x2a);
+                            usize sent = 0;
+                            while (sent < TOTAL) {
+                                usize off = 0;
+                                while (off < CHUNK)
+                                    off += writer.write(next(chunk, off)).unwrap();
+                                sent += CHUNK;
+                            }
+                            writer.close();
+                        }).unwrap();
+
+        auto chunk = Buf<u8>::init(CHUNK, 0);
+        while (true) {
+            usize n = reader.read(mutSub(chunk)).unwrap();
+            if (n == 0 and reader.closed() and reader.available() == 0)
+                break;
+        }
+        doNotOptimize(chunk.buf());
+
+        producer->join().unwrap();
+    });
+}
+
+} // namespace Hj::Tests
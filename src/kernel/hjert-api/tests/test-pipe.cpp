@@ -0,0 +1,168 @@
+#include <hjert-api/pipe.h>
+#include <karm-base/array.h>
+#include <karm-base/buf.h>
+#include <karm-base/clamp.h>
+#include <karm-sys/thread.h>
+#include <karm-test/macros.h>
+
+namespace Hj::Tests {
+
+static Buf<u8> _mem(usize len) {
+    // Shared memory is page aligned, so is this.
+    return Buf<u8>::init(len, 0);
+}
+
+test$(pipeInit) {
+    auto mem = _mem(sizeof(PipeHeader) + 5000);
+    auto ring = try$(PipeRing::init(mutSub(mem)));
+    expectEq$(ring.cap(), 4096uz);
+    expectEq$(ring.space(), 4096uz);
+    expectEq$(ring.available(), 0uz);
+
+    auto other = try$(PipeRing::attach(mutSub(mem)));
+    expectEq$(other.cap(), 4096uz);
+
+    auto garbage = _mem(8192);
+    expect$(not PipeRing::attach(mutSub(garbage)));
+    expect$(not PipeRing::init(mutSub(garbage, 0, 16)));
+
+    return Ok();
+}
+
+test$(pipeWrap) {
+    auto mem = _mem(sizeof(PipeHeader) + 64);
+    auto writer = try$(PipeRing::init(mutSub(mem)));
+    auto reader = try$(PipeRing::attach(mutSub(mem)));
+
+    Array<u8, 48> in{}, out{};
+    for (usize round = 0; round < 10; round++) {
+        for (usize i = 0; i < 48; i++)
+            in[i] = round * 48 + i;
+
+        // 48 bytes in a 64 bytes ring wraps around every other round.
+        expectEq$(try$(writer.write(sub(in))), 48uz);
+        expectEq$(reader.available(), 48uz);
+        expectEq$(try$(reader.read(mutSub(out))), 48uz);
+
+        for (usize i = 0; i < 48; i++)
+            expectEq$(out[i], in[i]);
+    }
+
+    return Ok();
+}
+
+test$(pipeFull) {
+    auto mem = _mem(sizeof(PipeHeader) + 64);
+    auto ring = try$(PipeRing::init(mutSub(mem)));
+
+    Array<u8, 100> buf{};
+    expectEq$(try$(ring.write(sub(buf))), 64uz);
+    expectEq$(ring.space(), 0uz);
+    expectEq$(try$(ring.write(sub(buf))), 0uz);
+
+    expectEq$(try$(ring.read(mutSub(buf, 0, 10))), 10uz);
+    expectEq$(ring.space(), 10uz);
+
+    return Ok();
+}
+
+test$(pipeWakeups) {
+    auto mem = _mem(sizeof(PipeHeader) + 64);
+    auto ring = try$(PipeRing::init(mutSub(mem)));
+
+    expect$(not ring.unparkReader());
+
+    ring.parkReader();
+    expect$(ring.unparkReader());
+    expect$(not ring.unparkReader());
+
+    ring.parkWriter();
+    expect$(not ring.unparkReader());
+    expect$(ring.unparkWriter());
+
+    return Ok();
+}
+
+// The other end shares the header, it must not be able to make
+// us read or write outside of the data by scribbling over it.
+test$(pipeCorruptHeader) {
+    auto mem = _mem(sizeof(PipeHeader) + 64);
+    auto ring = try$(PipeRing::init(mutSub(mem)));
+    auto *hdr = reinterpret_cast<PipeHeader *>(mem.buf());
+
+    Array<u8, 100> buf{};
+    expectEq$(try$(ring.write(sub(buf, 0, 16))), 16uz);
+
+    // A bigger capacity after the fact is ignored.
+    hdr->cap = 1 << 20;
+    expectEq$(ring.cap(), 64uz);
+    expectEq$(ring.space(), 48uz);
+    expectEq$(try$(ring.write(sub(buf))), 48uz);
+
+    // More bytes in the pipe than it can hold.
+    hdr->head.store(hdr->tail.load() + 1000);
+    expectEq$(ring.available(), 64uz);
+    expectEq$(ring.space(), 0uz);
+    expect$(not ring.read(mutSub(buf)));
+    expect$(not ring.write(sub(buf)));
+
+    // Tail ahead of head.
+    hdr->head.store(0);
+    hdr->tail.store(10);
+    expectEq$(ring.available(), 0uz);
+    expectEq$(ring.space(), 64uz);
+    expect$(not ring.read(mutSub(buf)));
+    expect$(not ring.write(sub(buf)));
+
+    return Ok();
+}
+
+// Streams data between two threads, in chunks that don't divide
+// the ring, so writes and reads keep wrapping around at odd offsets.
+test$(pipeStream) {
+    static constexpr usize TOTAL = 64 << 10;
+    static constexpr usize CHUNK = 1000;
+
+    auto mem = _mem(sizeof(PipeHeader) + 4096);
+    auto writer = try$(PipeRing::init(mutSub(mem)));
+    auto reader = try$(PipeRing::attach(mutSub(mem)));
+
+    auto producer = try$(Sys::Thread::spawn([&] {
+        auto chunk = _mem(CHUNK);
+        usize sent = 0;
+        while (sent < TOTAL) {
+            usize len = min(CHUNK, TOTAL - sent);
+            for (usize i = 0; i < len; i++)
+                chunk[i] = (sent + i) * 31;
+
+            usize off = 0;
+            while (off < len)
+                off += writer.write(sub(chunk, off, len)).unwrap();
+            sent += len;
+        }
+        writer.close();
+    }));
+
+    auto chunk = _mem(CHUNK);
+    usize received = 0;
+    usize errors = 0;
+    while (true) {
+        usize n = reader.read(mutSub(chunk)).unwrap();
+        for (usize i = 0; i < n; i++)
+            if (chunk[i] != (u8)((received + i) * 31))
+                errors++;
+        received += n;
+
+        if (n == 0 and reader.closed() and reader.available() == 0)
+            break;
+    }
+
+    try$(producer->join());
+
+    expectEq$(received, TOTAL);
+    expectEq$(errors, 0uz);
+
+    return Ok();
+}
+
+} // namespace Hj::Tests
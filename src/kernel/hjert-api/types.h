@@ -59,7 +59,9 @@ static inline char const *toStr(Type type) {
     SYSCALL(CLOSE)               \
     SYSCALL(SIGNAL)              \
     SYSCALL(LISTEN)              \
-    SYSCALL(POLL)
+    SYSCALL(POLL)                \
+    SYSCALL(SEND_BATCH)          \
+    SYSCALL(RECV_BATCH)
 
 // clang-format off
 
@@ -17,7 +17,7 @@ Res<Parcel> Parcel::fromMsg(Domain &dom, Hj::Msg msg) {
         }
     }
 
-    return Ok(Parcel{});
+    return Ok(std::move(parcel));
 }
 
 Res<Hj::Msg> Parcel::toMsg(Domain &dom) {
@@ -47,8 +47,8 @@ Res<Strong<Channel>> Channel::create(usize cap) {
     return Ok(makeStrong<Channel>(cap));
 }
 
-Channel::Channel(usize cap) {
-    _cap = cap;
+Channel::Channel(usize cap)
+    : _ring(cap), _cap(cap) {
 }
 
 Res<> Channel::_ensureNoEmpty() {
@@ -73,9 +73,17 @@ Res<> Channel::_ensureOpen() {
 }
 
 void Channel::_updateSignalsUnlock() {
-    _signalUnlock(
-        _closed ? Hj::Sigs::CLOSED : Hj::Sigs::NONE,
-        _closed ? Hj::Sigs::NONE : Hj::Sigs::CLOSED);
+    Flags<Hj::Sigs> sigs = Hj::Sigs::NONE;
+    if (_closed)
+        sigs |= Hj::Sigs::CLOSED;
+    if (_ring.len() > 0)
+        sigs |= Hj::Sigs::READABLE;
+    if (_ring.len() < _cap)
+        sigs |= Hj::Sigs::WRITABLE;
+
+    // NOTE: This wakes up the listeners waiting on the channel.
+    Flags<Hj::Sigs> all = Hj::Sigs::CLOSED | Hj::Sigs::READABLE | Hj::Sigs::WRITABLE;
+    _signalUnlock(sigs, all & ~sigs);
 }
 
 Res<> Channel::send(Domain &dom, Hj::Msg msg) {
@@ -83,6 +91,7 @@ Res<> Channel::send(Domain &dom, Hj::Msg msg) {
     try$(_ensureOpen());
     try$(_ensureNoFull());
     _ring.pushBack(try$(Parcel::fromMsg(dom, msg)));
+    _updateSignalsUnlock();
     return Ok();
 }
 
@@ -90,13 +99,60 @@ Res<Hj::Msg> Channel::recv(Domain &dom) {
     ObjectLockScope scope{*this};
     try$(_ensureOpen());
     try$(_ensureNoEmpty());
-    auto parcel = _ring.popBack();
+    auto parcel = _ring.dequeue();
+    _updateSignalsUnlock();
     return parcel.toMsg(dom);
 }
 
+Res<usize> Channel::sendBatch(Domain &dom, Slice<Hj::Msg> msgs) {
+    ObjectLockScope scope{*this};
+    try$(_ensureOpen());
+
+    usize sent = 0;
+    while (sent < msgs.len() and _ring.len() < _cap) {
+        auto parcel = Parcel::fromMsg(dom, msgs[sent]);
+        if (not parcel) {
+            // NOTE: Report the messages that made it before the error.
+            if (sent)
+                break;
+            return parcel.none();
+        }
+        _ring.pushBack(parcel.take());
+        sent++;
+    }
+
+    _updateSignalsUnlock();
+    return Ok(sent);
+}
+
+Res<usize> Channel::recvBatch(Domain &dom, MutSlice<Hj::Msg> msgs) {
+    ObjectLockScope scope{*this};
+    try$(_ensureOpen());
+
+    usize received = 0;
+    Res<> res = Ok();
+    while (received < msgs.len() and _ring.len() > 0) {
+        // NOTE: The parcel stays in the ring until it converted, so that
+        //       a failure is reported by the next call instead of lost.
+        auto msg = _ring.peek(0).toMsg(dom);
+        if (not msg) {
+            res = msg.none();
+            break;
+        }
+        (void)_ring.dequeue();
+        msgs[received++] = msg.take();
+    }
+
+    _updateSignalsUnlock();
+    if (not res and not received)
+        return res.none();
+    return Ok(received);
+}
+
 Res<> Channel::close() {
     ObjectLockScope scope{*this};
     _closed = true;
+    _updateSignalsUnlock();
     return Ok();
 }
 
@@ -42,6 +42,12 @@ struct Channel :
 
     Res<Hj::Msg> recv(Domain &dom);
 
+    // Sends as many messages as fit, returns how many that was.
+    Res<usize> sendBatch(Domain &dom, Slice<Hj::Msg> msgs);
+
+    // Receives up to msgs.len() messages, returns how many that was.
+    Res<usize> recvBatch(Domain &dom, MutSlice<Hj::Msg> msgs);
+
     Res<> close();
 };
 
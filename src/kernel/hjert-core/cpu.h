@@ -14,7 +14,11 @@
 
 namespace Hjert::Core {
 
+static constexpr usize MAX_CPUS = 16;
+
 struct Cpu {
+    // Index of the cpu, used to pick per-cpu caches.
+    usize _id = 0;
     bool _retainEnabled = false;
     isize _depth = 0;
 
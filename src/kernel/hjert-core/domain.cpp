@@ -7,24 +7,20 @@ Res<Strong<Domain>> Domain::create() {
 }
 
 Res<Hj::Cap> Domain::add(Hj::Cap dest, Strong<Object> obj) {
-    ObjectLockScope scope(*this);
-
     auto c = dest.raw();
 
     if (c != 0) {
-        auto subDomain = try$(_getUnlock<Domain>(Hj::Cap{c & Hj::Cap::MASK}));
+        auto subDomain = try$(get<Domain>(Hj::Cap{c & Hj::Cap::MASK}));
         auto newCap = try$(subDomain->add(Hj::Cap{c >> Hj::Cap::SHIFT}, obj));
         return Ok(Hj::Cap{newCap._raw | (c & ~Hj::Cap::MASK)});
     }
 
-    for (c = 1; c < _slots.len(); c++) {
-        if (not _slots[c]) {
-            _slots[c] = obj;
-            return Ok(Hj::Cap{c});
-        }
-    }
+    WriteLockScope scope(_slotsLock);
+    auto slot = _slots.add(obj);
+    if (not slot)
+        return Error::invalidHandle("no free slots");
 
-    return Error::invalidHandle("no free slots");
+    return Ok(Hj::Cap{*slot});
 }
 
 Res<Strong<Object>> Domain::_getUnlock(Hj::Cap cap) {
@@ -35,31 +31,30 @@ Res<Strong<Object>> Domain::_getUnlock(Hj::Cap cap) {
         return subDomain->get(Hj::Cap{c >> Hj::Cap::SHIFT});
     }
 
-    if (not _slots[c])
+    auto *obj = _slots.get(c);
+    if (not obj)
         return Error::invalidHandle("slot is empty");
 
-    return Ok(*_slots[c]);
+    return Ok(*obj);
 }
 
 Res<Strong<Object>> Domain::get(Hj::Cap cap) {
-    ObjectLockScope scope(*this);
+    ReadLockScope scope(_slotsLock);
     return _getUnlock(cap);
 }
 
 Res<> Domain::drop(Hj::Cap cap) {
-    ObjectLockScope scope(*this);
-
     auto c = cap.raw();
 
     if (c & ~Hj::Cap::MASK) {
-        auto subDomain = try$(_getUnlock<Domain>(Hj::Cap{c & Hj::Cap::MASK}));
+        auto subDomain = try$(get<Domain>(Hj::Cap{c & Hj::Cap::MASK}));
         return subDomain->drop(Hj::Cap{c >> Hj::Cap::SHIFT});
     }
 
-    if (not _slots[c])
+    WriteLockScope scope(_slotsLock);
+    if (not _slots.take(c))
         return Error::invalidHandle("slot is empty");
 
-    _slots[c] = NONE;
     return Ok();
 }
 
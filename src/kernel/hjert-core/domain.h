@@ -1,18 +1,24 @@
 #pragma once
 
+#include <karm-base/slot-table.h>
+
 #include "object.h"
 
 namespace Hjert::Core {
 
 struct Domain : public BaseObject<Domain, Hj::Type::DOMAIN> {
-    using Slot = Opt<Strong<Object>>;
+    // Slot 0 stands for the domain itself (Hj::ROOT), it's never handed out.
+    SlotTable<Strong<Object>, Hj::Cap::LEN> _slots{1};
 
-    Array<Slot, Hj::Cap::LEN> _slots;
+    // Lookups are much more common than adding or dropping
+    // capabilities, they only need to share the slots.
+    RwLock _slotsLock;
 
     static Res<Strong<Domain>> create();
 
     Res<Hj::Cap> add(Hj::Cap dest, Strong<Object> obj);
 
+    // The slots must be locked, for reading at least.
     Res<Strong<Object>> _getUnlock(Hj::Cap cap);
 
     Res<Strong<Object>> get(Hj::Cap cap);
@@ -27,7 +33,7 @@ struct Domain : public BaseObject<Domain, Hj::Type::DOMAIN> {
 
     template <typename T>
     Res<Strong<T>> get(Hj::Cap cap) {
-        ObjectLockScope scope(*this);
+        ReadLockScope scope(_slotsLock);
         return _getUnlock<T>(cap);
     }
 
@@ -125,6 +125,7 @@ Res<> init(u64 magic, Handover::Payload &payload) {
 
     logInfo("entry: entering userspace...");
     try$(enterUserspace(payload));
+    Mem::dumpStats();
 
     logInfo("entry: entering idle loop...");
     Task::self().label("idle");
@@ -1,46 +1,121 @@
 #include "listener.h"
 
+#include "sched.h"
+#include "task.h"
+
 namespace Hjert::Core {
 
 Res<Strong<Listener>> Listener::create() {
     return Ok(makeStrong<Listener>());
 }
 
+Listener::~Listener() {
+    for (auto &l : _listened)
+        l->obj->unwatch(*this, (usize)&*l);
+}
+
+void Listener::_notify(usize key, Flags<Hj::Sigs> old, Flags<Hj::Sigs> now) {
+    LockScope scope(_readyLock);
+    _edgeUnlock(*reinterpret_cast<Listened *>(key), old, now);
+}
+
+void Listener::_edgeUnlock(Listened &l, Flags<Hj::Sigs> old, Flags<Hj::Sigs> now) {
+    auto rose = now & ~old & l.set;
+    auto fell = old & ~now & l.unset;
+    if (rose.empty() and fell.empty())
+        return;
+
+    l.rose |= rose;
+    l.fell |= fell;
+    if (not l.ready) {
+        l.ready = true;
+        _ready.pushBack(&l);
+    }
+
+    if (_waiter)
+        Sched::instance().wake(**_waiter);
+}
+
+void Listener::wait(Opt<Strong<Task>> task) {
+    LockScope scope(_readyLock);
+    _waiter = std::move(task);
+}
+
 Res<> Listener::listen(Hj::Cap cap, Strong<Object> obj, Flags<Hj::Sigs> set, Flags<Hj::Sigs> unset) {
+    if (&obj.unwrap() == this)
+        return Error::invalidInput("listener listening to itself");
+
     ObjectLockScope scope{*this};
 
-    for (usize i = 0; i < _listened.len(); ++i) {
-        if (_listened[i].cap == cap) {
-            auto &listened = _listened[i];
-            listened.set = set;
-            listened.unset = unset;
+    usize i = 0;
+    while (i < _listened.len() and _listened[i]->cap != cap)
+        i++;
 
-            if (listened.set.empty() and
-                listened.unset.empty()) {
-                _listened.removeAt(i);
-                return Ok();
+    if (i == _listened.len()) {
+        if (set.empty() and unset.empty())
+            return Ok();
+
+        _listened.pushBack(makeBox<Listened>(cap, obj, set, unset));
+        obj->watch(*this, (usize)&*_listened[i]);
+    }
+
+    auto &l = *_listened[i];
+
+    if (set.empty() and unset.empty()) {
+        // NOTE: Once unwatched the object can't notify us anymore,
+        //       so it's safe to forget about the entry.
+        l.obj->unwatch(*this, (usize)&l);
+
+        LockScope readyScope(_readyLock);
+        for (usize j = 0; j < _ready.len(); j++) {
+            if (_ready[j] == &l) {
+                _ready.removeAt(j);
+                break;
             }
         }
+        _listened.removeAt(i);
+        return Ok();
     }
 
-    _listened.pushBack(Listened{cap, obj, set, unset});
+    // Signals that are already there count as
+    // edges, otherwise they would never be reported.
+    auto current = obj->poll();
+
+    LockScope readyScope(_readyLock);
+    l.set = set;
+    l.unset = unset;
+    _edgeUnlock(l, ~current, current);
     return Ok();
 }
 
-Slice<Hj::Event> Listener::poll() {
+bool Listener::pending() {
+    LockScope scope(_readyLock);
+    return _ready.len() > 0;
+}
+
+Slice<Hj::Event> Listener::poll(usize max) {
     ObjectLockScope scope{*this};
+    LockScope readyScope(_readyLock);
     _events.clear();
 
-    for (auto &l : _listened) {
-        auto sigs = l.obj->poll();
-        if (sigs & l.set) {
-            _events.pushBack(Hj::Event{l.cap, sigs & l.set, true});
-        }
+    usize taken = 0;
+    for (auto *l : _ready) {
+        usize needed = (l->rose.empty() ? 0 : 1) + (l->fell.empty() ? 0 : 1);
+        if (_events.len() + needed > max)
+            break;
 
-        if (~sigs & l.unset) {
-            _events.pushBack(Hj::Event{l.cap, sigs & l.unset, false});
-        }
+        if (not l->rose.empty())
+            _events.pushBack(Hj::Event{l->cap, l->rose, true});
+
+        if (not l->fell.empty())
+            _events.pushBack(Hj::Event{l->cap, l->fell, false});
+
+        l->rose = Hj::Sigs::NONE;
+        l->fell = Hj::Sigs::NONE;
+        l->ready = false;
+        taken++;
     }
+    _ready.removeRange(0, taken);
 
     return _events;
 }
@@ -1,11 +1,17 @@
 #pragma once
 
+#include <karm-base/box.h>
 #include <karm-base/vec.h>
 
 #include "object.h"
 
 namespace Hjert::Core {
 
+struct Task;
+
+// Reports the edges of the signals of the objects it listens to. Objects
+// tell the listener when their signals change, so polling only looks at
+// the objects that have something to report instead of all of them.
 struct Listener :
     public BaseObject<Listener, Hj::Type::LISTENER> {
 
@@ -15,16 +21,46 @@ struct Listener :
 
         Flags<Hj::Sigs> set;
         Flags<Hj::Sigs> unset;
+
+        // Edges seen since the last poll.
+        Flags<Hj::Sigs> rose;
+        Flags<Hj::Sigs> fell;
+        bool ready = false;
     };
 
-    Vec<Listened> _listened;
+    // Boxed, so that the listened objects can hold on to them as keys.
+    Vec<Box<Listened>> _listened;
     Vec<Hj::Event> _events;
 
+    // Protects the edges, the ready list and the waiter, objects take
+    // it while they are locked to tell the listener about their signals.
+    Lock _readyLock;
+    Vec<Listened *> _ready;
+
+    // The task blocked polling this listener, woken up
+    // when any of the listened objects gets signaled.
+    Opt<Strong<Task>> _waiter;
+
     static Res<Strong<Listener>> create();
 
+    ~Listener() override;
+
+    void _notify(usize key, Flags<Hj::Sigs> old, Flags<Hj::Sigs> now) override;
+
+    // Records the edges of the signals going from old to now, and wakes
+    // up the waiter if there is any, the ready lock must be held.
+    void _edgeUnlock(Listened &l, Flags<Hj::Sigs> old, Flags<Hj::Sigs> now);
+
+    void wait(Opt<Strong<Task>> task);
+
     Res<> listen(Hj::Cap cap, Strong<Object> obj, Flags<Hj::Sigs> set, Flags<Hj::Sigs> unset);
 
-    Slice<Hj::Event> poll();
+    // Whether there are edges waiting to be polled.
+    bool pending();
+
+    // Takes the edges seen since the last poll, leaves the
+    // ones that don't fit in `max` events for the next poll.
+    Slice<Hj::Event> poll(usize max);
 
     Slice<Hj::Event> events() {
         return _events;
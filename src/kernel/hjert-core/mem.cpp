@@ -1,19 +1,39 @@
 #include <karm-base/bits.h>
+#include <karm-base/buddy.h>
 #include <karm-base/lock.h>
 #include <karm-base/size.h>
 #include <karm-logger/logger.h>
 
 #include "arch.h"
+#include "cpu.h"
 #include "mem.h"
 
 namespace Hjert::Core {
 
-struct Pmm : public Hal::Pmm {
+static BitsRange pmm2Bits(Hal::PmmRange usable, Hal::PmmRange range) {
+    range.start -= usable.start;
+    range.start /= Hal::PAGE_SIZE;
+    range.size /= Hal::PAGE_SIZE;
+
+    return range.as<BitsRange>();
+}
+
+static Hal::PmmRange bits2Pmm(Hal::PmmRange usable, BitsRange range) {
+    range.size *= Hal::PAGE_SIZE;
+    range.start *= Hal::PAGE_SIZE;
+    range.start += usable.start;
+
+    return range.as<Hal::PmmRange>();
+}
+
+/* --- Bitmap Pmm ----------------------------------------------------------- */
+
+struct BitsPmm : public Hal::Pmm {
     Hal::PmmRange _usable;
     Bits _bits;
     Lock _lock;
 
-    Pmm(Hal::PmmRange usable, Bits bits)
+    BitsPmm(Hal::PmmRange usable, Bits bits)
         : _usable(usable),
           _bits(bits) {
         clear();
@@ -66,19 +86,148 @@ struct Pmm : public Hal::Pmm {
     }
 
     BitsRange pmm2Bits(Hal::PmmRange range) {
-        range.start -= _usable.start;
-        range.start /= Hal::PAGE_SIZE;
-        range.size /= Hal::PAGE_SIZE;
-
-        return range.as<BitsRange>();
+        return Core::pmm2Bits(_usable, range);
     }
 
     Hal::PmmRange bits2Pmm(BitsRange range) {
-        range.size *= Hal::PAGE_SIZE;
-        range.start *= Hal::PAGE_SIZE;
-        range.start += _usable.start;
+        return Core::bits2Pmm(_usable, range);
+    }
+};
+
+/* --- Buddy Pmm ------------------------------------------------------------ */
+
+struct BuddyPmm : public Hal::Pmm {
+    Hal::PmmRange _usable;
+    Buddy _buddy;
+    Lock _lock;
+
+    BuddyPmm(Hal::PmmRange usable, MutBytes meta)
+        : _usable(usable),
+          _buddy(meta, usable.size / Hal::PAGE_SIZE) {}
+
+    Res<Hal::PmmRange> allocRange(usize size, Hal::PmmFlags) override {
+        try$(ensureAlign(size, Hal::PAGE_SIZE));
+
+        LockScope scope(_lock);
+        auto range = _buddy.alloc(size / Hal::PAGE_SIZE);
+        if (not range)
+            return Error::outOfMemory("no free block large enough");
+        return Ok(bits2Pmm(_usable, *range));
+    }
+
+    Res<> used(Hal::PmmRange prange, Hal::PmmFlags) override {
+        if (not prange.overlaps(_usable)) {
+            return Error::invalidInput("range is not in usable memory");
+        }
+
+        try$(prange.ensureAligned(Hal::PAGE_SIZE));
+        LockScope scope(_lock);
+        _buddy.used(pmm2Bits(_usable, prange));
+        return Ok();
+    }
+
+    Res<> free(Hal::PmmRange prange) override {
+        if (not prange.overlaps(_usable)) {
+            return Error::invalidInput("range is not in usable memory");
+        }
+
+        try$(prange.ensureAligned(Hal::PAGE_SIZE));
+        LockScope scope(_lock);
+        _buddy.free(pmm2Bits(_usable, prange));
+        return Ok();
+    }
+
+    void dump() {
+        logInfo(" mem: physical memory layout:");
+        _buddy.visit([this](auto range) {
+            auto prange = bits2Pmm(_usable, range);
+            logInfo("    {x} - {x} ({}kib)", prange.start, prange.end(), prange.size / kib(1));
+        });
+    }
+};
 
-        return range.as<Hal::PmmRange>();
+/* --- Page Cache ----------------------------------------------------------- */
+
+// Per-cpu stacks of free pages in front of the pmm. Single page
+// allocations and frees only reach the pmm (and its lock) once
+// every BATCH pages, the rest pass through untouched.
+struct PageCache : public Hal::Pmm {
+    static constexpr usize DEPTH = 64;
+    static constexpr usize BATCH = DEPTH / 2;
+
+    struct _Stack {
+        usize len = 0;
+        usize pages[DEPTH];
+    };
+
+    Hal::Pmm &_pmm;
+    _Stack _stacks[MAX_CPUS];
+    Atomic<usize> _hits{};
+    Atomic<usize> _misses{};
+
+    PageCache(Hal::Pmm &pmm) : _pmm(pmm) {}
+
+    _Stack &_stack() {
+        return _stacks[Arch::cpu()._id % MAX_CPUS];
+    }
+
+    Res<> _refill(_Stack &stack) {
+        // Grab a whole batch in one go when there is a contiguous run
+        // large enough, otherwise settle for a single page.
+        auto batch = _pmm.allocRange(BATCH * Hal::PAGE_SIZE, Hal::PmmFlags::NONE);
+        auto range = batch ? batch.unwrap() : try$(_pmm.allocRange(Hal::PAGE_SIZE, Hal::PmmFlags::NONE));
+
+        for (usize page = range.end(); page > range.start; page -= Hal::PAGE_SIZE)
+            stack.pages[stack.len++] = page - Hal::PAGE_SIZE;
+
+        return Ok();
+    }
+
+    Res<Hal::PmmRange> allocRange(usize size, Hal::PmmFlags flags) override {
+        if (size != Hal::PAGE_SIZE or flags != Hal::PmmFlags::NONE)
+            return _pmm.allocRange(size, flags);
+
+        CriticalScope scope;
+        auto &stack = _stack();
+
+        if (stack.len) {
+            _hits.inc(RELAXED);
+        } else {
+            _misses.inc(RELAXED);
+            try$(_refill(stack));
+        }
+
+        return Ok(Hal::PmmRange{stack.pages[--stack.len], Hal::PAGE_SIZE});
+    }
+
+    // NOTE: Only used while bootstrapping, before any page got cached.
+    Res<> used(Hal::PmmRange range, Hal::PmmFlags flags) override {
+        return _pmm.used(range, flags);
+    }
+
+    Res<> free(Hal::PmmRange range) override {
+        if (range.size != Hal::PAGE_SIZE)
+            return _pmm.free(range);
+
+        try$(range.ensureAligned(Hal::PAGE_SIZE));
+
+        CriticalScope scope;
+        auto &stack = _stack();
+
+        if (stack.len == DEPTH) {
+            while (stack.len > BATCH)
+                try$(_pmm.free({stack.pages[--stack.len], Hal::PAGE_SIZE}));
+        }
+
+        stack.pages[stack.len++] = range.start;
+        return Ok();
+    }
+
+    usize cached() {
+        usize res = 0;
+        for (auto &stack : _stacks)
+            res += stack.len;
+        return res;
     }
 };
 
@@ -116,8 +265,35 @@ struct Kmm : public Hal::Kmm {
     }
 };
 
-static Opt<Pmm> _pmm = NONE;
+/* --- Slab Backend --------------------------------------------------------- */
+
+static_assert(Slab::PAGE == Hal::PAGE_SIZE);
+
+struct KmmSlabs : public SlabBackend {
+    void *allocPage() override {
+        auto range = kmm().allocRange(Slab::PAGE);
+        if (not range)
+            return nullptr;
+        return reinterpret_cast<void *>(range.unwrap().start);
+    }
+
+    void freePage(void *page) override {
+        kmm()
+            .free({reinterpret_cast<usize>(page), Slab::PAGE})
+            .unwrap("slab: failed to free page");
+    }
+
+    usize cpu() override {
+        return Arch::cpu()._id;
+    }
+};
+
+static Opt<BuddyPmm> _buddyPmm = NONE;
+static Opt<BitsPmm> _bitsPmm = NONE;
+static Hal::Pmm *_pmm = nullptr;
+static Opt<PageCache> _pageCache = NONE;
 static Opt<Kmm> _kmm = NONE;
+static Opt<KmmSlabs> _slabs = NONE;
 
 namespace Mem {
 
@@ -131,36 +307,62 @@ Res<> init(Handover::Payload &payload) {
 
     logInfo("mem: usable range: {x}-{x}", usableRange.start, usableRange.end());
 
-    usize bitsSize = usableRange.size / Hal::PAGE_SIZE / 8;
-
-    auto pmmBits = payload.find(bitsSize);
+    // NOTE: The buddy allocator needs more bookkeeping than a plain
+    //       bitmap, fall back to the latter on tight memory maps.
+    usize pages = usableRange.size / Hal::PAGE_SIZE;
+    usize metaSize = alignUp(Buddy::metaSize(pages), Hal::PAGE_SIZE);
+    auto pmmMeta = payload.find(metaSize);
+
+    if (not pmmMeta.empty()) {
+        pmmMeta.size = metaSize;
+
+        logInfo("mem: pmm buddy range: {x}-{x}", pmmMeta.start, pmmMeta.end());
+
+        _buddyPmm.emplace(usableRange,
+                          MutBytes{
+                              reinterpret_cast<Byte *>(pmmMeta.start + Hal::UPPER_HALF),
+                              pmmMeta.size,
+                          });
+        _pmm = &*_buddyPmm;
+    } else {
+        metaSize = alignUp(pages / 8, Hal::PAGE_SIZE);
+        pmmMeta = payload.find(metaSize);
+
+        if (pmmMeta.empty()) {
+            logError("mem: no usable memory for pmm");
+            return Error::outOfMemory("no usable memory for pmm");
+        }
 
-    if (pmmBits.empty()) {
-        logError("mem: no usable memory for pmm");
-        return Error::outOfMemory("no usable memory for pmm");
-    }
+        pmmMeta.size = metaSize;
 
-    logInfo("mem: pmm bitmap range: {x}-{x}", pmmBits.start, pmmBits.end());
+        logInfo("mem: pmm bitmap range: {x}-{x}", pmmMeta.start, pmmMeta.end());
 
-    _pmm.emplace(usableRange,
-                 MutSlice{
-                     reinterpret_cast<u8 *>(pmmBits.start + Hal::UPPER_HALF),
-                     pmmBits.size,
-                 });
+        _bitsPmm.emplace(usableRange,
+                         MutSlice{
+                             reinterpret_cast<u8 *>(pmmMeta.start + Hal::UPPER_HALF),
+                             pmmMeta.size,
+                         });
+        _pmm = &*_bitsPmm;
+    }
 
-    _kmm.emplace(_pmm.unwrap());
+    _pageCache.emplace(*_pmm);
+    _kmm.emplace(*_pageCache);
+    _slabs.emplace();
 
     logInfo("mem: marking free memory as free...");
     for (auto &record : payload) {
         if (record.tag == Handover::Tag::FREE) {
             logInfo("mem: free memory at {x} {x} ({}kib)", record.start, record.start + record.size, record.size / kib(1));
-            try$(pmm().free({record.start, record.size}));
+            try$(_pmm->free({record.start, record.size}));
         }
     }
 
-    try$(_pmm->used({pmmBits.start, pmmBits.size}, Hal::PmmFlags::NONE));
+    try$(_pmm->used({pmmMeta.start, pmmMeta.size}, Hal::PmmFlags::NONE));
 
-    _pmm->dump();
+    if (_buddyPmm)
+        _buddyPmm->dump();
+    else
+        _bitsPmm->dump();
 
     logInfo("mem: mapping kernel...");
     try$(Arch::vmm().mapRange(
@@ -191,13 +393,37 @@ Res<> init(Handover::Payload &payload) {
     return Ok();
 }
 
+void dumpStats() {
+    logInfo("mem: page cache: {} pages cached, {} hits, {} misses", _pageCache->cached(), _pageCache->_hits.load(RELAXED), _pageCache->_misses.load(RELAXED));
+
+    slabs().visit([](Slab &slab) {
+        auto stats = slab.stats();
+        logInfo(
+            "mem: slab '{}': {} bytes, {} pages, {} used, {} allocs, {} frees, {} hits",
+            stats.name,
+            stats.size,
+            stats.pages,
+            stats.used,
+            stats.allocs,
+            stats.frees,
+            stats.hits);
+    });
+}
+
 } // namespace Mem
 
 Hal::Pmm &pmm() {
-    if (not _pmm) {
+    if (not _pageCache) {
         logFatal("mem: pmm not initialized yet");
     }
-    return *_pmm;
+    return *_pageCache;
+}
+
+SlabBackend &slabs() {
+    if (not _slabs) {
+        logFatal("mem: slabs not initialized yet");
+    }
+    return *_slabs;
 }
 
 Hal::Kmm &kmm() {
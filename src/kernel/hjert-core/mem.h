@@ -4,6 +4,7 @@
 #include <hal/pmm.h>
 #include <hal/vmm.h>
 #include <handover/spec.h>
+#include <karm-base/slab.h>
 
 namespace Hjert::Core {
 
@@ -11,10 +12,15 @@ namespace Mem {
 
 Res<> init(Handover::Payload &);
 
+// Log the state of the page caches and the slab caches.
+void dumpStats();
+
 } // namespace Mem
 
 Hal::Kmm &kmm();
 
 Hal::Pmm &pmm();
 
+SlabBackend &slabs();
+
 } // namespace Hjert::Core
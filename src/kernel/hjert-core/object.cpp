@@ -14,8 +14,16 @@ String Object::label() const {
 }
 
 void Object::_signalUnlock(Flags<Hj::Sigs> set, Flags<Hj::Sigs> unset) {
+    auto old = _signals;
     _signals |= set;
     _signals &= ~unset;
+
+    if (_signals == old)
+        return;
+
+    for (auto &w : _watchers)
+        w.obj->_notify(w.key, old, _signals);
+    _wake();
 }
 
 Flags<Hj::Sigs> Object::_pollUnlock() {
@@ -27,6 +35,21 @@ void Object::signal(Flags<Hj::Sigs> set, Flags<Hj::Sigs> unset) {
     _signalUnlock(set, unset);
 }
 
+void Object::watch(Object &watcher, usize key) {
+    LockScope scope(_lock);
+    _watchers.pushBack({&watcher, key});
+}
+
+void Object::unwatch(Object &watcher, usize key) {
+    LockScope scope(_lock);
+    for (usize i = 0; i < _watchers.len(); i++) {
+        if (_watchers[i].obj == &watcher and _watchers[i].key == key) {
+            _watchers.removeAt(i);
+            return;
+        }
+    }
+}
+
 Flags<Hj::Sigs> Object::poll() {
     LockScope scope(_lock);
     return _pollUnlock();
@@ -4,22 +4,42 @@
 #include <karm-base/atomic.h>
 #include <karm-base/lock.h>
 #include <karm-base/rc.h>
+#include <karm-base/vec.h>
 #include <karm-fmt/case.h>
 
+#include "mem.h"
+
 namespace Hjert::Core {
 
 struct Object : public Meta::Static {
+    struct Watcher {
+        Object *obj;
+        usize key;
+    };
+
     static Atomic<usize> _counter;
 
     Lock _lock;
     usize _id = _counter.fetchAdd(1);
     Opt<String> _label;
     Flags<Hj::Sigs> _signals;
+    Vec<Watcher> _watchers;
 
     virtual ~Object() = default;
 
     virtual Hj::Type type() const = 0;
 
+    // Called when the signals of this object changed, with the object locked.
+    virtual void _wake() {}
+
+    // Called when the signals of an object we are watching changed,
+    // with that object locked. The key is the one given to watch().
+    virtual void _notify(usize, Flags<Hj::Sigs>, Flags<Hj::Sigs>) {}
+
+    void watch(Object &watcher, usize key);
+
+    void unwatch(Object &watcher, usize key);
+
     usize id() const { return _id; }
 
     void label(Str label);
@@ -44,6 +64,41 @@ struct BaseObject : public Object {
     Hj::Type type() const override {
         return TYPE;
     }
+
+    /* --- Allocation --- */
+
+    // Objects larger than this waste too much of a page
+    // to be worth a slab, they come from the heap instead.
+    static constexpr usize SLAB_MAX = Slab::PAGE / 4;
+
+    // Each kind of object gets its own slab cache, see Cell<T>::operator new.
+    static Slab &_slab(usize size) {
+        static Slab slab{Hj::toStr(TYPE), size, slabs()};
+        return slab;
+    }
+
+    static void *cellAlloc(usize size) {
+        if (size > SLAB_MAX)
+            return ::operator new(size);
+
+        auto &slab = _slab(size);
+        if (size > slab.size())
+            panic("object: slab too small");
+
+        void *ptr = slab.alloc();
+        if (not ptr)
+            panic("object: out of memory");
+
+        memset(ptr, 0, size);
+        return ptr;
+    }
+
+    static void cellFree(void *ptr, usize size) {
+        if (size > SLAB_MAX)
+            return ::operator delete(ptr, size);
+
+        _slab(size).free(ptr);
+    }
 };
 
 struct ObjectLockScope : public LockScope {
@@ -1,6 +1,9 @@
+#include <karm-base/atomic.h>
+#include <karm-base/cpu-queues.h>
 #include <karm-logger/logger.h>
 
 #include "arch.h"
+#include "cpu.h"
 #include "mem.h"
 #include "sched.h"
 #include "space.h"
@@ -8,54 +11,128 @@
 
 namespace Hjert::Core {
 
-static Opt<Sched> _sched;
+// Tasks are owned by the scheduler until they exit, each one knows
+// its slot so that it can be dropped in O(1).
+static Lock _tasksLock;
+static Vec<Strong<Task>> _tasks;
+
+static Opt<Sched> _scheds[MAX_CPUS];
+static CpuQueues<Task, Sched::PRIOS, MAX_CPUS> _queues;
+
+// Microseconds since boot, deadlines and what user space is told
+// don't depend on which cpu a task happens to run on.
+static Atomic<usize> _uptime;
+
+static Task &_own(Strong<Task> task) {
+    LockScope scope(_tasksLock);
+    task->_slot = _tasks.len();
+    _tasks.pushBack(std::move(task));
+    return *_tasks[_tasks.len() - 1];
+}
 
 Res<> Sched::init(Handover::Payload &) {
     logInfo("sched: initializing...");
     auto bootTask = try$(Task::create(Mode::SUPER, try$(Space::create())));
     bootTask->label("entry");
     try$(bootTask->ready(0, 0, {}));
-    _sched.emplace(std::move(bootTask));
+    _own(bootTask);
+    _scheds[0].emplace(0, std::move(bootTask));
     return Ok();
 }
 
+TimeStamp Sched::now() {
+    return TimeStamp::epoch() + TimeSpan::fromUSecs(_uptime.load());
+}
+
 Sched &Sched::instance() {
-    return *_sched;
+    return of(Arch::cpu()._id);
 }
 
-Sched::Sched(Strong<Task> boot)
-    : _tasks{boot},
-      _prev(boot),
-      _curr(boot),
-      _idle(boot) {
+Sched &Sched::of(usize cpu) {
+    return *_scheds[cpu];
 }
 
-Res<> Sched::enqueue(Strong<Task> task) {
+Sched::Sched(usize cpu, Strong<Task> idle)
+    : _cpu(cpu),
+      _prev(idle),
+      _curr(idle),
+      _idle(idle) {
+}
+
+Strong<Task> Sched::current() {
     LockScope scope(_lock);
-    _tasks.pushBack(std::move(task));
+    return _curr;
+}
+
+Res<> Sched::enqueue(Strong<Task> task) {
+    auto &t = _own(std::move(task));
+    t._run.cpu = _queues.leastLoaded();
+    _queues.push(t);
     return Ok();
 }
 
+void Sched::wake(Task &task) {
+    _queues.wake(task);
+}
+
+void Sched::_drop(Task &task) {
+    logInfo("{}: exited", task);
+    _queues.remove(task);
+
+    // NOTE: Swap with the last task to keep the removal O(1),
+    //       the task might be freed after this.
+    LockScope scope(_tasksLock);
+    usize slot = task._slot;
+    std::swap(_tasks[slot], _tasks[_tasks.len() - 1]);
+    _tasks[slot]->_slot = slot;
+    _tasks.popBack();
+}
+
+// NOTE: Another cpu may wake the task up right after eval() found it
+//       blocked, sleep() then puts it back in the ready queue instead.
+void Sched::_requeue(Task &task, TimeStamp now) {
+    auto state = task.eval(now);
+    if (state == State::EXITED)
+        _drop(task);
+    else if (state == State::BLOCKED)
+        _queues.sleep(task, task._run.deadline);
+    else
+        _queues.push(task);
+}
+
 void Sched::schedule(TimeSpan span) {
     LockScope scope(_lock);
 
-    _stamp += span;
+    // NOTE: Only the boot cpu is started, its timer is the one
+    //       moving the clock forward.
+    _uptime.fetchAdd(span.toUSecs());
+    auto now = Sched::now();
     _prev = _curr;
-    _curr->_sliceEnd = _stamp;
+
+    // Tasks whose deadline passed get another look,
+    // the others stay asleep until they are woken up.
+    _queues.expire(_cpu, now);
+
+    // Round robin within a priority level, the
+    // current task goes to the back of its queue.
+    if (&_curr.unwrap() != &_idle.unwrap())
+        _requeue(*_curr, now);
+
+    // When this cpu runs out of tasks it
+    // steals from the busiest one instead.
     auto next = _idle;
-    // HACK: to make sure the idle task is always scheduled last
-    _idle->_sliceEnd = _stamp + 1;
-
-    for (usize i = 0; i < _tasks.len(); ++i) {
-        auto &t = _tasks[i];
-        auto state = t->eval(_stamp);
-        if (state == State::EXITED) {
-            logInfo("{}: exited", *t);
-            _tasks.removeAt(i--);
-        } else if (state == State::RUNNABLE and
-                   t->_sliceEnd <= next->_sliceEnd) {
-            next = t;
+    while (auto *t = _queues.pop(_cpu)) {
+        auto state = t->eval(now);
+        if (state == State::RUNNABLE) {
+            LockScope scope(_tasksLock);
+            next = _tasks[t->_slot];
+            break;
         }
+
+        if (state == State::EXITED)
+            _drop(*t);
+        else
+            _queues.sleep(*t, t->_run.deadline);
     }
 
     _curr = next;
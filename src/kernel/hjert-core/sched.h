@@ -13,22 +13,42 @@ struct Task;
 /* --- Sched ---------------------------------------------------------------- */
 
 struct Sched {
-    TimeStamp _stamp{};
+    static constexpr usize PRIOS = 32;
+    static constexpr usize DEFAULT_PRIO = PRIOS / 2;
+
+    usize _cpu;
     Lock _lock{};
 
-    Vec<Strong<Task>> _tasks;
     Strong<Task> _prev;
     Strong<Task> _curr;
     Strong<Task> _idle;
 
     static Res<> init(Handover::Payload &);
 
+    // The time since boot, the same on all the cpus.
+    static TimeStamp now();
+
+    // The scheduler of the cpu we are running on.
     static Sched &instance();
 
-    Sched(Strong<Task> boot);
+    static Sched &of(usize cpu);
+
+    Sched(usize cpu, Strong<Task> idle);
+
+    Strong<Task> current();
 
+    // Queues the task on the least loaded cpu.
     Res<> enqueue(Strong<Task> task);
 
+    // Makes a blocked task runnable again so that it re-evaluates
+    // what it's waiting on, does nothing if it isn't blocked.
+    void wake(Task &task);
+
+    void _drop(Task &task);
+
+    // Queues the task according to its state, or drops it if it exited.
+    void _requeue(Task &task, TimeStamp now);
+
     void schedule(TimeSpan span);
 };
 
@@ -16,39 +16,28 @@ Space::Space(Strong<Hal::Vmm> vmm) : _vmm(vmm) {
 
 Space::~Space() {
     while (_maps.len()) {
-        unmap(_maps.peekFront().vrange)
+        unmap(_maps[0].range)
             .unwrap("unmap failed");
     }
 }
 
 Res<usize> Space::_lookup(Hal::VmmRange vrange) {
-    for (usize i = 0; i < _maps.len(); i++) {
-        auto &map = _maps[i];
-        if (map.vrange == vrange) {
-            return Ok(i);
-        }
-    }
+    if (auto id = _maps.lookup(vrange))
+        return Ok(*id);
 
     return Error::invalidInput("no such mapping");
 }
 
 Res<> Space::_ensureNotMapped(Hal::VmmRange vrange) {
-    for (usize i = 0; i < _maps.len(); i++) {
-        auto &map = _maps[i];
-        if (map.vrange.overlaps(vrange)) {
-            return Error::invalidInput("already mapped");
-        }
-    }
+    if (_maps.overlaps(vrange))
+        return Error::invalidInput("already mapped");
 
     return Ok();
 }
 
 Res<> Space::_validate(Hal::VmmRange vrange) {
-    for (auto &map : _maps) {
-        if (map.vrange.contains(vrange)) {
-            return Ok();
-        }
-    }
+    if (_maps.covering(vrange))
+        return Ok();
 
     return Error::invalidInput("bad address");
 }
@@ -75,13 +64,13 @@ Res<Hal::VmmRange> Space::map(Hal::VmmRange vrange, Strong<Vmo> vmo, usize off,
         _alloc.used(vrange);
     }
 
-    Map map = {vrange, off, std::move(vmo)};
+    Map map = {off, std::move(vmo)};
 
     Hal::PmmRange prange = {map.vmo->range().start + map.off, vrange.size};
-    try$(_vmm->mapRange(map.vrange, prange, flags | Hal::VmmFlags::USER));
-    try$(_vmm->flush(map.vrange));
+    try$(_vmm->mapRange(vrange, prange, flags | Hal::VmmFlags::USER));
+    try$(_vmm->flush(vrange));
 
-    _maps.pushBack(std::move(map));
+    try$(_maps.insert(vrange, std::move(map)));
 
     return Ok(vrange);
 }
@@ -92,12 +81,11 @@ Res<> Space::unmap(Hal::VmmRange vrange) {
     try$(vrange.ensureAligned(Hal::PAGE_SIZE));
 
     auto id = try$(_lookup(vrange));
-    auto &map = _maps[id];
 
-    try$(_vmm->free(map.vrange));
-    try$(_vmm->flush(map.vrange));
+    try$(_vmm->free(vrange));
+    try$(_vmm->flush(vrange));
 
-    _alloc.unused(map.vrange);
+    _alloc.unused(vrange);
     _maps.removeAt(id);
     return Ok();
 }
@@ -108,9 +96,8 @@ void Space::activate() {
 
 void Space::dump() {
     ObjectLockScope scope(*this);
-    for (auto &map : _maps) {
-        auto vrange = map.vrange;
-        auto prange = map.prange();
+    for (auto &[vrange, map] : _maps) {
+        auto prange = map.prange(vrange);
         auto size = vrange.size / 1024;
         logDebug("space {}: map: {x}-{x} -> {x}-{x} {} {}kib", id(), vrange.start, vrange.end(), prange.start, prange.end(), map.vmo->label(), size);
     }
@@ -1,6 +1,7 @@
 #pragma once
 
 #include <karm-base/range-alloc.h>
+#include <karm-base/range-map.h>
 
 #include "object.h"
 #include "vmo.h"
@@ -9,18 +10,17 @@ namespace Hjert::Core {
 
 struct Space : public BaseObject<Space, Hj::Type::SPACE> {
     struct Map {
-        Hal::VmmRange vrange;
         usize off;
         Strong<Vmo> vmo;
 
-        Hal::PmmRange prange() {
+        Hal::PmmRange prange(Hal::VmmRange vrange) {
             return vmo->range().slice(off, vrange.size);
         }
     };
 
     Strong<Hal::Vmm> _vmm;
     RangeAlloc<Hal::VmmRange> _alloc;
-    Vec<Map> _maps;
+    RangeMap<Hal::VmmRange, Map> _maps;
 
     static Res<Strong<Space>> create();
 
@@ -16,7 +16,7 @@
 namespace Hjert::Core {
 
 Res<> doNow(Task &self, User<TimeStamp> ts) {
-    return ts.store(self.space(), Sched::instance()._stamp);
+    return ts.store(self.space(), Sched::now());
 }
 
 Res<> doLog(Task &self, UserSlice<char const> msg) {
@@ -187,6 +187,32 @@ Res<> doRecv(Task &self, Hj::Cap cap, User<Hj::Msg> msg, Hj::Cap to) {
     return msg.store(self.space(), try$(obj->recv(*dom)));
 }
 
+Res<> doSendBatch(Task &self, Hj::Cap cap, UserSlice<Hj::Msg const> msgs, User<usize> sent, Hj::Cap from) {
+    auto obj = try$(self.domain().get<Channel>(cap));
+    auto dom = try$(self.domain().get<Domain>(from));
+
+    usize n = 0;
+    try$(msgs.with<Slice<Hj::Msg>>(self.space(), [&](Slice<Hj::Msg> msgs) -> Res<> {
+        n = try$(obj->sendBatch(*dom, msgs));
+        return Ok();
+    }));
+
+    return sent.store(self.space(), n);
+}
+
+Res<> doRecvBatch(Task &self, Hj::Cap cap, UserSlice<Hj::Msg> msgs, User<usize> received, Hj::Cap to) {
+    auto obj = try$(self.domain().get<Channel>(cap));
+    auto dom = try$(self.domain().get<Domain>(to));
+
+    usize n = 0;
+    try$(msgs.with<MutSlice<Hj::Msg>>(self.space(), [&](MutSlice<Hj::Msg> msgs) -> Res<> {
+        n = try$(obj->recvBatch(*dom, msgs));
+        return Ok();
+    }));
+
+    return received.store(self.space(), n);
+}
+
 Res<> doClose(Task &self, Hj::Cap cap) {
     auto obj = try$(self.domain().get<Channel>(cap));
     return obj->close();
@@ -212,12 +238,16 @@ Res<> doListen(Task &self, Hj::Cap cap, Hj::Cap target, Flags<Hj::Sigs> set, Fla
 Res<> doPoll(Task &self, Hj::Cap cap, UserSlice<Hj::Event> events, User<usize> evLen, TimeStamp deadline) {
     auto obj = try$(self.domain().get<Listener>(cap));
 
-    try$(self.block([&]() {
-        auto events = obj->poll();
-        if (events.len() > 0)
+    obj->wait(Sched::instance().current());
+    auto res = self.block([&]() {
+        if (obj->pending())
             return TimeStamp::epoch();
         return deadline;
-    }));
+    });
+    obj->wait(NONE);
+    try$(res);
+
+    obj->poll(events.len());
 
     ObjectLockScope lock{*obj};
     auto l = min(events.len(), obj->events().len());
@@ -289,6 +319,12 @@ Res<> dispatchSyscall(Task &self, Hj::Syscall id, Hj::Args args) {
     case Hj::Syscall::POLL:
         return doPoll(self, Hj::Cap{args[0]}, {args[1], args[2]}, args[3], args[4]);
 
+    case Hj::Syscall::SEND_BATCH:
+        return doSendBatch(self, Hj::Cap{args[0]}, {args[1], args[2]}, args[3], Hj::Cap{args[4]});
+
+    case Hj::Syscall::RECV_BATCH:
+        return doRecvBatch(self, Hj::Cap{args[0]}, {args[1], args[2]}, args[3], Hj::Cap{args[4]});
+
     default:
         return Error::invalidInput("invalid syscall id");
     }
@@ -30,6 +30,7 @@ Task::Task(Mode mode,
       _stack(std::move(stack)),
       _space(space),
       _domain(domain) {
+    _run.prio = Sched::DEFAULT_PRIO;
 }
 
 Res<> Task::ensure(Hj::Pledge pledge) {
@@ -79,7 +80,9 @@ State Task::eval(TimeStamp now) {
         return State::EXITED;
 
     if (_block) {
-        if ((*_block)() == now) {
+        auto until = (*_block)();
+        if (until > now) {
+            _run.deadline = until;
             return State::BLOCKED;
         }
         _block = NONE;
@@ -88,6 +91,10 @@ State Task::eval(TimeStamp now) {
     return State::RUNNABLE;
 }
 
+void Task::_wake() {
+    Sched::instance().wake(*this);
+}
+
 void Task::save(Arch::Frame const &frame) {
     (*_ctx)->save(frame);
 }
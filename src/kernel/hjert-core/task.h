@@ -1,6 +1,7 @@
 #pragma once
 
 #include <karm-base/func.h>
+#include <karm-base/run-queue.h>
 
 #include "ctx.h"
 #include "object.h"
@@ -32,7 +33,8 @@ struct Task :
 
     Flags<Hj::Pledge> _pledges = Hj::Pledge::ALL;
 
-    TimeStamp _sliceEnd = 0;
+    RunNode<Task> _run;
+    usize _slot = 0;
 
     static Res<Strong<Task>> create(
         Mode mode,
@@ -74,6 +76,8 @@ struct Task :
 
     State eval(TimeStamp now);
 
+    void _wake() override;
+
     void end(TimeStamp now);
 
     void save(Arch::Frame const &frame);
@@ -243,6 +243,10 @@ extern "C" usize _sysDispatch(usize sp) {
 static x86_64::Pml<4> *_kpml4 = nullptr;
 static Opt<x86_64::Vmm<Hal::UpperHalfMapper>> _vmm = NONE;
 
+static usize _maxHugeLevel() {
+    return x86_64::Cpuid::hasHuge1g() ? 3 : 2;
+}
+
 Hal::Vmm &vmm() {
     if (_vmm == NONE) {
         auto pml4Mem = Core::kmm()
@@ -252,6 +256,7 @@ Hal::Vmm &vmm() {
         _kpml4 = pml4Mem.as<x86_64::Pml<4>>();
         _vmm = x86_64::Vmm<Hal::UpperHalfMapper>{
             Core::pmm(), _kpml4};
+        _vmm->_hugeLevel = _maxHugeLevel();
     }
 
     return *_vmm;
@@ -259,7 +264,9 @@ Hal::Vmm &vmm() {
 
 struct UserVmm : public x86_64::Vmm<Hal::UpperHalfMapper> {
     UserVmm(x86_64::Pml<4> *pml4)
-        : x86_64::Vmm<Hal::UpperHalfMapper>{Core::pmm(), pml4} {}
+        : x86_64::Vmm<Hal::UpperHalfMapper>{Core::pmm(), pml4} {
+        _hugeLevel = _maxHugeLevel();
+    }
 
     ~UserVmm() {
         // NOTE: We expect the user to already have unmapped all the pages
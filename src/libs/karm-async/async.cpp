@@ -28,42 +28,198 @@ void Loop::_move(Sink &from, Sink *to) {
 
 void Loop::_bind(Source &source, Sink &sink) {
     _sources.emplaceBack(&source, &sink);
+    _queue(_sources.len() - 1, TimeStamp::epoch());
 }
 
 void Loop::_move(Source &from, Source *to) {
     for (auto &s : _sources) {
         if (s.source == &from) {
             s.source = to;
+
+            if (not to and s.handle) {
+                auto handle = *s.handle;
+                s.handle = NONE;
+                (void)_rearm(handle);
+            }
+        }
+    }
+}
+
+void Loop::_signal(Source &source) {
+    for (usize i = 0; i < _sources.len(); i++) {
+        if (_sources[i].source == &source) {
+            _queue(i, TimeStamp::epoch());
+        }
+    }
+}
+
+/* --- Deadlines --- */
+
+void Loop::_queue(usize index, TimeStamp deadline) {
+    auto &s = _sources[index];
+    s.deadline = deadline;
+    s.seq = ++_seq;
+
+    // NOTE: Sources waiting for the end of time are only polled
+    //       again once signaled, they don't need to be in the heap.
+    if (deadline.isEndOfTime())
+        return;
+
+    _due.pushBack({deadline, index, s.seq});
+    _up(_due.len() - 1);
+}
+
+bool Loop::_stale(Due const &due) const {
+    return due.index >= _sources.len() or
+           _sources[due.index].seq != due.seq;
+}
+
+void Loop::_up(usize i) {
+    while (i > 0 and _due[i].deadline < _due[(i - 1) / 2].deadline) {
+        std::swap(_due[i], _due[(i - 1) / 2]);
+        i = (i - 1) / 2;
+    }
+}
+
+void Loop::_down(usize i) {
+    while (true) {
+        usize best = i;
+        usize l = 2 * i + 1;
+        usize r = 2 * i + 2;
+
+        if (l < _due.len() and _due[l].deadline < _due[best].deadline)
+            best = l;
+        if (r < _due.len() and _due[r].deadline < _due[best].deadline)
+            best = r;
+        if (best == i)
+            return;
+
+        std::swap(_due[i], _due[best]);
+        i = best;
+    }
+}
+
+Loop::Due Loop::_pop() {
+    auto first = _due[0];
+    auto last = _due.popBack();
+    if (_due.len()) {
+        _due[0] = last;
+        _down(0);
+    }
+    return first;
+}
+
+/* --- Handles --- */
+
+Res<> Loop::_watch(Source &source, usize handle, Interest interest) {
+    for (auto &s : _sources) {
+        if (s.source != &source)
+            continue;
+
+        auto old = s.handle;
+        s.handle = handle;
+        s.interest = interest;
+
+        if (old and *old != handle)
+            (void)_rearm(*old);
+
+        auto res = _rearm(handle);
+        if (not res) {
+            s.handle = NONE;
+            (void)_rearm(handle);
         }
+        return res;
+    }
+
+    return Error::invalidInput("source is not bound");
+}
+
+// Several sources might watch the same handle, it's armed for all
+// of their interests until the last one of them goes away.
+Res<> Loop::_rearm(usize handle) {
+    usize watchers = 0;
+    Interest interest = Interest::NONE;
+    for (auto &s : _sources) {
+        if (s.source and s.handle and *s.handle == handle) {
+            watchers++;
+            interest |= s.interest;
+        }
+    }
+
+    if (not watchers) {
+        _disarm(handle);
+        return Ok();
+    }
+
+    return _arm(handle, interest);
+}
+
+void Loop::_ready(usize handle, Interest interest) {
+    for (auto &s : _sources) {
+        if (not s.handle or *s.handle != handle or not s.source or not s.sink)
+            continue;
+
+        auto mine = interest & s.interest;
+        if (mine != Interest::NONE)
+            _post(*s.sink, makeEvent<ReadyEvent>(Propagation::NONE, mine));
     }
 }
 
 /* --- Public --- */
 
 void Loop::_collect() {
+    usize len = _sources.len();
     for (usize i = 0; i < _sources.len(); i++) {
-        auto [source, sink] = _sources[i];
-        if (not source or not sink) {
+        auto const &s = _sources[i];
+        if (not s.source or not s.sink) {
             _sources.removeAt(i--);
         }
     }
+
+    if (_sources.len() == len)
+        return;
+
+    // NOTE: Removing bindings shifted the ones after them,
+    //       rebuild the heap with their new indices.
+    _due.clear();
+    for (usize i = 0; i < _sources.len(); i++)
+        _queue(i, _sources[i].deadline);
 }
 
 Res<TimeStamp> Loop::poll() {
-    TimeStamp until = TimeStamp::endOfTime();
+    TimeStamp n = now();
 
-    for (usize i = 0; i < _sources.len(); i++) {
-        auto [source, sink] = _sources[i];
+    // NOTE: Take the due sources out of the heap first, the ones
+    //       bound or signaled while polling wait for the next round.
+    Vec<usize> due;
+    while (_due.len() and _due[0].deadline <= n) {
+        auto d = _pop();
+        if (not _stale(d))
+            due.pushBack(d.index);
+    }
+
+    for (usize i = 0; i < due.len(); i++) {
+        // NOTE: Sources may bind new sources while being polled,
+        //       so we can't hold a reference into _sources here.
+        auto *source = _sources[due[i]].source;
+        auto *sink = _sources[due[i]].sink;
         if (not source or not sink)
             continue;
 
-        auto ts = try$(source->poll(*sink));
+        auto deadline = source->poll(*sink);
+        if (not deadline) {
+            for (usize j = i; j < due.len(); j++)
+                _queue(due[j], TimeStamp::epoch());
+            return deadline.none();
+        }
 
-        if (ts < until)
-            until = ts;
+        _queue(due[i], deadline.take());
     }
 
-    return Ok(until);
+    while (_due.len() and _stale(_due[0]))
+        _pop();
+
+    return Ok(_due.len() ? _due[0].deadline : TimeStamp::endOfTime());
 }
 
 Res<usize> Loop::dispatch() {
@@ -104,7 +260,7 @@ Res<> Loop::run() {
         if (_ret) {
             auto ret = *_ret;
             _ret = NONE;
-            return *_ret;
+            return ret;
         }
 
         try$(wait(until));
@@ -1,6 +1,7 @@
 #pragma once
 
 #include <karm-base/box.h>
+#include <karm-base/enum.h>
 #include <karm-base/func.h>
 #include <karm-base/res.h>
 #include <karm-base/time.h>
@@ -112,6 +113,20 @@ Box<Event> makeEvent(Propagation propagation, Args &&...args) {
 struct Sink;
 struct Source;
 
+enum struct Interest : u8 {
+    NONE = 0,
+    READ = (1 << 0),
+    WRITE = (1 << 1),
+};
+
+FlagsEnum$(Interest);
+
+// Posted by the loop to the sink of a source watching
+// a handle when the handle becomes ready.
+struct ReadyEvent {
+    Interest interest;
+};
+
 struct Loop : public Meta::Static {
     struct Queued {
         Sink *sink;
@@ -121,6 +136,22 @@ struct Loop : public Meta::Static {
     struct Binding {
         Source *source;
         Sink *sink;
+
+        // The source is only polled again once its deadline
+        // is reached, signaling it moves the deadline to now.
+        TimeStamp deadline = TimeStamp::epoch();
+        usize seq = 0;
+
+        Opt<usize> handle = NONE;
+        Interest interest = Interest::NONE;
+    };
+
+    // An entry of the deadline heap, it's stale once its
+    // binding was queued again under another sequence number.
+    struct Due {
+        TimeStamp deadline;
+        usize index;
+        usize seq;
     };
 
     virtual ~Loop() = default;
@@ -128,6 +159,8 @@ struct Loop : public Meta::Static {
     Opt<Res<>> _ret;
     Vec<Queued> _queued;
     Vec<Binding> _sources;
+    Vec<Due> _due;
+    usize _seq = 0;
 
     /* --- Sink --- */
 
@@ -141,6 +174,36 @@ struct Loop : public Meta::Static {
 
     void _move(Source &from, Source *to);
 
+    void _signal(Source &source);
+
+    /* --- Deadlines --- */
+
+    void _queue(usize index, TimeStamp deadline);
+
+    bool _stale(Due const &due) const;
+
+    void _up(usize i);
+
+    void _down(usize i);
+
+    Due _pop();
+
+    /* --- Handles --- */
+
+    Res<> _watch(Source &source, usize handle, Interest interest);
+
+    Res<> _rearm(usize handle);
+
+    void _ready(usize handle, Interest interest);
+
+    // Waits on the handle for the given interest, replacing
+    // the one it was armed with before, if any.
+    virtual Res<> _arm(usize, Interest) {
+        return Error::notImplemented("loop does not support handles");
+    }
+
+    virtual void _disarm(usize) {}
+
     /* --- Public --- */
 
     void _collect();
@@ -227,7 +290,7 @@ struct Task : public Sink {
     };
 
     struct Promise {
-        Sink *_sink;
+        Sink *_sink = nullptr;
         Task get_return_object() { return {Coro<Promise>::from_promise(*this)}; }
         std::suspend_never initial_suspend() { return {}; }
         std::suspend_always final_suspend() noexcept { return {}; }
@@ -333,6 +396,7 @@ struct Defer : public Source {
 
     void defer() {
         _once = false;
+        loop()._signal(*this);
     }
 
     Res<TimeStamp> poll(Sink &sink) override {
@@ -352,6 +416,35 @@ static inline Awaitable<Defer> defer() {
     return {};
 }
 
+/* --- Watch ---------------------------------------------------------------- */
+
+struct Watch : public Source {
+    Interest _interest;
+    bool _armed = false;
+
+    Watch(Sink &sink, Opt<usize> handle, Interest interest)
+        : Source(sink), _interest(interest) {
+        // NOTE: If the loop can't wait on the handle, report it as
+        //       ready right away and let the I/O operation block instead.
+        if (handle)
+            _armed = loop()._watch(*this, *handle, interest).has();
+    }
+
+    Res<TimeStamp> poll(Sink &sink) override {
+        if (not _armed)
+            loop().post<ReadyEvent>(sink, _interest);
+        return Ok(TimeStamp::endOfTime());
+    }
+};
+
+static inline Watch watch(Sink &sink, Opt<usize> handle, Interest interest) {
+    return {sink, handle, interest};
+}
+
+static inline Awaitable<Watch> ready(Opt<usize> handle, Interest interest) {
+    return {handle, interest};
+}
+
 /* --- Timer ---------------------------------------------------------------- */
 
 struct Timer : public Source {
@@ -0,0 +1,40 @@
+#pragma once
+
+#include <karm-sys/thread.h>
+
+#include "fd.h"
+
+namespace Karm::Async {
+
+// Waits for a value on the event loop instead of blocking the thread.
+template <typename T>
+Task<Res<T>> receive(Sys::Rx<T> rx) {
+    auto &chan = *rx._channel;
+
+    while (true) {
+        if (auto value = chan._queue.tryPop())
+            co_return Ok(value.take());
+
+        auto notifier = chan.notifier();
+        if (not notifier)
+            co_return notifier.none();
+
+        chan._listening.inc();
+        if (auto value = chan._queue.tryPop()) {
+            chan._listening.dec();
+            co_return Ok(value.take());
+        }
+
+        co_await ready(*notifier.unwrap(), Interest::READ);
+        chan._listening.dec();
+
+        // Only the receiver clearing the latch takes the byte, the
+        // others woken with it would block on the empty pipe.
+        if (chan._notified.cmpxchg(true, false)) {
+            Byte b;
+            (void)notifier.unwrap()->read({&b, 1});
+        }
+    }
+}
+
+} // namespace Karm::Async
@@ -0,0 +1,31 @@
+#pragma once
+
+#include <karm-sys/file.h>
+
+#include "async.h"
+
+namespace Karm::Async {
+
+static inline Awaitable<Watch> ready(Sys::Fd &fd, Interest interest) {
+    return {fd.handle(), interest};
+}
+
+static inline Task<Res<usize>> read(Strong<Sys::Fd> fd, MutBytes bytes) {
+    co_await ready(*fd, Interest::READ);
+    co_return fd->read(bytes);
+}
+
+static inline Task<Res<usize>> write(Strong<Sys::Fd> fd, Bytes bytes) {
+    co_await ready(*fd, Interest::WRITE);
+    co_return fd->write(bytes);
+}
+
+static inline Task<Res<usize>> read(Sys::File &file, MutBytes bytes) {
+    return read(file.asFd(), bytes);
+}
+
+static inline Task<Res<usize>> write(Sys::File &file, Bytes bytes) {
+    return write(file.asFd(), bytes);
+}
+
+} // namespace Karm::Async
@@ -0,0 +1,150 @@
+#include "pool.h"
+
+namespace Karm::Async {
+
+static thread_local Pool::Worker *_current = nullptr;
+
+Res<Strong<Pool>> Pool::create(usize workers) {
+    auto pool = makeStrong<Pool>(
+        try$(Sys::Mutex::create()),
+        try$(Sys::CondVar::create())
+    );
+
+    // NOTE: All the workers need to exist before any of them
+    //       starts running, since they steal from each other.
+    for (usize i = 0; i < workers; i++)
+        pool->_workers.pushBack(makeBox<Worker>(&pool.unwrap()));
+
+    for (auto &w : pool->_workers) {
+        auto *self = &pool.unwrap();
+        auto *worker = &*w;
+        w->_thread = try$(Sys::Thread::spawn([self, worker] {
+            self->_work(*worker);
+        }));
+    }
+
+    return Ok(pool);
+}
+
+Pool::~Pool() {
+    _stop.store(true);
+
+    {
+        Sys::MutexScope scope(*_mutex);
+        _cond->broadcast();
+    }
+
+    for (auto &w : _workers)
+        if (w->_thread)
+            (void)(*w->_thread)->join();
+
+    // Whatever was left over is run on the current thread.
+    while (_runOne())
+        ;
+}
+
+void Pool::submit(Job job) {
+    auto *j = new Job(std::move(job));
+    _queued.inc();
+
+    if (auto *self = _self()) {
+        self->_deque.push(j);
+    } else {
+        LockScope scope(_lock);
+        _injected.pushBack(j);
+    }
+
+    _wake();
+}
+
+Pool::Worker *Pool::_self() {
+    if (_current and _current->_pool == this)
+        return _current;
+    return nullptr;
+}
+
+Opt<Pool::Job *> Pool::_take() {
+    auto *self = _self();
+
+    if (self) {
+        if (auto job = self->_deque.pop()) {
+            _queued.dec();
+            return job;
+        }
+    }
+
+    {
+        LockScope scope(_lock);
+        if (_injected.len()) {
+            _queued.dec();
+            return _injected.popBack();
+        }
+    }
+
+    // Spread thieves across victims to limit contention.
+    usize len = _workers.len();
+    usize start = _victim.fetchInc(RELAXED);
+    for (usize i = 0; i < len; i++) {
+        auto &victim = *_workers[(start + i) % len];
+        if (&victim == self)
+            continue;
+
+        if (auto job = victim._deque.steal()) {
+            _queued.dec();
+            return job;
+        }
+    }
+
+    return NONE;
+}
+
+bool Pool::_runOne() {
+    auto job = _take();
+    if (not job)
+        return false;
+
+    (**job)();
+    delete *job;
+    return true;
+}
+
+void Pool::_wake() {
+    if (_sleeping.load() == 0)
+        return;
+
+    Sys::MutexScope scope(*_mutex);
+    _cond->signal();
+}
+
+void Pool::_idle() {
+    Sys::MutexScope scope(*_mutex);
+
+    // NOTE: _sleeping is published before checking _queued while
+    //       submit() does the opposite, so at least one of them
+    //       sees the other and no wakeup is lost.
+    _sleeping.inc();
+    while (_queued.load() == 0 and not _stop.load())
+        _cond->wait(*_mutex);
+    _sleeping.dec();
+}
+
+void Pool::_work(Worker &self) {
+    _current = &self;
+
+    while (not _stop.load()) {
+        if (not _runOne())
+            _idle();
+    }
+
+    _current = nullptr;
+}
+
+static Opt<Strong<Pool>> _pool;
+
+Pool &pool() {
+    if (not _pool)
+        _pool = Pool::create().unwrap("failed to create the default pool");
+    return _pool->unwrap();
+}
+
+} // namespace Karm::Async
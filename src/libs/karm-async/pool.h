@@ -0,0 +1,272 @@
+#pragma once
+
+#include <karm-base/atomic.h>
+#include <karm-base/box.h>
+#include <karm-base/func.h>
+#include <karm-base/lock.h>
+#include <karm-base/rc.h>
+#include <karm-base/vec.h>
+#include <karm-sys/mutex.h>
+#include <karm-sys/thread.h>
+
+#include "async.h"
+
+namespace Karm::Async {
+
+/* --- Steal Deque ---------------------------------------------------------- */
+
+// Chase-Lev work-stealing deque, the owner pushes and pops at the
+// bottom while any other thread can steal from the top.
+template <typename T>
+struct StealDeque : Meta::Static {
+    struct _Ring {
+        usize _cap;
+        Atomic<T> *_buf;
+        _Ring *_prev;
+
+        _Ring(usize cap, _Ring *prev)
+            : _cap(cap), _buf(new Atomic<T>[cap]), _prev(prev) {}
+
+        ~_Ring() {
+            delete[] _buf;
+        }
+
+        T load(isize i) {
+            return _buf[i & (_cap - 1)].load(RELAXED);
+        }
+
+        void store(isize i, T value) {
+            _buf[i & (_cap - 1)].store(value, RELAXED);
+        }
+    };
+
+    Atomic<isize> _top{};
+    Atomic<isize> _bottom{};
+    Atomic<_Ring *> _ring;
+
+    StealDeque(usize cap = 64)
+        : _ring(new _Ring(cap, nullptr)) {}
+
+    ~StealDeque() {
+        auto *ring = _ring.load();
+        while (ring) {
+            auto *prev = ring->_prev;
+            delete ring;
+            ring = prev;
+        }
+    }
+
+    // Owner only.
+    void push(T value) {
+        isize b = _bottom.load(RELAXED);
+        isize t = _top.load(ACQUIRE);
+        auto *ring = _ring.load(RELAXED);
+
+        if (b - t >= (isize)ring->_cap) {
+            // NOTE: Thieves might still be reading from the old ring,
+            //       so it's kept around until the deque is destroyed.
+            auto *grown = new _Ring(ring->_cap * 2, ring);
+            for (isize i = t; i < b; i++)
+                grown->store(i, ring->load(i));
+            _ring.store(grown, RELEASE);
+            ring = grown;
+        }
+
+        ring->store(b, value);
+        memoryBarier(RELEASE);
+        _bottom.store(b + 1, RELAXED);
+    }
+
+    // Owner only.
+    Opt<T> pop() {
+        isize b = _bottom.load(RELAXED) - 1;
+        auto *ring = _ring.load(RELAXED);
+        _bottom.store(b, RELAXED);
+        memoryBarier(SEQ_CST);
+        isize t = _top.load(RELAXED);
+
+        if (t > b) {
+            _bottom.store(b + 1, RELAXED);
+            return NONE;
+        }
+
+        T value = ring->load(b);
+
+        if (t == b) {
+            // Last item, race against thieves for it.
+            bool won = _top.cmpxchg(t, t + 1);
+            _bottom.store(b + 1, RELAXED);
+            if (not won)
+                return NONE;
+        }
+
+        return value;
+    }
+
+    Opt<T> steal() {
+        isize t = _top.load(ACQUIRE);
+        memoryBarier(SEQ_CST);
+        isize b = _bottom.load(ACQUIRE);
+
+        if (t >= b)
+            return NONE;
+
+        T value = _ring.load(ACQUIRE)->load(t);
+        if (not _top.cmpxchg(t, t + 1))
+            return NONE;
+
+        return value;
+    }
+};
+
+/* --- Pool ----------------------------------------------------------------- */
+
+struct Pool : Meta::Static {
+    using Job = Func<void()>;
+
+    struct Worker {
+        Pool *_pool;
+        StealDeque<Job *> _deque{};
+        Opt<Strong<Sys::Thread>> _thread = NONE;
+
+        Worker(Pool *pool) : _pool(pool) {}
+    };
+
+    Vec<Box<Worker>> _workers;
+
+    // Jobs submitted from threads that are not part of the pool.
+    Lock _lock;
+    Vec<Job *> _injected;
+
+    Strong<Sys::Mutex> _mutex;
+    Strong<Sys::CondVar> _cond;
+    Atomic<usize> _queued{};
+    Atomic<usize> _sleeping{};
+    Atomic<usize> _victim{};
+    Atomic<bool> _stop{};
+
+    static Res<Strong<Pool>> create(usize workers = Sys::cpuCount());
+
+    Pool(Strong<Sys::Mutex> mutex, Strong<Sys::CondVar> cond)
+        : _mutex(mutex), _cond(cond) {}
+
+    ~Pool();
+
+    usize len() const {
+        return _workers.len();
+    }
+
+    void submit(Job job);
+
+    /* --- Internal --- */
+
+    Worker *_self();
+
+    Opt<Job *> _take();
+
+    bool _runOne();
+
+    void _wake();
+
+    void _idle();
+
+    void _work(Worker &self);
+
+    // Helps running jobs until all the pending ones are done.
+    void _wait(Atomic<usize> &pending) {
+        while (pending.load() > 0)
+            if (not _runOne())
+                ::Karm::_Embed::relaxe();
+    }
+
+    usize _grain(usize len, usize grain) {
+        if (grain)
+            return grain;
+        return max(1uz, len / (max(1uz, _workers.len()) * 4));
+    }
+
+    /* --- Parallel Algorithms --- */
+
+    // Calls f(i) for i in [0, len) and returns once all the calls completed.
+    void parallelFor(usize len, auto f, usize grain = 0) {
+        if (len == 0)
+            return;
+
+        grain = _grain(len, grain);
+        Atomic<usize> pending = (len + grain - 1) / grain;
+
+        for (usize start = 0; start < len; start += grain) {
+            usize end = min(start + grain, len);
+            submit([&f, &pending, start, end] {
+                for (usize i = start; i < end; i++)
+                    f(i);
+                pending.dec();
+            });
+        }
+
+        _wait(pending);
+    }
+
+    // Folds map(i) for i in [0, len) using reduce, which must be associative.
+    template <typename T>
+    T parallelReduce(usize len, T init, auto map, auto reduce, usize grain = 0) {
+        if (len == 0)
+            return init;
+
+        grain = _grain(len, grain);
+        usize chunks = (len + grain - 1) / grain;
+
+        Vec<T> partials;
+        partials.resize(chunks, init);
+        Atomic<usize> pending = chunks;
+
+        for (usize c = 0; c < chunks; c++) {
+            usize start = c * grain;
+            usize end = min(start + grain, len);
+            submit([&map, &reduce, &partials, &pending, c, start, end] {
+                T acc = map(start);
+                for (usize i = start + 1; i < end; i++)
+                    acc = reduce(acc, map(i));
+                partials[c] = acc;
+                pending.dec();
+            });
+        }
+
+        _wait(pending);
+
+        T result = init;
+        for (auto &p : partials)
+            result = reduce(result, p);
+        return result;
+    }
+
+    /* --- Coroutines --- */
+
+    struct _Schedule {
+        Pool &_pool;
+
+        constexpr bool await_ready() const noexcept {
+            return false;
+        }
+
+        void await_suspend(Coro<> coro) {
+            _pool.submit([coro] {
+                coro.resume();
+            });
+        }
+
+        void await_resume() const noexcept {}
+    };
+
+    // Resumes the awaiting coroutine on one of the workers of the pool.
+    // NOTE: The loop is not thread-safe, so until the coroutine
+    //       completes it must not interact with it.
+    _Schedule schedule() {
+        return {*this};
+    }
+};
+
+// The default pool, with one worker per hardware thread.
+Pool &pool();
+
+} // namespace Karm::Async
@@ -0,0 +1,54 @@
+#include <karm-async/fd.h>
+#include <karm-sys/pipe.h>
+#include <karm-test/macros.h>
+
+namespace Karm::Async::Tests {
+
+static constexpr usize PIPES = 256;
+static constexpr usize ROUNDS = 16;
+
+// Echoes whatever comes in on one end of the pipe back out of the
+// other, like a server would for each of its clients.
+static Task<> _serve(Sys::Pipe request, Sys::Pipe response) {
+    for (usize i = 0; i < ROUNDS; i++) {
+        u8 byte;
+        auto r = co_await read(request.in(), {&byte, 1});
+        if (not r or r.unwrap() != 1)
+            co_return Ok();
+        co_await write(response.out(), {&byte, 1});
+    }
+    co_return Ok();
+}
+
+static Task<> _client(Sys::Pipe request, Sys::Pipe response) {
+    for (usize i = 0; i < ROUNDS; i++) {
+        u8 byte = i;
+        co_await write(request.out(), {&byte, 1});
+        co_await read(response.in(), {&byte, 1});
+    }
+    co_return Ok();
+}
+
+// A loop serving many pipes at once, each with a request waiting on
+// one side and a response on the other.
+bench$(fdServePipes) {
+    Vec<Sys::Pipe> requests;
+    Vec<Sys::Pipe> responses;
+    for (usize i = 0; i < PIPES; i++) {
+        requests.pushBack(Sys::Pipe::create().unwrap());
+        responses.pushBack(Sys::Pipe::create().unwrap());
+    }
+
+    b.items(PIPES * ROUNDS);
+    b.run([&] {
+        Vec<Task<>> tasks;
+        tasks.ensure(PIPES * 2);
+        for (usize i = 0; i < PIPES; i++) {
+            tasks.emplaceBack(_serve(requests[i], responses[i]));
+            tasks.emplaceBack(_client(requests[i], responses[i]));
+        }
+        loop().run().unwrap();
+    });
+}
+
+} // namespace Karm::Async::Tests
@@ -0,0 +1,47 @@
+#include <karm-async/pool.h>
+#include <karm-test/macros.h>
+
+namespace Karm::Async::Tests {
+
+static constexpr usize LEN = 1 << 16;
+
+// A reduction heavy enough per item for the pool to pay off,
+// measured for how it scales with the number of workers.
+static void _benchReduce(Bencher &b, usize workers) {
+    auto p = Pool::create(workers).unwrap();
+
+    b.items(LEN);
+    b.run([&] {
+        auto sum = p->parallelReduce<u64>(
+            LEN, 0,
+            [](usize i) {
+                u64 x = i;
+                for (usize j = 0; j < 64; j++)
+                    x = x * 6364136223846793005ull + 1442695040888963407ull;
+                return x;
+            },
+            [](u64 a, u64 b) {
+                return a ^ b;
+            }
+        );
+        doNotOptimize(sum);
+    });
+}
+
+bench$(poolReduce1) {
+    _benchReduce(b, 1);
+}
+
+bench$(poolReduce2) {
+    _benchReduce(b, 2);
+}
+
+bench$(poolReduce4) {
+    _benchReduce(b, 4);
+}
+
+bench$(poolReduce8) {
+    _benchReduce(b, 8);
+}
+
+} // namespace Karm::Async::Tests
@@ -0,0 +1,83 @@
+#include <karm-async/fd.h>
+#include <karm-sys/pipe.h>
+#include <karm-test/macros.h>
+
+namespace Karm::Async::Tests {
+
+static usize _transferred = 0;
+
+Task<> pipeRoundTrip(Sys::Pipe pipe, usize rounds) {
+    for (usize i = 0; i < rounds; i++) {
+        u8 byte = i;
+        auto w = co_await write(pipe.out(), {&byte, 1});
+        auto r = co_await read(pipe.in(), {&byte, 1});
+
+        if (w and r and r.unwrap() == 1 and byte == (u8)i)
+            _transferred++;
+    }
+    co_return Ok();
+}
+
+test$(asyncManyPipes) {
+    static constexpr usize PIPES = 64;
+    static constexpr usize ROUNDS = 16;
+
+    _transferred = 0;
+
+    Vec<Task<>> tasks;
+    tasks.ensure(PIPES);
+    for (usize i = 0; i < PIPES; i++) {
+        auto pipe = try$(Sys::Pipe::create());
+        tasks.emplaceBack(pipeRoundTrip(pipe, ROUNDS));
+    }
+
+    try$(loop().run());
+    expectEq$(_transferred, PIPES * ROUNDS);
+
+    return Ok();
+}
+
+// Remembers what the loop reported as ready.
+struct ReadySink : public Sink {
+    Interest ready = Interest::NONE;
+
+    Res<> post(Event &e) override {
+        if (auto *r = e.is<ReadyEvent>())
+            ready |= r->interest;
+        return Ok();
+    }
+};
+
+static Res<> _step() {
+    try$(loop().poll());
+    try$(loop().wait(loop().now() + TimeSpan::fromMSecs(50)));
+    try$(loop().dispatch());
+    return Ok();
+}
+
+test$(asyncSharedHandle) {
+    auto pipe = try$(Sys::Pipe::create());
+    auto handle = pipe.out()->handle();
+
+    // The write end of a pipe is writable but never readable,
+    // each watcher only hears about what it asked for.
+    ReadySink writer;
+    auto w = watch(writer, handle, Interest::WRITE);
+    {
+        ReadySink reader;
+        auto r = watch(reader, handle, Interest::READ);
+
+        try$(_step());
+        expect$(writer.ready == Interest::WRITE);
+        expect$(reader.ready == Interest::NONE);
+    }
+
+    // The other watcher going away leaves the handle armed.
+    writer.ready = Interest::NONE;
+    try$(_step());
+    expect$(writer.ready == Interest::WRITE);
+
+    return Ok();
+}
+
+} // namespace Karm::Async::Tests
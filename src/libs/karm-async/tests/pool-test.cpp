@@ -0,0 +1,56 @@
+#include <karm-async/pool.h>
+#include <karm-test/macros.h>
+
+namespace Karm::Async::Tests {
+
+test$(stealDequeOwner) {
+    StealDeque<usize> deque{4};
+
+    for (usize i = 0; i < 100; i++)
+        deque.push(i);
+
+    expectEq$(deque.steal().unwrap(), 0uz);
+
+    for (usize i = 99; i > 0; i--)
+        expectEq$(deque.pop().unwrap(), i);
+
+    expect$(not deque.pop());
+    expect$(not deque.steal());
+
+    return Ok();
+}
+
+test$(poolParallelFor) {
+    auto p = try$(Pool::create(4));
+
+    Vec<usize> out;
+    out.resize(10000, 0);
+    p->parallelFor(out.len(), [&](usize i) {
+        out[i] = i * 2;
+    });
+
+    for (usize i = 0; i < out.len(); i++)
+        expectEq$(out[i], i * 2);
+
+    return Ok();
+}
+
+test$(poolParallelReduce) {
+    auto p = try$(Pool::create(4));
+
+    usize sum = p->parallelReduce<usize>(
+        100000, 0,
+        [](usize i) {
+            return i;
+        },
+        [](usize a, usize b) {
+            return a + b;
+        }
+    );
+
+    expectEq$(sum, 100000uz * 99999 / 2);
+
+    return Ok();
+}
+
+} // namespace Karm::Async::Tests
@@ -6,9 +6,25 @@
 
 namespace Karm {
 
+// Number of trailing zero bits, value must not be zero.
+ALWAYS_INLINE constexpr usize ctz(u64 value) {
+    return __builtin_ctzll(value);
+}
+
+// Number of leading zero bits, value must not be zero.
+ALWAYS_INLINE constexpr usize clz(u64 value) {
+    return __builtin_clzll(value);
+}
+
+ALWAYS_INLINE constexpr usize popcnt(u64 value) {
+    return __builtin_popcountll(value);
+}
+
 using BitsRange = Range<usize, struct BitsRangeTag>;
 
 struct Bits {
+    static constexpr usize WORD = 64;
+
     u8 *_buf{};
     usize _len{};
 
@@ -29,9 +45,21 @@ struct Bits {
     }
 
     void set(BitsRange range, bool value) {
-        for (usize i = range.start; i < range.end(); i++) {
-            set(i, value);
+        usize i = range.start;
+        usize end = range.end();
+
+        while (i < end and i % 8)
+            set(i++, value);
+
+        // Whole bytes in the middle.
+        if (end - i >= 8) {
+            usize bytes = (end - i) / 8;
+            memset(_buf + i / 8, value ? 0xff : 0x00, bytes);
+            i += bytes * 8;
         }
+
+        while (i < end)
+            set(i++, value);
     }
 
     void fill(bool value) {
@@ -42,33 +70,115 @@ struct Bits {
         return _len * 8;
     }
 
-    Opt<BitsRange> alloc(usize count, usize start, bool upper = true) {
-        start = min(start, len());
+    /* --- Word Access --- */
+
+    // Load the 64 bits starting at index w * WORD, bits past the
+    // end of the buffer read as `pad`.
+    u64 _word(usize w, bool pad) const {
+        usize off = w * 8;
+        if (off + 8 <= _len) {
+            u64 word;
+            memcpy(&word, _buf + off, 8);
+            return word;
+        }
 
-        if (_len == 0) {
+        u64 word = pad ? ~0ull : 0;
+        memcpy(&word, _buf + off, _len - off);
+        return word;
+    }
+
+    // Index of the first bit equal to value at or after index,
+    // or len() if there is none.
+    usize findNext(usize index, bool value) const {
+        if (index >= len())
+            return len();
+
+        usize w = index / WORD;
+        u64 word = _word(w, not value);
+        if (not value)
+            word = ~word;
+        word &= ~0ull << (index % WORD);
+
+        while (true) {
+            if (word)
+                return min(w * WORD + ctz(word), len());
+
+            if (++w * WORD >= len())
+                return len();
+
+            word = _word(w, not value);
+            if (not value)
+                word = ~word;
+        }
+    }
+
+    // Index of the last bit equal to value strictly before index,
+    // or NONE if there is none.
+    Opt<usize> findPrev(usize index, bool value) const {
+        index = min(index, len());
+        if (index == 0)
             return NONE;
+
+        usize last = index - 1;
+        usize w = last / WORD;
+        u64 word = _word(w, not value);
+        if (not value)
+            word = ~word;
+        if (last % WORD != WORD - 1)
+            word &= (1ull << (last % WORD + 1)) - 1;
+
+        while (true) {
+            if (word)
+                return w * WORD + (WORD - 1 - clz(word));
+
+            if (w-- == 0)
+                return NONE;
+
+            word = _word(w, not value);
+            if (not value)
+                word = ~word;
         }
+    }
+
+    /* --- Allocation --- */
 
-        BitsRange range = {};
+    // Find and set `count` contiguous clear bits. Lower allocations
+    // search forward from `start`, upper ones search backward from
+    // `start` (exclusive) and return the highest fitting range.
+    Opt<BitsRange> alloc(usize count, usize start, bool upper = true) {
+        start = min(start, len());
 
-        for (usize i = start;
-             upper ? i > 0 : i < len();
-             i += upper ? -1 : 1) {
+        if (_len == 0 or count == 0)
+            return NONE;
 
-            if (get(i)) {
-                range = {};
-            } else {
-                if (range.size == 0 or upper) {
-                    range.start = i;
+        if (upper) {
+            usize end = start;
+            while (auto last = findPrev(end, false)) {
+                usize first = 0;
+                if (auto used = findPrev(*last, true))
+                    first = *used + 1;
+
+                if (*last + 1 - first >= count) {
+                    BitsRange range = {*last + 1 - count, count};
+                    set(range, true);
+                    return range;
                 }
 
-                range.size++;
+                end = first;
             }
 
-            if (range.size == count) {
+            return NONE;
+        }
+
+        usize i = start;
+        while ((i = findNext(i, false)) < len()) {
+            usize end = findNext(i, true);
+            if (end - i >= count) {
+                BitsRange range = {i, count};
                 set(range, true);
                 return range;
             }
+            i = end;
         }
 
         return NONE;
@@ -76,32 +186,19 @@ struct Bits {
 
     usize used() const {
         usize res = 0;
-
-        for (usize i = 0; i < len(); i++) {
-            if (get(i)) {
-                res++;
-            }
-        }
-
+        usize words = (len() + WORD - 1) / WORD;
+        for (usize w = 0; w < words; w++)
+            res += popcnt(_word(w, false));
         return res;
     }
 
+    // Calls cb for each run of clear bits.
     void visit(auto cb) {
-        BitsRange range = {};
-        for (usize i = 0; i < len(); i++) {
-            if (get(i)) {
-                if (range.size > 0) {
-                    cb(range);
-                }
-
-                range = {};
-            } else {
-                if (range.size == 0) {
-                    range.start = i;
-                }
-
-                range.size++;
-            }
+        usize i = 0;
+        while ((i = findNext(i, false)) < len()) {
+            usize end = findNext(i, true);
+            cb(BitsRange::fromStartEnd(i, end));
+            i = end;
         }
     }
 
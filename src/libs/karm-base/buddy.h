@@ -0,0 +1,233 @@
+#pragma once
+
+#include "bits.h"
+
+namespace Karm {
+
+// A binary buddy allocator over a range of units (usually pages).
+// Free blocks of 2^k units are kept in one free list per order and
+// flagged in a per-order bitmap, so finding a block, its buddy and
+// coalescing on free are all O(1) per order. The bookkeeping lives in
+// a caller provided buffer, see metaSize().
+struct Buddy {
+    static constexpr usize ORDERS = 32;
+    static constexpr u32 NIL = ~0u;
+
+    struct _Link {
+        u32 next;
+        u32 prev;
+    };
+
+    usize _len;
+    _Link *_links;
+    Bits _map;
+    usize _offsets[ORDERS]{};
+    u32 _heads[ORDERS];
+    u64 _nonEmpty = 0;
+    usize _free = 0;
+
+    static constexpr usize _mapBits(usize len) {
+        usize bits = 0;
+        for (usize k = 0; k < ORDERS; k++)
+            bits += (len + (1uz << k) - 1) >> k;
+        return bits;
+    }
+
+    // The number of bytes of bookkeeping needed to manage `len` units.
+    static constexpr usize metaSize(usize len) {
+        return len * sizeof(_Link) + alignUp(_mapBits(len), 8) / 8;
+    }
+
+    // Every unit starts out used, call free() on the usable ranges.
+    Buddy(MutBytes meta, usize len)
+        : _len(len),
+          _links(reinterpret_cast<_Link *>(meta.buf())),
+          _map(MutSlice<u8>{
+              reinterpret_cast<u8 *>(meta.buf() + len * sizeof(_Link)),
+              alignUp(_mapBits(len), 8) / 8,
+          }) {
+        if (meta.len() < metaSize(len))
+            panic("buddy: metadata buffer too small");
+
+        usize off = 0;
+        for (usize k = 0; k < ORDERS; k++) {
+            _offsets[k] = off;
+            off += (len + (1uz << k) - 1) >> k;
+            _heads[k] = NIL;
+        }
+
+        _map.fill(false);
+    }
+
+    usize len() const {
+        return _len;
+    }
+
+    // Number of free units.
+    usize available() const {
+        return _free;
+    }
+
+    /* --- Free Lists --- */
+
+    bool _isFree(usize i, usize k) const {
+        return _map.get(_offsets[k] + (i >> k));
+    }
+
+    void _push(usize i, usize k) {
+        _links[i] = {_heads[k], NIL};
+        if (_heads[k] != NIL)
+            _links[_heads[k]].prev = i;
+        _heads[k] = i;
+
+        _map.set(_offsets[k] + (i >> k), true);
+        _nonEmpty |= 1ull << k;
+        _free += 1uz << k;
+    }
+
+    void _remove(usize i, usize k) {
+        auto link = _links[i];
+        if (link.prev != NIL)
+            _links[link.prev].next = link.next;
+        else
+            _heads[k] = link.next;
+
+        if (link.next != NIL)
+            _links[link.next].prev = link.prev;
+
+        if (_heads[k] == NIL)
+            _nonEmpty &= ~(1ull << k);
+
+        _map.set(_offsets[k] + (i >> k), false);
+        _free -= 1uz << k;
+    }
+
+    // The free block containing the unit, as {start, order}.
+    Opt<Cons<usize>> _find(usize i) const {
+        for (usize k = 0; k < ORDERS; k++) {
+            usize head = i & ~((1uz << k) - 1);
+            if (head + (1uz << k) > _len)
+                break;
+            if (_isFree(head, k))
+                return Cons<usize>{head, k};
+        }
+        return NONE;
+    }
+
+    // The largest order of a block starting at i that fits in len units.
+    static usize _order(usize i, usize len) {
+        usize k = Bits::WORD - 1 - clz(len);
+        if (i)
+            k = min(k, ctz(i));
+        return min(k, ORDERS - 1);
+    }
+
+    void _release(usize i, usize k) {
+        while (k + 1 < ORDERS) {
+            usize buddy = i ^ (1uz << k);
+            if (buddy + (1uz << k) > _len or not _isFree(buddy, k))
+                break;
+
+            _remove(buddy, k);
+            i = min(i, buddy);
+            k++;
+        }
+
+        _push(i, k);
+    }
+
+    /* --- Allocation --- */
+
+    Opt<BitsRange> alloc(usize count) {
+        if (count == 0 or count > (1uz << (ORDERS - 1)))
+            return NONE;
+
+        usize k = count == 1 ? 0 : Bits::WORD - clz(count - 1);
+        u64 candidates = _nonEmpty & (~0ull << k);
+        if (not candidates)
+            return NONE;
+
+        usize j = ctz(candidates);
+        usize i = _heads[j];
+        _remove(i, j);
+
+        // Split down to the requested order, handing
+        // the upper halves back to their free lists.
+        while (j > k) {
+            j--;
+            _push(i + (1uz << j), j);
+        }
+
+        // Give back the tail of non power of two requests.
+        if (count < (1uz << k))
+            free({i + count, (1uz << k) - count});
+
+        return BitsRange{i, count};
+    }
+
+    void free(BitsRange range) {
+        usize i = range.start;
+        usize end = min(range.end(), _len);
+
+        while (i < end) {
+            usize k = _order(i, end - i);
+            _release(i, k);
+            i += 1uz << k;
+        }
+    }
+
+    // Take the units of the range out of the free lists.
+    void used(BitsRange range) {
+        usize i = range.start;
+        usize end = min(range.end(), _len);
+
+        while (i < end) {
+            auto block = _find(i);
+            if (not block) {
+                i++;
+                continue;
+            }
+
+            usize head = block->car;
+            usize size = 1uz << block->cdr;
+            _remove(head, block->cdr);
+
+            if (head < range.start)
+                free(BitsRange::fromStartEnd(head, range.start));
+
+            if (head + size > end)
+                free(BitsRange::fromStartEnd(end, head + size));
+
+            i = head + size;
+        }
+    }
+
+    // Calls cb for each run of free units, in address order.
+    void visit(auto cb) const {
+        Opt<BitsRange> run = NONE;
+        usize i = 0;
+
+        while (i < _len) {
+            auto block = _find(i);
+            if (not block) {
+                if (run)
+                    cb(*run);
+                run = NONE;
+                i++;
+                continue;
+            }
+
+            usize size = 1uz << block->cdr;
+            if (run)
+                run->size += size;
+            else
+                run = BitsRange{i, size};
+            i += size;
+        }
+
+        if (run)
+            cb(*run);
+    }
+};
+
+} // namespace Karm
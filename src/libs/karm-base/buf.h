@@ -119,6 +119,15 @@ struct Buf {
         _cap = cap;
     }
 
+    /// Like `ensure()` but grows the capacity geometrically, so that
+    /// repeated appends only reallocate O(log n) times.
+    void grow(usize cap) {
+        if (cap <= _cap)
+            return;
+
+        ensure(max(cap, _cap * 2, 16uz));
+    }
+
     void fit() {
         if (_len == _cap)
             return;
@@ -135,7 +144,7 @@ struct Buf {
 
     template <typename... Args>
     void emplace(usize index, Args &&...args) {
-        ensure(_len + 1);
+        grow(_len + 1);
 
         for (usize i = _len; i > index; i--) {
             _buf[i].ctor(_buf[i - 1].take());
@@ -145,7 +154,7 @@ struct Buf {
     }
 
     void insert(usize index, T &&value) {
-        ensure(_len + 1);
+        grow(_len + 1);
 
         for (usize i = _len; i > index; i--) {
             _buf[i].ctor(_buf[i - 1].take());
@@ -166,7 +175,7 @@ struct Buf {
     }
 
     void insert(Copy, usize index, T const *first, usize count) {
-        ensure(_len + count);
+        grow(_len + count);
 
         for (usize i = _len; i > index; i--) {
             _buf[i].ctor(_buf[i - count].take());
@@ -180,7 +189,7 @@ struct Buf {
     }
 
     void insert(Move, usize index, T *first, usize count) {
-        ensure(_len + count);
+        grow(_len + count);
 
         for (usize i = _len; i > index; i--) {
             _buf[i].ctor(_buf[i - count].take());
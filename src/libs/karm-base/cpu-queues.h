@@ -0,0 +1,189 @@
+#pragma once
+
+#include "atomic.h"
+#include "clamp.h"
+#include "lock.h"
+#include "run-queue.h"
+
+namespace Karm {
+
+// One run queue per CPU, each behind its own lock so that CPUs don't
+// contend with each other while scheduling. A CPU that runs out of work
+// steals the next task of the busiest other CPU. Tasks remember the CPU
+// they belong to in `_run.cpu`, queuing, waking and removing a task
+// always goes through the queue of that CPU.
+template <typename T, usize PRIOS = 32, usize CPUS = 16>
+struct CpuQueues {
+    struct _Local {
+        Lock lock;
+        RunQueue<T, PRIOS> queue;
+
+        // Mirrors of the queue state that other CPUs
+        // can look at without taking the lock.
+        Atomic<usize> load{};
+        Atomic<bool> idle{};
+        Atomic<usize> steals{};
+    };
+
+    usize _len;
+    _Local _locals[CPUS];
+
+    CpuQueues(usize len = 1)
+        : _len(clamp(len, 1uz, CPUS)) {
+    }
+
+    usize len() const {
+        return _len;
+    }
+
+    // Makes room for more CPUs, they must not be scheduling yet.
+    void resize(usize len) {
+        _len = clamp(len, _len, CPUS);
+    }
+
+    usize load(usize cpu) {
+        return _locals[cpu].load.load(RELAXED);
+    }
+
+    bool idle(usize cpu) {
+        return _locals[cpu].idle.load(RELAXED);
+    }
+
+    usize steals(usize cpu) {
+        return _locals[cpu].steals.load(RELAXED);
+    }
+
+    // The CPU with the fewest ready tasks, where new tasks should go.
+    usize leastLoaded() {
+        usize best = 0;
+        for (usize i = 1; i < _len; i++)
+            if (load(i) < load(best))
+                best = i;
+        return best;
+    }
+
+    /* --- Locking --- */
+
+    void _sync(_Local &local) {
+        local.load.store(local.queue.ready(), RELAXED);
+    }
+
+    // Locks the queue of the CPU the task belongs to. Tasks only move
+    // while their old CPU is locked, so checking again once we hold the
+    // lock is enough to know we got the right one.
+    _Local &_acquire(T &t) {
+        while (true) {
+            usize cpu = __atomic_load_n(&t._run.cpu, RELAXED);
+            auto &local = _locals[cpu];
+            local.lock.acquire();
+            if (t._run.cpu == cpu)
+                return local;
+            local.lock.release();
+        }
+    }
+
+    /* --- Tasks --- */
+
+    void push(T &t) {
+        auto &local = _acquire(t);
+        local.queue.push(t);
+        _sync(local);
+        local.lock.release();
+    }
+
+    // NOTE: Waking a task up and putting it to sleep both happen with
+    //       its cpu locked, so a wake up coming in between the task being
+    //       found blocked and this call is never lost, see RunQueue::wake().
+    bool sleep(T &t, TimeStamp deadline) {
+        auto &local = _acquire(t);
+        bool slept = local.queue.sleep(t, deadline);
+        _sync(local);
+        local.lock.release();
+        return slept;
+    }
+
+    // Returns false if the task wasn't sleeping.
+    bool wake(T &t) {
+        auto &local = _acquire(t);
+        bool woken = local.queue.wake(t);
+        _sync(local);
+        local.lock.release();
+        return woken;
+    }
+
+    void remove(T &t) {
+        auto &local = _acquire(t);
+        local.queue.remove(t);
+        _sync(local);
+        local.lock.release();
+    }
+
+    /* --- Scheduling --- */
+
+    // Moves the tasks of the CPU whose deadline passed back to its
+    // ready queues, returns how many there were.
+    usize expire(usize cpu, TimeStamp now) {
+        auto &local = _locals[cpu];
+        LockScope scope(local.lock);
+
+        usize count = 0;
+        local.queue.expire(now, [&](T &t) {
+            local.queue.push(t);
+            count++;
+        });
+        _sync(local);
+        return count;
+    }
+
+    // Takes the next task of the CPU, without stealing.
+    T *popLocal(usize cpu) {
+        auto &local = _locals[cpu];
+        LockScope scope(local.lock);
+
+        T *t = local.queue.pop();
+        _sync(local);
+        local.idle.store(t == nullptr, RELAXED);
+        return t;
+    }
+
+    // Takes the next task of the busiest other CPU.
+    T *steal(usize cpu) {
+        usize victim = cpu;
+        usize most = 0;
+        for (usize i = 0; i < _len; i++) {
+            if (i != cpu and load(i) > most) {
+                victim = i;
+                most = load(i);
+            }
+        }
+
+        if (victim == cpu)
+            return nullptr;
+
+        auto &from = _locals[victim];
+        LockScope scope(from.lock);
+
+        T *t = from.queue.pop();
+        if (not t)
+            return nullptr;
+
+        _sync(from);
+        __atomic_store_n(&t->_run.cpu, cpu, RELAXED);
+        _locals[cpu].steals.inc(RELAXED);
+        return t;
+    }
+
+    // Takes the next task of the CPU, or steals one if it has none,
+    // returns nullptr if the CPU should go idle.
+    T *pop(usize cpu) {
+        if (T *t = popLocal(cpu))
+            return t;
+
+        T *t = steal(cpu);
+        if (t)
+            _locals[cpu].idle.store(false, RELAXED);
+        return t;
+    }
+};
+
+} // namespace Karm
@@ -112,42 +112,68 @@ struct RwLock : Meta::Static {
     isize _readers{};
     isize _writers{};
 
+    // NOTE: The _try* variants expect the caller to already be in a
+    //       critical section, so that spinning doesn't nest them.
+    bool _tryAcquireRead() {
+        LockScope scope(_lock);
+
+        if (_pendings.load())
+            return false;
+
+        if (_writers)
+            return false;
+
+        ++_readers;
+        return true;
+    }
+
     void acquireRead() {
         _Embed::enterCritical();
 
-        while (not tryAcquireRead()) {
+        while (not _tryAcquireRead()) {
             _Embed::relaxe();
             memoryBarier();
         }
     }
 
     bool tryAcquireRead() {
-        LockScope scope(_lock);
-
-        if (_pendings.load())
-            return false;
+        _Embed::enterCritical();
 
-        if (_writers)
+        if (not _tryAcquireRead()) {
+            _Embed::leaveCritical();
             return false;
+        }
 
-        ++_readers;
-
-        _Embed::enterCritical();
         return true;
     }
 
     void releaseRead() {
-        LockScope scope(_lock);
-        --_readers;
+        {
+            LockScope scope(_lock);
+            --_readers;
+        }
         _Embed::leaveCritical();
     }
 
+    bool _tryAcquireWrite() {
+        LockScope scope(_lock);
+
+        if (_readers)
+            return false;
+
+        if (_writers)
+            return false;
+
+        ++_writers;
+        return true;
+    }
+
     void acquireWrite() {
         _Embed::enterCritical();
 
         _pendings.inc();
 
-        while (not tryAcquireWrite()) {
+        while (not _tryAcquireWrite()) {
             _Embed::relaxe();
             memoryBarier();
         }
@@ -156,22 +182,21 @@ struct RwLock : Meta::Static {
     }
 
     bool tryAcquireWrite() {
-        LockScope scope(_lock);
-
-        if (_readers)
-            return false;
+        _Embed::enterCritical();
 
-        if (_writers)
+        if (not _tryAcquireWrite()) {
+            _Embed::leaveCritical();
             return false;
+        }
 
-        ++_writers;
-        _Embed::enterCritical();
         return true;
     }
 
     void releaseWrite() {
-        LockScope scope(_lock);
-        --_writers;
+        {
+            LockScope scope(_lock);
+            --_writers;
+        }
         _Embed::leaveCritical();
     }
 };
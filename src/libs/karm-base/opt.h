@@ -215,6 +215,8 @@ struct [[nodiscard]] Opt {
     }
 
     ALWAYS_INLINE constexpr bool operator==(Opt const &other) const {
+        if (not _present and not other._present)
+            return true;
         if constexpr (Meta::Equatable<T>)
             if (_present and other._present)
                 return _value == other._value;
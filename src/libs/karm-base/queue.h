@@ -0,0 +1,171 @@
+#pragma once
+
+#include <karm-meta/nocopy.h>
+
+#include "atomic.h"
+#include "inert.h"
+#include "opt.h"
+
+namespace Karm {
+
+/* --- Mpmc Queue ----------------------------------------------------------- */
+
+/// A bounded lock-free multi-producer multi-consumer queue.
+/// Every cell carries a sequence number telling producers and consumers
+/// whose turn it is, so they only contend on the enqueue/dequeue counters.
+/// See: https://www.1024cores.net/home/lock-free-algorithms/queues/bounded-mpmc-queue
+template <typename T>
+struct MpmcQueue : Meta::Static {
+    struct _Cell {
+        Atomic<usize> seq;
+        Inert<T> value;
+    };
+
+    _Cell *_buf;
+    usize _mask;
+
+    // NOTE: Keep producers and consumers on separate cache lines.
+    alignas(64) Atomic<usize> _enqueue{};
+    alignas(64) Atomic<usize> _dequeue{};
+
+    static constexpr usize _roundUp(usize cap) {
+        usize res = 2;
+        while (res < cap)
+            res <<= 1;
+        return res;
+    }
+
+    MpmcQueue(usize cap)
+        : _mask(_roundUp(cap) - 1) {
+        _buf = new _Cell[_mask + 1];
+        for (usize i = 0; i <= _mask; i++)
+            _buf[i].seq.store(i, RELAXED);
+    }
+
+    ~MpmcQueue() {
+        while (tryPop())
+            ;
+        delete[] _buf;
+    }
+
+    usize cap() const {
+        return _mask + 1;
+    }
+
+    /// Returns false if the queue is full, in which case
+    /// `value` is left untouched.
+    bool tryPush(T &&value) {
+        _Cell *cell;
+        usize pos = _enqueue.load(RELAXED);
+
+        while (true) {
+            cell = &_buf[pos & _mask];
+            isize diff = (isize)cell->seq.load(ACQUIRE) - (isize)pos;
+
+            if (diff == 0) {
+                if (_enqueue.cmpxchg(pos, pos + 1))
+                    break;
+                pos = _enqueue.load(RELAXED);
+            } else if (diff < 0) {
+                return false;
+            } else {
+                pos = _enqueue.load(RELAXED);
+            }
+        }
+
+        cell->value.ctor(std::move(value));
+        cell->seq.store(pos + 1, RELEASE);
+        return true;
+    }
+
+    Opt<T> tryPop() {
+        _Cell *cell;
+        usize pos = _dequeue.load(RELAXED);
+
+        while (true) {
+            cell = &_buf[pos & _mask];
+            isize diff = (isize)cell->seq.load(ACQUIRE) - (isize)(pos + 1);
+
+            if (diff == 0) {
+                if (_dequeue.cmpxchg(pos, pos + 1))
+                    break;
+                pos = _dequeue.load(RELAXED);
+            } else if (diff < 0) {
+                return NONE;
+            } else {
+                pos = _dequeue.load(RELAXED);
+            }
+        }
+
+        T value = cell->value.take();
+        cell->seq.store(pos + _mask + 1, RELEASE);
+        return value;
+    }
+};
+
+/* --- Spsc Queue ----------------------------------------------------------- */
+
+/// An unbounded single-producer single-consumer queue made of a linked
+/// list of fixed size segments. The producer only touches the tail
+/// segment and the consumer only frees segments the producer moved past.
+template <typename T, usize N = 64>
+struct SpscQueue : Meta::Static {
+    struct _Segment {
+        Inert<T> slots[N];
+        Atomic<usize> written{};
+        Atomic<_Segment *> next{};
+    };
+
+    _Segment *_head;
+    usize _read = 0;
+
+    _Segment *_tail;
+    usize _write = 0;
+
+    SpscQueue()
+        : _head(new _Segment), _tail(_head) {}
+
+    ~SpscQueue() {
+        while (pop())
+            ;
+
+        while (_head) {
+            auto *next = _head->next.load();
+            delete _head;
+            _head = next;
+        }
+    }
+
+    // Producer only.
+    void push(T value) {
+        if (_write == N) {
+            auto *seg = new _Segment;
+            _tail->next.store(seg, RELEASE);
+            _tail = seg;
+            _write = 0;
+        }
+
+        _tail->slots[_write].ctor(std::move(value));
+        _tail->written.store(++_write, RELEASE);
+    }
+
+    // Consumer only.
+    Opt<T> pop() {
+        if (_read == N) {
+            auto *next = _head->next.load(ACQUIRE);
+            if (not next)
+                return NONE;
+
+            delete _head;
+            _head = next;
+            _read = 0;
+        }
+
+        if (_read >= _head->written.load(ACQUIRE))
+            return NONE;
+
+        return _head->slots[_read++].take();
+    }
+};
+
+} // namespace Karm
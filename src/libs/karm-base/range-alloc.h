@@ -6,84 +6,262 @@
 
 namespace Karm {
 
+// Keeps track of the free parts of an address space. The free ranges
+// live in a treap ordered by start, each node also knows the size of
+// the largest free range below it, so that finding the first range
+// large enough, carving ranges out and coalescing them back are all
+// O(log n) in the number of free ranges.
 template <typename R = USizeRange>
 struct RangeAlloc {
-    Vec<R> _r;
+    static constexpr u32 NIL = ~0u;
 
-    void used(R range) {
-        for (usize i = 0; i < _r.len(); i++) {
-            R curr = _r[i];
+    struct _Node {
+        R range;
+        usize max;
+        u32 prio;
+        u32 left = NIL;
+        u32 right = NIL;
+    };
 
-            if (curr == range) {
-                _r.removeAt(i);
-                break;
-            }
+    Vec<_Node> _nodes;
+    u32 _unused = NIL;
+    u32 _root = NIL;
+    u32 _seed = 0x9e3779b9;
+    usize _len = 0;
 
-            if (curr.overlaps(range)) {
-                R lh = curr.halfUnder(range);
-                R uh = curr.halfOver(range);
-
-                if (lh.size != 0) {
-                    _r[i] = lh;
-
-                    if (uh.size != 0) {
-                        unused(uh);
-                    }
-                } else if (uh.size != 0) {
-                    _r[i] = uh;
-                }
-            }
+    usize len() const {
+        return _len;
+    }
+
+    /* --- Nodes --- */
+
+    u32 _make(R range) {
+        // xorshift, the priorities only need to look random.
+        _seed ^= _seed << 13;
+        _seed ^= _seed >> 17;
+        _seed ^= _seed << 5;
+
+        _Node node = {range, (usize)range.size, _seed};
+        _len++;
+
+        if (_unused != NIL) {
+            u32 n = _unused;
+            _unused = _nodes[n].left;
+            _nodes[n] = node;
+            return n;
         }
+
+        _nodes.pushBack(node);
+        return _nodes.len() - 1;
     }
 
-    Res<R> alloc(usize size) {
-        for (usize i = 0; i < _r.len(); i++) {
-            if (_r[i].size == size) {
-                R result = _r[i];
-                _r.removeAt(i);
-                return Ok(result);
-            }
+    void _drop(u32 n) {
+        _nodes[n].left = _unused;
+        _unused = n;
+        _len--;
+    }
+
+    usize _max(u32 n) const {
+        return n == NIL ? 0 : _nodes[n].max;
+    }
+
+    void _pull(u32 n) {
+        auto &node = _nodes[n];
+        node.max = max((usize)node.range.size, _max(node.left), _max(node.right));
+    }
+
+    // Splits the tree into the nodes starting before addr and the others.
+    Cons<u32> _split(u32 n, usize addr) {
+        if (n == NIL)
+            return {NIL, NIL};
+
+        if ((usize)_nodes[n].range.start < addr) {
+            auto [l, r] = _split(_nodes[n].right, addr);
+            _nodes[n].right = l;
+            _pull(n);
+            return {n, r};
+        }
+
+        auto [l, r] = _split(_nodes[n].left, addr);
+        _nodes[n].left = r;
+        _pull(n);
+        return {l, n};
+    }
+
+    // Joins two trees, every node of a must start before any node of b.
+    u32 _merge(u32 a, u32 b) {
+        if (a == NIL)
+            return b;
+
+        if (b == NIL)
+            return a;
+
+        if (_nodes[a].prio > _nodes[b].prio) {
+            _nodes[a].right = _merge(_nodes[a].right, b);
+            _pull(a);
+            return a;
+        }
+
+        _nodes[b].left = _merge(a, _nodes[b].left);
+        _pull(b);
+        return b;
+    }
+
+    u32 _detach(u32 n) {
+        _nodes[n].left = NIL;
+        _nodes[n].right = NIL;
+        _pull(n);
+        return n;
+    }
+
+    // Detaches the last node of the tree into `last`.
+    u32 _popLast(u32 n, u32 &last) {
+        if (_nodes[n].right == NIL) {
+            u32 res = _nodes[n].left;
+            last = _detach(n);
+            return res;
+        }
+
+        _nodes[n].right = _popLast(_nodes[n].right, last);
+        _pull(n);
+        return n;
+    }
+
+    // Detaches the first node of the tree into `first`.
+    u32 _popFirst(u32 n, u32 &first) {
+        if (_nodes[n].left == NIL) {
+            u32 res = _nodes[n].right;
+            first = _detach(n);
+            return res;
+        }
+
+        _nodes[n].left = _popFirst(_nodes[n].left, first);
+        _pull(n);
+        return n;
+    }
+
+    void _collect(u32 n, Vec<u32> &out) {
+        if (n == NIL)
+            return;
+        _collect(_nodes[n].left, out);
+        out.pushBack(n);
+        _collect(_nodes[n].right, out);
+    }
+
+    // Carves `size` out of the first range large enough.
+    u32 _take(u32 n, usize size, R &out) {
+        auto &node = _nodes[n];
+
+        if (_max(node.left) >= size) {
+            node.left = _take(node.left, size, out);
+            _pull(n);
+            return n;
+        }
 
-            if (_r[i].size > size) {
-                R result = {_r[i].start, size};
-                _r[i].start += size;
-                _r[i].size -= size;
-                return Ok(result);
+        if ((usize)node.range.size >= size) {
+            out = {node.range.start, size};
+            node.range.start += size;
+            node.range.size -= size;
+
+            if (node.range.size == 0) {
+                u32 res = _merge(node.left, node.right);
+                _drop(n);
+                return res;
             }
+
+            _pull(n);
+            return n;
         }
 
-        return Error::outOfMemory();
+        node.right = _take(node.right, size, out);
+        _pull(n);
+        return n;
     }
 
-    void compress(usize start) {
-        while (start + 1 < _r.len() and _r[start].contigous(_r[start + 1])) {
-            _r[start] = _r[start].merge(_r[start + 1]);
-            _r.removeAt(start + 1);
+    /* --- Public --- */
+
+    // Marks the range as allocated.
+    void used(R range) {
+        auto [lower, rest] = _split(_root, range.start);
+
+        // The range right before might run into the used one.
+        if (lower != NIL) {
+            u32 last;
+            lower = _popLast(lower, last);
+            R curr = _nodes[last].range;
+
+            if (curr.overlaps(range)) {
+                _drop(last);
+                if (auto lh = curr.halfUnder(range); lh.size)
+                    lower = _merge(lower, _make(lh));
+                if (auto uh = curr.halfOver(range); uh.size)
+                    rest = _merge(_make(uh), rest);
+            } else {
+                lower = _merge(lower, last);
+            }
         }
 
-        while (start > 0 and _r[start].contigous(_r[start - 1])) {
-            _r[start] = _r[start].merge(_r[start - 1]);
-            _r.removeAt(start - 1);
+        auto [inside, upper] = _split(rest, range.end());
+
+        Vec<u32> nodes;
+        _collect(inside, nodes);
+        for (auto n : nodes) {
+            R curr = _nodes[n].range;
+            _drop(n);
+            if (auto uh = curr.halfOver(range); uh.size)
+                upper = _merge(_make(uh), upper);
         }
+
+        _root = _merge(lower, upper);
     }
 
+    Res<R> alloc(usize size) {
+        if (_max(_root) < size or size == 0)
+            return Error::outOfMemory();
+
+        R res = {};
+        _root = _take(_root, size, res);
+        return Ok(res);
+    }
+
+    // Gives the range back, coalescing it with its neighbours.
     void unused(R range) {
-        for (usize i = 0; i < _r.len(); i++) {
-            if (_r[i].contigous(range)) {
-                _r[i] = _r[i].merge(range);
-                compress(i);
-                return;
+        if (range.size == 0)
+            return;
+
+        auto [lower, upper] = _split(_root, range.start);
+
+        if (lower != NIL) {
+            u32 last;
+            lower = _popLast(lower, last);
+            if (_nodes[last].range.end() == range.start) {
+                range = _nodes[last].range.merge(range);
+                _drop(last);
+            } else {
+                lower = _merge(lower, last);
             }
+        }
 
-            if (i + 1 < _r.len() &&
-                (_r[i].start < range.start) &&
-                (range.start < _r[i + 1].start)) {
-                _r.insert(i + 1, range);
-                return;
+        if (upper != NIL) {
+            u32 first;
+            upper = _popFirst(upper, first);
+            if (_nodes[first].range.start == range.end()) {
+                range = range.merge(_nodes[first].range);
+                _drop(first);
+            } else {
+                upper = _merge(first, upper);
             }
         }
 
-        _r.pushBack(range);
+        _root = _merge(_merge(lower, _make(range)), upper);
+    }
+
+    // Calls cb for each free range, in address order.
+    void visit(auto cb) {
+        Vec<u32> nodes;
+        _collect(_root, nodes);
+        for (auto n : nodes)
+            cb(_nodes[n].range);
     }
 };
 
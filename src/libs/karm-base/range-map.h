@@ -0,0 +1,101 @@
+#pragma once
+
+#include "opt.h"
+#include "range.h"
+#include "res.h"
+#include "vec.h"
+
+namespace Karm {
+
+// Non-overlapping ranges associated with a value, kept sorted by start
+// so that lookups are a binary search. Inserting and removing shift
+// the tail of the vector, which is cheap next to the lookups.
+template <typename R, typename V>
+struct RangeMap {
+    using T = decltype(R{}.start);
+
+    struct Entry {
+        R range;
+        V value;
+    };
+
+    Vec<Entry> _entries;
+
+    // Index of the first entry ending after addr.
+    usize _lowerBound(T addr) const {
+        usize lo = 0;
+        usize hi = _entries.len();
+        while (lo < hi) {
+            usize mid = lo + (hi - lo) / 2;
+            if (_entries[mid].range.end() <= addr)
+                lo = mid + 1;
+            else
+                hi = mid;
+        }
+        return lo;
+    }
+
+    usize len() const {
+        return _entries.len();
+    }
+
+    Entry &operator[](usize i) {
+        return _entries[i];
+    }
+
+    Entry const &operator[](usize i) const {
+        return _entries[i];
+    }
+
+    Entry *begin() {
+        return _entries.buf();
+    }
+
+    Entry *end() {
+        return _entries.buf() + _entries.len();
+    }
+
+    // The entry containing addr.
+    Opt<usize> find(T addr) const {
+        usize i = _lowerBound(addr);
+        if (i < len() and _entries[i].range.contains(addr))
+            return i;
+        return NONE;
+    }
+
+    // The entry with exactly this range.
+    Opt<usize> lookup(R range) const {
+        usize i = _lowerBound(range.start);
+        if (i < len() and _entries[i].range == range)
+            return i;
+        return NONE;
+    }
+
+    // The entry containing the whole range.
+    Opt<usize> covering(R range) const {
+        usize i = _lowerBound(range.start);
+        if (i < len() and _entries[i].range.contains(range))
+            return i;
+        return NONE;
+    }
+
+    bool overlaps(R range) const {
+        usize i = _lowerBound(range.start);
+        return i < len() and _entries[i].range.start < range.end();
+    }
+
+    Res<usize> insert(R range, V value) {
+        if (overlaps(range))
+            return Error::invalidInput("range overlaps");
+
+        usize i = _lowerBound(range.start);
+        _entries.insert(i, Entry{range, std::move(value)});
+        return Ok(i);
+    }
+
+    Entry removeAt(usize i) {
+        return _entries.removeAt(i);
+    }
+};
+
+} // namespace Karm
@@ -105,6 +105,22 @@ struct Cell : public _Cell {
     void *_unwrap() override { return &_buf.unwrap(); }
     Meta::Type<> inspect() override { return Meta::typeOf<T>(); }
     void clear() override { _buf.dtor(); }
+
+    // Types can provide the storage for the cells holding
+    // them by declaring cellAlloc() and cellFree().
+    static void *operator new(usize size) {
+        if constexpr (requires { T::cellAlloc(size); })
+            return T::cellAlloc(size);
+        else
+            return ::operator new(size);
+    }
+
+    static void operator delete(void *ptr, usize size) {
+        if constexpr (requires { T::cellFree(ptr, size); })
+            T::cellFree(ptr, size);
+        else
+            ::operator delete(ptr, size);
+    }
 };
 
 template <typename T>
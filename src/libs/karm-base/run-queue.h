@@ -0,0 +1,220 @@
+#pragma once
+
+#include "bits.h"
+#include "time.h"
+#include "vec.h"
+
+namespace Karm {
+
+template <typename T>
+struct RunNode {
+    static constexpr usize NIL = ~0uz;
+
+    T *next = nullptr;
+    T *prev = nullptr;
+    usize prio = 0;
+    usize cpu = 0;
+    bool ready = false;
+
+    // Woken up while in neither queue, eg. between being found
+    // blocked and being put to sleep, the next sleep() is skipped.
+    bool wakePending = false;
+
+    TimeStamp deadline = TimeStamp::endOfTime();
+    usize heap = NIL;
+};
+
+// The bookkeeping side of a scheduler: one FIFO of runnable tasks per
+// priority level, with a bitmask of the non-empty ones, and a min-heap
+// of sleeping tasks ordered by deadline. Picking the next task is O(1),
+// sleeping and waking up are O(log n), and tasks that are asleep are
+// never looked at before their deadline or an explicit wake().
+//
+// T must have a public `RunNode<T> _run` member.
+template <typename T, usize PRIOS = 32>
+struct RunQueue {
+    static_assert(PRIOS <= 64);
+
+    T *_heads[PRIOS]{};
+    T *_tails[PRIOS]{};
+    u64 _mask = 0;
+    usize _ready = 0;
+    Vec<T *> _sleeping;
+
+    usize ready() const {
+        return _ready;
+    }
+
+    usize sleeping() const {
+        return _sleeping.len();
+    }
+
+    bool isReady(T const &t) const {
+        return t._run.ready;
+    }
+
+    bool isSleeping(T const &t) const {
+        return t._run.heap != RunNode<T>::NIL;
+    }
+
+    /* --- Ready Queues --- */
+
+    // Appends the task to the queue of its priority.
+    void push(T &t) {
+        auto &node = t._run;
+        usize prio = min(node.prio, PRIOS - 1);
+
+        node.next = nullptr;
+        node.prev = _tails[prio];
+        if (_tails[prio])
+            _tails[prio]->_run.next = &t;
+        else
+            _heads[prio] = &t;
+        _tails[prio] = &t;
+
+        node.ready = true;
+        node.wakePending = false;
+        _mask |= 1ull << prio;
+        _ready++;
+    }
+
+    void _unlink(T &t) {
+        auto &node = t._run;
+        usize prio = min(node.prio, PRIOS - 1);
+
+        if (node.prev)
+            node.prev->_run.next = node.next;
+        else
+            _heads[prio] = node.next;
+
+        if (node.next)
+            node.next->_run.prev = node.prev;
+        else
+            _tails[prio] = node.prev;
+
+        if (not _heads[prio])
+            _mask &= ~(1ull << prio);
+
+        node.next = nullptr;
+        node.prev = nullptr;
+        node.ready = false;
+        _ready--;
+    }
+
+    // Takes the first task of the highest non-empty priority.
+    T *pop() {
+        if (not _mask)
+            return nullptr;
+
+        usize prio = Bits::WORD - 1 - clz(_mask);
+        T *t = _heads[prio];
+        _unlink(*t);
+        return t;
+    }
+
+    /* --- Sleep Queue --- */
+
+    bool _before(usize a, usize b) const {
+        return _sleeping[a]->_run.deadline < _sleeping[b]->_run.deadline;
+    }
+
+    void _swap(usize a, usize b) {
+        std::swap(_sleeping[a], _sleeping[b]);
+        _sleeping[a]->_run.heap = a;
+        _sleeping[b]->_run.heap = b;
+    }
+
+    void _up(usize i) {
+        while (i > 0 and _before(i, (i - 1) / 2)) {
+            _swap(i, (i - 1) / 2);
+            i = (i - 1) / 2;
+        }
+    }
+
+    void _down(usize i) {
+        while (true) {
+            usize best = i;
+            usize l = 2 * i + 1;
+            usize r = 2 * i + 2;
+
+            if (l < _sleeping.len() and _before(l, best))
+                best = l;
+            if (r < _sleeping.len() and _before(r, best))
+                best = r;
+            if (best == i)
+                return;
+
+            _swap(i, best);
+            i = best;
+        }
+    }
+
+    void _take(usize i) {
+        usize last = _sleeping.len() - 1;
+        T *t = _sleeping[i];
+
+        if (i != last) {
+            _swap(i, last);
+            _sleeping.popBack();
+            _down(i);
+            _up(i);
+        } else {
+            _sleeping.popBack();
+        }
+
+        t->_run.heap = RunNode<T>::NIL;
+    }
+
+    // Puts the task to sleep until its deadline, or until woken up.
+    // Returns false if it was woken up already, it is ready instead.
+    bool sleep(T &t, TimeStamp deadline) {
+        if (t._run.wakePending) {
+            push(t);
+            return false;
+        }
+
+        t._run.deadline = deadline;
+        t._run.heap = _sleeping.len();
+        _sleeping.pushBack(&t);
+        _up(_sleeping.len() - 1);
+        return true;
+    }
+
+    // Calls cb with every sleeping task whose deadline has passed,
+    // the tasks are taken out of the sleep queue beforehand.
+    void expire(TimeStamp now, auto cb) {
+        while (_sleeping.len() and _sleeping[0]->_run.deadline <= now) {
+            T *t = _sleeping[0];
+            _take(0);
+            cb(*t);
+        }
+    }
+
+    // Moves a sleeping task back to its ready queue, returns false if
+    // the task wasn't sleeping. A task that isn't ready either is on its
+    // way to sleep() or being run, the wake up is kept for later.
+    bool wake(T &t) {
+        if (not isSleeping(t)) {
+            if (not isReady(t))
+                t._run.wakePending = true;
+            return false;
+        }
+
+        _take(t._run.heap);
+        push(t);
+        return true;
+    }
+
+    // Removes the task from whichever queue it is in.
+    void remove(T &t) {
+        t._run.wakePending = false;
+
+        if (isReady(t))
+            _unlink(t);
+
+        if (isSleeping(t))
+            _take(t._run.heap);
+    }
+};
+
+} // namespace Karm
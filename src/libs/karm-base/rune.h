@@ -114,6 +114,11 @@ struct Utf8 {
 
         Unit first = in.next();
 
+        if ((first & 0x80) == 0) {
+            result = first;
+            return true;
+        }
+
         if (unitLen(first) > in.rem() + 1) {
             result = U'�';
             return false;
@@ -162,6 +167,61 @@ struct Utf8 {
 
         return true;
     }
+
+    /// Returns the number of leading ASCII units in `buf`,
+    /// scanning a machine word at a time.
+    static usize asciiLen(Unit const *buf, usize len) {
+        usize i = 0;
+
+        for (; i + sizeof(u64) <= len; i += sizeof(u64)) {
+            u64 word;
+            memcpy(&word, buf + i, sizeof(u64));
+            if (word & 0x8080808080808080)
+                break;
+        }
+
+        while (i < len and (buf[i] & 0x80) == 0)
+            i++;
+
+        return i;
+    }
+
+    /// Checks that `buf` is well-formed UTF-8 (no truncated, overlong,
+    /// surrogate or out of range sequences) and counts its runes.
+    static bool validate(Unit const *buf, usize len, usize &runes) {
+        usize i = 0;
+        runes = 0;
+
+        while (i < len) {
+            usize ascii = asciiLen(buf + i, len - i);
+            i += ascii;
+            runes += ascii;
+
+            if (i == len)
+                break;
+
+            usize n = unitLen(buf[i]);
+            if (n == 1 or n > len - i)
+                return false;
+
+            Rune r = buf[i] & (0x7f >> n);
+            for (usize j = 1; j < n; j++) {
+                if ((buf[i + j] & 0xc0) != 0x80)
+                    return false;
+                r = (r << 6) | (buf[i + j] & 0x3f);
+            }
+
+            if (runeLen(r) != n or
+                (r >= 0xd800 and r <= 0xdfff) or
+                r > 0x10ffff)
+                return false;
+
+            i += n;
+            runes++;
+        }
+
+        return true;
+    }
 };
 
 [[gnu::used]] inline Utf8 UTF8;
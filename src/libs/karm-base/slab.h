@@ -0,0 +1,286 @@
+#pragma once
+
+#include "align.h"
+#include "atomic.h"
+#include "clamp.h"
+#include "lock.h"
+
+namespace Karm {
+
+struct Slab;
+
+struct SlabStats {
+    Str name;
+    usize size;
+    usize pages;
+    usize used;
+    usize allocs;
+    usize frees;
+    usize hits;
+};
+
+// Where slab caches get their pages from, and how they tell CPUs apart.
+// Also keeps track of the caches created on top of it.
+struct SlabBackend {
+    Lock _lock;
+    Slab *_caches = nullptr;
+
+    virtual ~SlabBackend() = default;
+
+    // Returns a Slab::PAGE sized and aligned block, or nullptr.
+    virtual void *allocPage() = 0;
+
+    virtual void freePage(void *page) = 0;
+
+    // Index of the CPU (or thread) we are running on, each index must
+    // only be used by one execution context at a time.
+    virtual usize cpu() = 0;
+
+    void visit(auto cb);
+};
+
+// A cache of fixed-size objects carved out of pages. Each CPU has a
+// magazine of free objects in front of the cache, allocations and frees
+// only take the cache lock when their magazine runs empty or full.
+// See: Bonwick, "Magazines and Vmem" (2001)
+struct Slab : Meta::Static {
+    static constexpr usize PAGE = 4096;
+    static constexpr usize ALIGN = 16;
+    static constexpr usize MAGAZINE = 32;
+    static constexpr usize CPUS = 16;
+
+    struct _Free {
+        _Free *next;
+    };
+
+    struct _Page {
+        _Page *next;
+        _Page *prev;
+        _Free *free;
+        usize used;
+    };
+
+    struct _Magazine {
+        usize len = 0;
+        void *objs[MAGAZINE];
+    };
+
+    static constexpr usize _HEADER = alignUp(sizeof(_Page), ALIGN);
+
+    Str _name;
+    SlabBackend &_backend;
+    usize _size;
+    usize _perPage;
+    Slab *_next = nullptr;
+
+    Lock _lock;
+    _Page *_partial = nullptr;
+    _Page *_full = nullptr;
+    _Page *_spare = nullptr;
+    _Magazine _mags[CPUS];
+
+    Atomic<usize> _pages{};
+    Atomic<usize> _used{};
+    Atomic<usize> _allocs{};
+    Atomic<usize> _frees{};
+    Atomic<usize> _hits{};
+
+    Slab(Str name, usize size, SlabBackend &backend)
+        : _name(name),
+          _backend(backend),
+          _size(alignUp(max(size, sizeof(_Free)), ALIGN)),
+          _perPage((PAGE - _HEADER) / _size) {
+        if (_perPage == 0)
+            panic("slab: object too large");
+
+        LockScope scope(_backend._lock);
+        _next = _backend._caches;
+        _backend._caches = this;
+    }
+
+    // Objects still allocated from the cache go away with its pages.
+    ~Slab() {
+        {
+            LockScope scope(_backend._lock);
+            for (auto **s = &_backend._caches; *s; s = &(*s)->_next) {
+                if (*s == this) {
+                    *s = _next;
+                    break;
+                }
+            }
+        }
+
+        for (auto *list : {_partial, _full}) {
+            while (list) {
+                auto *next = list->next;
+                _backend.freePage(list);
+                list = next;
+            }
+        }
+
+        if (_spare)
+            _backend.freePage(_spare);
+    }
+
+    usize size() const {
+        return _size;
+    }
+
+    /* --- Pages --- */
+
+    void _link(_Page *&list, _Page *page) {
+        page->prev = nullptr;
+        page->next = list;
+        if (list)
+            list->prev = page;
+        list = page;
+    }
+
+    void _unlink(_Page *&list, _Page *page) {
+        if (page->prev)
+            page->prev->next = page->next;
+        else
+            list = page->next;
+
+        if (page->next)
+            page->next->prev = page->prev;
+    }
+
+    _Page *_grow() {
+        void *mem = _spare ? _spare : _backend.allocPage();
+        _spare = nullptr;
+        if (not mem)
+            return nullptr;
+
+        auto *page = static_cast<_Page *>(mem);
+        page->free = nullptr;
+        page->used = 0;
+
+        auto *base = static_cast<u8 *>(mem) + _HEADER;
+        for (usize i = _perPage; i > 0; i--) {
+            auto *obj = reinterpret_cast<_Free *>(base + (i - 1) * _size);
+            obj->next = page->free;
+            page->free = obj;
+        }
+
+        _pages.inc(RELAXED);
+        _link(_partial, page);
+        return page;
+    }
+
+    // Cache lock must be held.
+    void *_take() {
+        if (not _partial and not _grow())
+            return nullptr;
+
+        auto *page = _partial;
+        auto *obj = page->free;
+        page->free = obj->next;
+        page->used++;
+
+        if (not page->free) {
+            _unlink(_partial, page);
+            _link(_full, page);
+        }
+
+        return obj;
+    }
+
+    // Cache lock must be held.
+    void _put(void *ptr) {
+        auto *page = reinterpret_cast<_Page *>(alignDown(reinterpret_cast<usize>(ptr), PAGE));
+        auto *obj = static_cast<_Free *>(ptr);
+
+        if (not page->free) {
+            _unlink(_full, page);
+            _link(_partial, page);
+        }
+
+        obj->next = page->free;
+        page->free = obj;
+        page->used--;
+
+        if (page->used)
+            return;
+
+        // Keep one empty page around to avoid bouncing
+        // pages back and forth with the backend.
+        _unlink(_partial, page);
+        _pages.dec(RELAXED);
+        if (_spare)
+            _backend.freePage(page);
+        else
+            _spare = page;
+    }
+
+    /* --- Allocation --- */
+
+    void *alloc() {
+        CriticalScope scope;
+        auto &mag = _mags[_backend.cpu() % CPUS];
+
+        if (mag.len) {
+            _hits.inc(RELAXED);
+        } else {
+            // Refill half of the magazine so that the
+            // next allocations don't need the lock.
+            LockScope scope(_lock);
+            while (mag.len < MAGAZINE / 2) {
+                auto *obj = _take();
+                if (not obj)
+                    break;
+                mag.objs[mag.len++] = obj;
+            }
+
+            if (not mag.len)
+                return nullptr;
+        }
+
+        _allocs.inc(RELAXED);
+        _used.inc(RELAXED);
+        return mag.objs[--mag.len];
+    }
+
+    void free(void *ptr) {
+        CriticalScope scope;
+        auto &mag = _mags[_backend.cpu() % CPUS];
+
+        if (mag.len == MAGAZINE) {
+            LockScope scope(_lock);
+            while (mag.len > MAGAZINE / 2)
+                _put(mag.objs[--mag.len]);
+        }
+
+        _frees.inc(RELAXED);
+        _used.dec(RELAXED);
+        mag.objs[mag.len++] = ptr;
+    }
+
+    // Give all the objects sitting in the magazines back to the pages.
+    void drain() {
+        LockScope scope(_lock);
+        for (auto &mag : _mags)
+            while (mag.len)
+                _put(mag.objs[--mag.len]);
+    }
+
+    SlabStats stats() {
+        return {
+            .name = _name,
+            .size = _size,
+            .pages = _pages.load(RELAXED),
+            .used = _used.load(RELAXED),
+            .allocs = _allocs.load(RELAXED),
+            .frees = _frees.load(RELAXED),
+            .hits = _hits.load(RELAXED),
+        };
+    }
+};
+
+void SlabBackend::visit(auto cb) {
+    LockScope scope(_lock);
+    for (auto *s = _caches; s; s = s->_next)
+        cb(*s);
+}
+
+} // namespace Karm
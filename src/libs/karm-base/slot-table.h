@@ -0,0 +1,103 @@
+#pragma once
+
+#include "array.h"
+#include "box.h"
+#include "opt.h"
+
+namespace Karm {
+
+// Maps small integer ids to values. Free ids are threaded through the
+// empty slots, so adding and removing never scans the table. Slots are
+// grouped in pages that are only allocated once an id in them is handed
+// out, a table that only uses a few ids stays small.
+template <typename T, usize LEN, usize PAGE = 64>
+struct SlotTable {
+    static_assert(LEN % PAGE == 0, "LEN must be a multiple of PAGE");
+
+    static constexpr usize PAGES = LEN / PAGE;
+    static constexpr usize NIL = ~0uz;
+
+    struct _Slot {
+        Opt<T> value = NONE;
+        usize next = NIL;
+    };
+
+    using _Page = Array<_Slot, PAGE>;
+
+    Array<Opt<Box<_Page>>, PAGES> _pages{};
+
+    // Head of the list of freed ids.
+    usize _free = NIL;
+
+    // Ids from here on have never been handed out.
+    usize _fresh;
+    usize _len = 0;
+
+    // Ids below `first` are reserved and never handed out.
+    SlotTable(usize first = 0)
+        : _fresh(first) {}
+
+    // How many ids are in use.
+    usize len() const {
+        return _len;
+    }
+
+    _Slot *_slot(usize id) {
+        if (id >= LEN)
+            return nullptr;
+
+        auto &page = _pages[id / PAGE];
+        if (not page)
+            return nullptr;
+
+        return &(**page)[id % PAGE];
+    }
+
+    // Returns the id the value was stored at, or NONE if the table is full.
+    Opt<usize> add(T value) {
+        usize id = _free;
+
+        if (id != NIL) {
+            _free = _slot(id)->next;
+        } else if (_fresh < LEN) {
+            id = _fresh++;
+            auto &page = _pages[id / PAGE];
+            if (not page)
+                page = makeBox<_Page>();
+        } else {
+            return NONE;
+        }
+
+        auto *slot = _slot(id);
+        slot->value = std::move(value);
+        slot->next = NIL;
+        _len++;
+        return id;
+    }
+
+    T *get(usize id) {
+        auto *slot = _slot(id);
+        if (not slot or not slot->value)
+            return nullptr;
+        return &*slot->value;
+    }
+
+    bool has(usize id) {
+        return get(id) != nullptr;
+    }
+
+    // Frees the id and returns what was stored there.
+    Opt<T> take(usize id) {
+        auto *slot = _slot(id);
+        if (not slot or not slot->value)
+            return NONE;
+
+        Opt<T> value = slot->value.take();
+        slot->next = _free;
+        _free = id;
+        _len--;
+        return value;
+    }
+};
+
+} // namespace Karm
@@ -133,6 +133,52 @@ struct _String {
     }
 };
 
+/// A growable string buffer, appending to it is amortized O(1)
+/// and `take()` hands over the storage without copying.
+template <StaticEncoding E>
+struct _StringBuilder {
+    using Encoding = E;
+    using Unit = typename E::Unit;
+    using Inner = Unit;
+
+    Buf<Unit> _buf{};
+
+    _StringBuilder(usize cap = 16) : _buf(cap) {}
+
+    void ensure(usize cap) {
+        // NOTE: +1 for the null terminator added by take()
+        _buf.ensure(cap + 1);
+    }
+
+    void append(Rune rune) {
+        typename E::One one;
+        E::encodeUnit(rune, one);
+        append(Slice<Unit>{one.buf(), one.len()});
+    }
+
+    void append(Slice<Unit> units) {
+        _buf.insert(COPY, _buf.len(), units.buf(), units.len());
+    }
+
+    void clear() {
+        _buf.truncate(0);
+    }
+
+    usize len() const {
+        return _buf.len();
+    }
+
+    _Str<E> str() const {
+        return {_buf.buf(), _buf.len()};
+    }
+
+    _String<E> take() {
+        usize len = _buf.len();
+        _buf.insert(len, 0);
+        return {MOVE, _buf.take(), len};
+    }
+};
+
 template <
     Sliceable S,
     typename E = typename S::Encoding,
@@ -197,6 +243,8 @@ using Str = _Str<Utf8>;
 
 using String = _String<Utf8>;
 
+using StringBuilder = _StringBuilder<Utf8>;
+
 template <auto N>
 struct StrLit {
     char _buf[N];
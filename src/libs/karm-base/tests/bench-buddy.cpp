@@ -0,0 +1,64 @@
+#include <karm-base/bits.h>
+#include <karm-base/buddy.h>
+#include <karm-base/buf.h>
+#include <karm-base/vec.h>
+#include <karm-test/macros.h>
+
+namespace Karm::Base::Tests {
+
+// The memory map of a 16GiB machine with 4KiB pages.
+static constexpr usize PAGES = (16uz << 30) >> 12;
+static constexpr usize ROUNDS = 1 << 11;
+
+// Allocations of all sizes, freeing every other one to fragment
+// the map, then everything is given back for the next iteration.
+static void _churn(Bencher &b, auto alloc, auto free) {
+    b.items(ROUNDS);
+    b.run([&] {
+        Vec<BitsRange> live;
+        for (usize i = 0; i < ROUNDS; i++) {
+            usize count = 1 + (i * 7919) % 16;
+            live.pushBack(alloc(count));
+
+            if (i % 2)
+                free(live.removeAt((i * 104729) % live.len()));
+        }
+
+        for (auto &r : live)
+            free(r);
+    });
+}
+
+bench$(buddyChurn) {
+    auto meta = Buf<u8>::init(Buddy::metaSize(PAGES));
+    Buddy buddy{meta, PAGES};
+    buddy.free({0, PAGES});
+
+    _churn(
+        b,
+        [&](usize n) {
+            return buddy.alloc(n).unwrap();
+        },
+        [&](BitsRange r) {
+            buddy.free(r);
+        }
+    );
+}
+
+// First fit in a bitmap, what the PMM used before the buddy allocator.
+bench$(bitmapChurn) {
+    auto buf = Buf<u8>::init(PAGES / 8);
+    Bits bits{buf};
+
+    _churn(
+        b,
+        [&](usize n) {
+            return bits.alloc(n, 0, false).unwrap();
+        },
+        [&](BitsRange r) {
+            bits.set(r, false);
+        }
+    );
+}
+
+} // namespace Karm::Base::Tests
@@ -0,0 +1,46 @@
+#include <karm-base/range-alloc.h>
+#include <karm-base/range-map.h>
+#include <karm-test/macros.h>
+
+namespace Karm::Base::Tests {
+
+static constexpr usize COUNT = 10000;
+
+// An address space with 10k mappings of mixed sizes, half of them
+// unmapped again to leave holes for the following allocations.
+bench$(rangeAllocMappings) {
+    b.items(COUNT * 2);
+    b.run([] {
+        RangeAlloc<> alloc;
+        alloc.unused({0x1000, 0x800000000000});
+
+        Vec<USizeRange> live;
+        for (usize i = 0; i < COUNT; i++)
+            live.pushBack(alloc.alloc(0x1000 * (1 + i % 7)).unwrap());
+
+        for (usize i = 0; i < COUNT; i += 2)
+            alloc.unused(live[i]);
+
+        for (usize i = 0; i < COUNT; i++)
+            doNotOptimize(alloc.alloc(0x1000 * (1 + i % 3)).unwrap());
+    });
+}
+
+// Validating user pointers against 10k mappings, as done on every syscall.
+bench$(rangeMapCovering) {
+    static constexpr usize LOOKUPS = 1000;
+
+    RangeMap<USizeRange, usize> map;
+    for (usize i = 0; i < COUNT; i++)
+        map.insert({((i * 7919) % COUNT) * 0x4000, 0x1000}, i).unwrap();
+
+    b.items(LOOKUPS);
+    b.run([&] {
+        for (usize i = 0; i < LOOKUPS; i++) {
+            usize addr = ((i * 104729) % COUNT) * 0x4000 + 0x10;
+            doNotOptimize(map.covering({addr, 0x100}));
+        }
+    });
+}
+
+} // namespace Karm::Base::Tests
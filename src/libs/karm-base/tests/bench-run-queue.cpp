@@ -0,0 +1,53 @@
+#include <karm-base/run-queue.h>
+#include <karm-test/macros.h>
+
+namespace Karm::Base::Tests {
+
+struct BenchTask {
+    usize id;
+    RunNode<BenchTask> _run;
+
+    BenchTask(usize id = 0, usize prio = 0) : id(id) {
+        _run.prio = prio;
+    }
+};
+
+static TimeStamp _deadline(usize i, usize tick) {
+    return TimeStamp::epoch() + TimeSpan::fromUSecs(tick + 1 + (i * 7919 + tick) % 500);
+}
+
+// A thousand tasks, most of them waiting on a timer, ticked like
+// the kernel does, one tick per iteration.
+bench$(runQueueTick) {
+    static constexpr usize TASKS = 1000;
+
+    Vec<BenchTask> tasks;
+    for (usize i = 0; i < TASKS; i++)
+        tasks.pushBack(BenchTask{i, i % 32});
+
+    RunQueue<BenchTask> queue;
+    for (usize i = 0; i < TASKS; i++) {
+        if (i % 10)
+            queue.sleep(tasks[i], _deadline(i, 0));
+        else
+            queue.push(tasks[i]);
+    }
+
+    usize tick = 0;
+    b.items(1);
+    b.run([&] {
+        tick++;
+        queue.expire(TimeStamp::epoch() + TimeSpan::fromUSecs(tick), [&](BenchTask &t) {
+            queue.push(t);
+        });
+
+        // Run one task, half of them go back to sleep afterward.
+        auto *t = queue.pop();
+        if (t->id % 2)
+            queue.sleep(*t, _deadline(t->id, tick));
+        else
+            queue.push(*t);
+    });
+}
+
+} // namespace Karm::Base::Tests
@@ -0,0 +1,29 @@
+#include <karm-base/slot-table.h>
+#include <karm-base/vec.h>
+#include <karm-test/macros.h>
+
+namespace Karm::Base::Tests {
+
+// Drops and creates a capability in a table that holds a thousand of
+// them at any time, like a busy domain does. A table that looks for
+// the first empty slot would walk past about half of them every time.
+bench$(slotTableReplace) {
+    static constexpr usize LEN = 2048;
+    static constexpr usize LIVE = 1000;
+
+    SlotTable<usize, LEN> table{1};
+    Vec<usize> live;
+
+    for (usize i = 0; i < LIVE; i++)
+        live.pushBack(table.add(i).unwrap());
+
+    usize i = 0;
+    b.items(1);
+    b.run([&] {
+        usize victim = (i++ * 7919) % LIVE;
+        doNotOptimize(table.take(live[victim]).unwrap());
+        live[victim] = table.add(victim).unwrap();
+    });
+}
+
+} // namespace Karm::Base::Tests
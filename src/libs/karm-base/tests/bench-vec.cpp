@@ -0,0 +1,58 @@
+#include <karm-base/vec.h>
+#include <karm-test/macros.h>
+
+namespace Karm::Base::Tests {
+
+static constexpr usize N = 4096;
+
+bench$(vecPushBack) {
+    b.items(N);
+    b.run([] {
+        Vec<usize> vec;
+        for (usize i = 0; i < N; i++)
+            vec.pushBack(i);
+        doNotOptimize(vec.buf());
+    });
+}
+
+bench$(vecPushBackReserved) {
+    b.items(N);
+    b.run([] {
+        Vec<usize> vec(N);
+        for (usize i = 0; i < N; i++)
+            vec.pushBack(i);
+        doNotOptimize(vec.buf());
+    });
+}
+
+bench$(vecCopy) {
+    Vec<u8> src;
+    src.resize(1 << 16, 0x2a);
+
+    b.bytes(src.len());
+    b.run([&] {
+        Vec<u8> copy = src;
+        doNotOptimize(copy.buf());
+    });
+}
+
+bench$(vecSort) {
+    Vec<u32> data;
+    u32 x = 0x12345678;
+    for (usize i = 0; i < N; i++) {
+        // xorshift, shuffled but the same every run.
+        x ^= x << 13;
+        x ^= x >> 17;
+        x ^= x << 5;
+        data.pushBack(x);
+    }
+
+    b.items(N);
+    b.run([&] {
+        Vec<u32> copy = data;
+        sort(copy);
+        doNotOptimize(copy.buf());
+    });
+}
+
+} // namespace Karm::Base::Tests
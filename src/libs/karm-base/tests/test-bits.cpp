@@ -0,0 +1,68 @@
+#include <karm-base/array.h>
+#include <karm-base/bits.h>
+#include <karm-test/macros.h>
+
+namespace Karm::Base::Tests {
+
+test$(bitsFind) {
+    Array<u8, 24> buf = {};
+    Bits bits{buf};
+
+    expectEq$(bits.findNext(0, true), bits.len());
+    expectEq$(bits.findNext(0, false), 0uz);
+
+    bits.set(3, true);
+    bits.set(130, true);
+    expectEq$(bits.findNext(0, true), 3uz);
+    expectEq$(bits.findNext(4, true), 130uz);
+    expectEq$(bits.findPrev(130, true).unwrap(), 3uz);
+    expectEq$(bits.findPrev(bits.len(), true).unwrap(), 130uz);
+    expect$(not bits.findPrev(3, true));
+
+    bits.fill(true);
+    expectEq$(bits.findNext(0, false), bits.len());
+    expect$(not bits.findPrev(bits.len(), false));
+
+    return Ok();
+}
+
+test$(bitsSetRange) {
+    Array<u8, 16> buf = {};
+    Bits bits{buf};
+
+    bits.set(BitsRange{5, 100}, true);
+    expectEq$(bits.used(), 100uz);
+    expect$(not bits.get(4));
+    expect$(bits.get(5));
+    expect$(bits.get(104));
+    expect$(not bits.get(105));
+
+    return Ok();
+}
+
+test$(bitsAlloc) {
+    Array<u8, 32> buf = {};
+    Bits bits{buf};
+
+    bits.set(BitsRange{0, 10}, true);
+    bits.set(BitsRange{12, 1}, true);
+
+    auto lower = bits.alloc(4, 0, false).unwrap();
+    expectEq$(lower.start, 13uz);
+    expectEq$(lower.size, 4uz);
+
+    auto upper = bits.alloc(4, bits.len(), true).unwrap();
+    expectEq$(upper.end(), bits.len());
+
+    expect$(not bits.alloc(bits.len(), 0, false));
+
+    usize runs = 0;
+    bits.visit([&](BitsRange) {
+        runs++;
+    });
+    expectEq$(runs, 2uz);
+
+    return Ok();
+}
+
+} // namespace Karm::Base::Tests
@@ -0,0 +1,92 @@
+#include <karm-base/buddy.h>
+#include <karm-base/buf.h>
+#include <karm-base/vec.h>
+#include <karm-test/macros.h>
+
+namespace Karm::Base::Tests {
+
+static Buf<u8> _meta(usize len) {
+    return Buf<u8>::init(Buddy::metaSize(len));
+}
+
+test$(buddyAllocFree) {
+    auto meta = _meta(1024);
+    Buddy buddy{meta, 1024};
+    expectEq$(buddy.available(), 0uz);
+
+    buddy.free({0, 1024});
+    expectEq$(buddy.available(), 1024uz);
+
+    auto a = buddy.alloc(1).unwrap();
+    auto b = buddy.alloc(3).unwrap();
+    auto c = buddy.alloc(100).unwrap();
+    expectEq$(buddy.available(), 1024uz - 104);
+
+    expect$(not a.overlaps(b));
+    expect$(not b.overlaps(c));
+    expect$(not a.overlaps(c));
+
+    buddy.free(b);
+    buddy.free(a);
+    buddy.free(c);
+
+    // Everything coalesced back into a single block.
+    expectEq$(buddy.available(), 1024uz);
+    expectEq$(buddy.alloc(1024).unwrap().start, 0uz);
+    expect$(not buddy.alloc(1));
+
+    return Ok();
+}
+
+test$(buddyUsed) {
+    auto meta = _meta(1000);
+    Buddy buddy{meta, 1000};
+    buddy.free({0, 1000});
+
+    buddy.used({10, 20});
+    expectEq$(buddy.available(), 980uz);
+
+    Vec<BitsRange> runs;
+    buddy.visit([&](BitsRange r) {
+        runs.pushBack(r);
+    });
+
+    expectEq$(runs.len(), 2uz);
+    expectEq$(runs[0].end(), 10uz);
+    expectEq$(runs[1].start, 30uz);
+    expectEq$(runs[1].end(), 1000uz);
+
+    // Nothing handed out may touch the used range.
+    while (auto r = buddy.alloc(1))
+        expect$(not r->overlaps({10, 20}));
+
+    return Ok();
+}
+
+// Fragments the allocator with allocations of all sizes, freeing
+// every other one, everything must coalesce back in the end.
+test$(buddyChurn) {
+    static constexpr usize PAGES = 1 << 14;
+    static constexpr usize ROUNDS = 1 << 10;
+
+    auto meta = _meta(PAGES);
+    Buddy buddy{meta, PAGES};
+    buddy.free({0, PAGES});
+
+    Vec<BitsRange> live;
+    for (usize i = 0; i < ROUNDS; i++) {
+        usize count = 1 + (i * 7919) % 16;
+        live.pushBack(buddy.alloc(count).unwrap());
+
+        if (i % 2)
+            buddy.free(live.removeAt((i * 104729) % live.len()));
+    }
+
+    for (auto &r : live)
+        buddy.free(r);
+    expectEq$(buddy.available(), PAGES);
+
+    return Ok();
+}
+
+} // namespace Karm::Base::Tests
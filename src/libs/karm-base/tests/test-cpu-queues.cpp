@@ -0,0 +1,266 @@
+#include <karm-base/cpu-queues.h>
+#include <karm-logger/logger.h>
+#include <karm-sys/thread.h>
+#include <karm-test/macros.h>
+
+namespace Karm::Base::Tests {
+
+struct SimTask {
+    usize id = 0;
+    usize work = 0;
+    usize ran = 0;
+    RunNode<SimTask> _run;
+};
+
+static TimeStamp _tick(usize tick) {
+    return TimeStamp::epoch() + TimeSpan::fromUSecs(tick);
+}
+
+test$(cpuQueuesSteal) {
+    SimTask tasks[4];
+    CpuQueues<SimTask> queues{2};
+
+    for (usize i = 0; i < 4; i++) {
+        tasks[i].id = i;
+        queues.push(tasks[i]);
+    }
+    expectEq$(queues.load(0), 4uz);
+    expectEq$(queues.leastLoaded(), 1uz);
+
+    // Cpu 1 has nothing of its own, it takes the next task of cpu 0.
+    auto *t = queues.pop(1);
+    expectEq$(t->id, 0uz);
+    expectEq$(t->_run.cpu, 1uz);
+    expectEq$(queues.steals(1), 1uz);
+    expectEq$(queues.load(0), 3uz);
+    expect$(not queues.idle(1));
+
+    // Going back to the queue of its new cpu.
+    queues.push(*t);
+    expectEq$(queues.load(1), 1uz);
+    expectEq$(queues.pop(1)->id, 0uz);
+
+    expect$(queues.popLocal(1) == nullptr);
+    expect$(queues.idle(1));
+
+    return Ok();
+}
+
+test$(cpuQueuesWake) {
+    SimTask a, b;
+    CpuQueues<SimTask> queues{2};
+
+    a._run.cpu = 1;
+    queues.sleep(a, TimeStamp::endOfTime());
+    queues.sleep(b, _tick(10));
+
+    // Whoever wakes the task up, it goes back to its own cpu.
+    expect$(queues.wake(a));
+    expect$(not queues.wake(a));
+    expectEq$(queues.load(1), 1uz);
+    expectEq$(queues.load(0), 0uz);
+
+    expectEq$(queues.expire(0, _tick(5)), 0uz);
+    expectEq$(queues.expire(0, _tick(10)), 1uz);
+    expectEq$(queues.load(0), 1uz);
+
+    queues.remove(b);
+    expectEq$(queues.load(0), 0uz);
+
+    // Woken up after being found blocked, but before going to sleep.
+    expectEq$(queues.pop(1), &a);
+    expect$(not queues.wake(a));
+    expect$(not queues.sleep(a, TimeStamp::endOfTime()));
+    expectEq$(queues.pop(1), &a);
+
+    return Ok();
+}
+
+// Runs tasks that were all spawned on the first cpu, each one runs for
+// a few ticks, gets preempted or sleeps for a while, until all of its
+// work is done. Returns how many ticks it took to finish everything.
+static usize _simulate(usize cpus, bool stealing, usize &idle) {
+    static constexpr usize TASKS = 64;
+    static constexpr usize SLICE = 3;
+    static constexpr usize BURST = 10;
+
+    Vec<SimTask> tasks;
+    for (usize i = 0; i < TASKS; i++)
+        tasks.pushBack(SimTask{.id = i, .work = 20 + (i * 7919) % 80});
+
+    CpuQueues<SimTask> queues{cpus};
+    for (auto &t : tasks)
+        queues.push(t);
+
+    SimTask *curr[16] = {};
+    usize done = 0;
+    usize tick = 0;
+    idle = 0;
+
+    while (done < TASKS) {
+        tick++;
+        for (usize cpu = 0; cpu < cpus; cpu++) {
+            queues.expire(cpu, _tick(tick));
+
+            auto *&t = curr[cpu];
+            if (not t)
+                t = stealing ? queues.pop(cpu) : queues.popLocal(cpu);
+
+            if (not t) {
+                idle++;
+                continue;
+            }
+
+            t->work--;
+            t->ran++;
+
+            if (t->work == 0) {
+                done++;
+                t = nullptr;
+            } else if (t->ran % BURST == 0) {
+                queues.sleep(*t, _tick(tick + 5 + t->id % 7));
+                t = nullptr;
+            } else if (t->ran % SLICE == 0) {
+                queues.push(*t);
+                t = nullptr;
+            }
+        }
+    }
+
+    return tick;
+}
+
+test$(cpuQueuesSimulation) {
+    static constexpr usize CPUS = 8;
+
+    usize idleOne, idleLocal, idleSteal;
+    usize one = _simulate(1, false, idleOne);
+    usize local = _simulate(CPUS, false, idleLocal);
+    usize steal = _simulate(CPUS, true, idleSteal);
+
+    // Without stealing the other cpus never get any work.
+    expectEq$(local, one);
+    expect$(steal * (CPUS / 2) < local);
+
+    logInfo("{} cpus: {} ticks on one cpu, {} ticks without stealing ({} idle), {} ticks with stealing ({} idle)", CPUS, one, local, idleLocal, steal, idleSteal);
+
+    return Ok();
+}
+
+// Tasks block on events that other cpus signal at the worst time: after
+// the task was found blocked, but before it is put to sleep. They sleep
+// without a deadline, so a lost wake up means they never finish.
+test$(cpuQueuesWakeWhileBlocking) {
+    static constexpr usize CPUS = 4;
+    static constexpr usize TASKS = 32;
+    static constexpr usize TICKS = 10000;
+
+    Vec<SimTask> tasks;
+    for (usize i = 0; i < TASKS; i++)
+        tasks.pushBack(SimTask{.id = i, .work = 50});
+
+    CpuQueues<SimTask> queues{CPUS};
+    for (auto &t : tasks) {
+        t._run.cpu = t.id % CPUS;
+        queues.push(t);
+    }
+
+    SimTask *curr[CPUS] = {};
+    usize done = 0;
+    usize tick = 0;
+
+    while (done < TASKS and tick < TICKS) {
+        tick++;
+
+        SimTask *blocking[CPUS] = {};
+        for (usize cpu = 0; cpu < CPUS; cpu++) {
+            auto *&t = curr[cpu];
+            if (not t)
+                t = queues.pop(cpu);
+            if (not t)
+                continue;
+
+            t->work--;
+            t->ran++;
+
+            if (t->work == 0) {
+                done++;
+                t = nullptr;
+            } else if (t->ran % 4 == 0) {
+                blocking[cpu] = t;
+                t = nullptr;
+            } else if (t->ran % 3 == 0) {
+                queues.push(*t);
+                t = nullptr;
+            }
+        }
+
+        // The next cpu signals the event right away, the
+        // blocking cpus only get to sleep afterward.
+        for (usize cpu = 0; cpu < CPUS; cpu++)
+            if (blocking[cpu])
+                expect$(not queues.wake(*blocking[cpu]));
+
+        for (usize cpu = 0; cpu < CPUS; cpu++)
+            if (blocking[cpu])
+                queues.sleep(*blocking[cpu], TimeStamp::endOfTime());
+    }
+
+    expectEq$(done, TASKS);
+
+    return Ok();
+}
+
+test$(cpuQueuesThreads) {
+    static constexpr usize THREADS = 4;
+    static constexpr usize TASKS = 64;
+    static constexpr usize ROUNDS = 20000;
+
+    Vec<SimTask> tasks;
+    for (usize i = 0; i < TASKS; i++)
+        tasks.pushBack(SimTask{.id = i});
+
+    CpuQueues<SimTask> queues{THREADS};
+    for (auto &t : tasks) {
+        t._run.cpu = t.id % THREADS;
+        queues.push(t);
+    }
+
+    Atomic<usize> runs{};
+    Vec<Strong<Sys::Thread>> threads;
+    for (usize cpu = 0; cpu < THREADS; cpu++) {
+        threads.pushBack(try$(Sys::Thread::spawn([&, cpu] {
+            for (usize r = 0; r < ROUNDS; r++) {
+                // Wake up tasks that might be sleeping on any cpu.
+                queues.wake(tasks[(r * 7919 + cpu) % TASKS]);
+
+                auto *t = queues.pop(cpu);
+                if (not t)
+                    continue;
+
+                runs.inc(RELAXED);
+                if ((r + cpu) % 3)
+                    queues.push(*t);
+                else
+                    queues.sleep(*t, TimeStamp::endOfTime());
+            }
+        })));
+    }
+
+    for (auto &t : threads)
+        try$(t->join());
+
+    // Every task must still be in exactly one queue.
+    usize count = 0;
+    for (usize cpu = 0; cpu < THREADS; cpu++) {
+        queues.expire(cpu, TimeStamp::endOfTime());
+        while (queues.popLocal(cpu))
+            count++;
+    }
+    expectEq$(count, TASKS);
+    expect$(runs.load() > 0uz);
+
+    return Ok();
+}
+
+} // namespace Karm::Base::Tests
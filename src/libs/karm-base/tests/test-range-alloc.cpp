@@ -0,0 +1,70 @@
+#include <karm-base/range-alloc.h>
+#include <karm-test/macros.h>
+
+namespace Karm::Base::Tests {
+
+static Vec<USizeRange> _free(RangeAlloc<> &alloc) {
+    Vec<USizeRange> res;
+    alloc.visit([&](USizeRange r) {
+        res.pushBack(r);
+    });
+    return res;
+}
+
+test$(rangeAllocFirstFit) {
+    RangeAlloc<> alloc;
+    alloc.unused({0, 100});
+
+    auto a = try$(alloc.alloc(10));
+    auto b = try$(alloc.alloc(20));
+    expectEq$(a.start, 0uz);
+    expectEq$(b.start, 10uz);
+
+    alloc.unused(a);
+    expectEq$(try$(alloc.alloc(5)).start, 0uz);
+    expectEq$(try$(alloc.alloc(10)).start, 30uz);
+    expect$(not alloc.alloc(100));
+
+    return Ok();
+}
+
+test$(rangeAllocCoalesce) {
+    RangeAlloc<> alloc;
+    alloc.unused({0, 10});
+    alloc.unused({20, 10});
+    expectEq$(alloc.len(), 2uz);
+
+    // Filling the hole merges everything back into one range.
+    alloc.unused({10, 10});
+    expectEq$(alloc.len(), 1uz);
+
+    auto ranges = _free(alloc);
+    expectEq$(ranges[0].start, 0uz);
+    expectEq$(ranges[0].size, 30uz);
+
+    return Ok();
+}
+
+test$(rangeAllocUsed) {
+    RangeAlloc<> alloc;
+    alloc.unused({0, 100});
+    alloc.unused({200, 100});
+
+    // Spans the end of the first range and the start of the second.
+    alloc.used({50, 200});
+
+    auto ranges = _free(alloc);
+    expectEq$(ranges.len(), 2uz);
+    expectEq$(ranges[0].start, 0uz);
+    expectEq$(ranges[0].size, 50uz);
+    expectEq$(ranges[1].start, 250uz);
+    expectEq$(ranges[1].size, 50uz);
+
+    alloc.used({10, 10});
+    expectEq$(alloc.len(), 3uz);
+    expectEq$(try$(alloc.alloc(20)).start, 20uz);
+
+    return Ok();
+}
+
+} // namespace Karm::Base::Tests
@@ -0,0 +1,68 @@
+#include <karm-base/range-map.h>
+#include <karm-test/macros.h>
+
+namespace Karm::Base::Tests {
+
+test$(rangeMapInsert) {
+    RangeMap<USizeRange, int> map;
+    try$(map.insert({20, 10}, 2));
+    try$(map.insert({0, 10}, 0));
+    try$(map.insert({10, 10}, 1));
+
+    expectEq$(map.len(), 3uz);
+    for (usize i = 0; i < map.len(); i++) {
+        expectEq$(map[i].range.start, i * 10);
+        expectEq$(map[i].value, (int)i);
+    }
+
+    expect$(not map.insert({5, 10}, 3));
+    expect$(not map.insert({25, 1}, 3));
+
+    return Ok();
+}
+
+test$(rangeMapFind) {
+    RangeMap<USizeRange, int> map;
+    try$(map.insert({0, 10}, 0));
+    try$(map.insert({20, 10}, 1));
+
+    expectEq$(map.find(5).unwrap(), 0uz);
+    expectEq$(map.find(29).unwrap(), 1uz);
+    expect$(not map.find(10));
+    expect$(not map.find(30));
+
+    expectEq$(map.lookup({20, 10}).unwrap(), 1uz);
+    expect$(not map.lookup({20, 5}));
+
+    expectEq$(map.covering({22, 4}).unwrap(), 1uz);
+    expect$(not map.covering({5, 20}));
+
+    expect$(map.overlaps({5, 20}));
+    expect$(not map.overlaps({10, 10}));
+
+    map.removeAt(0);
+    expect$(not map.find(5));
+    expectEq$(map.find(25).unwrap(), 0uz);
+
+    return Ok();
+}
+
+// Mappings inserted out of order, each found again by an
+// address within it.
+test$(rangeMapCovering) {
+    static constexpr usize COUNT = 100;
+
+    RangeMap<USizeRange, usize> map;
+    for (usize i = 0; i < COUNT; i++)
+        try$(map.insert({((i * 7919) % COUNT) * 0x4000, 0x1000}, i));
+
+    for (usize i = 0; i < COUNT; i++) {
+        usize addr = i * 0x4000 + 0x10;
+        expect$(map.covering({addr, 0x100}));
+        expect$(not map.covering({addr + 0x1000, 0x100}));
+    }
+
+    return Ok();
+}
+
+} // namespace Karm::Base::Tests
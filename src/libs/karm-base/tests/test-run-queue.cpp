@@ -0,0 +1,154 @@
+#include <karm-base/run-queue.h>
+#include <karm-test/macros.h>
+
+namespace Karm::Base::Tests {
+
+struct FakeTask {
+    usize id;
+    RunNode<FakeTask> _run;
+
+    FakeTask(usize id = 0, usize prio = 0) : id(id) {
+        _run.prio = prio;
+    }
+};
+
+static TimeStamp _at(usize usecs) {
+    return TimeStamp::epoch() + TimeSpan::fromUSecs(usecs);
+}
+
+test$(runQueuePriority) {
+    FakeTask low{0, 1}, mid{1, 8}, high{2, 31};
+    RunQueue<FakeTask> queue;
+
+    queue.push(low);
+    queue.push(high);
+    queue.push(mid);
+    expectEq$(queue.ready(), 3uz);
+
+    expectEq$(queue.pop()->id, 2uz);
+    expectEq$(queue.pop()->id, 1uz);
+    expectEq$(queue.pop()->id, 0uz);
+    expect$(queue.pop() == nullptr);
+    expectEq$(queue.ready(), 0uz);
+
+    return Ok();
+}
+
+test$(runQueueFifo) {
+    FakeTask tasks[4] = {{0, 4}, {1, 4}, {2, 4}, {3, 4}};
+    RunQueue<FakeTask> queue;
+
+    for (auto &t : tasks)
+        queue.push(t);
+
+    // Round-robin within a priority level.
+    auto *first = queue.pop();
+    queue.push(*first);
+    expectEq$(queue.pop()->id, 1uz);
+    expectEq$(queue.pop()->id, 2uz);
+    expectEq$(queue.pop()->id, 3uz);
+    expectEq$(queue.pop()->id, 0uz);
+
+    return Ok();
+}
+
+test$(runQueueSleep) {
+    FakeTask a{0}, b{1}, c{2};
+    RunQueue<FakeTask> queue;
+
+    queue.sleep(a, _at(30));
+    queue.sleep(b, _at(10));
+    queue.sleep(c, _at(20));
+    expectEq$(queue.sleeping(), 3uz);
+
+    Vec<usize> woken;
+    auto collect = [&](FakeTask &t) {
+        woken.pushBack(t.id);
+    };
+
+    queue.expire(_at(5), collect);
+    expectEq$(woken.len(), 0uz);
+
+    queue.expire(_at(20), collect);
+    expectEq$(woken.len(), 2uz);
+    expectEq$(woken[0], 1uz);
+    expectEq$(woken[1], 2uz);
+    expect$(not queue.isSleeping(b));
+
+    queue.expire(_at(100), collect);
+    expectEq$(woken.len(), 3uz);
+    expectEq$(queue.sleeping(), 0uz);
+
+    return Ok();
+}
+
+test$(runQueueWake) {
+    FakeTask a{0, 3}, b{1, 3};
+    RunQueue<FakeTask> queue;
+
+    queue.sleep(a, TimeStamp::endOfTime());
+    queue.sleep(b, _at(10));
+
+    expect$(queue.wake(a));
+    expect$(not queue.wake(a));
+    expect$(queue.isReady(a));
+    expectEq$(queue.sleeping(), 1uz);
+    expectEq$(queue.pop()->id, 0uz);
+
+    queue.remove(b);
+    expectEq$(queue.sleeping(), 0uz);
+
+    queue.push(a);
+    queue.remove(a);
+    expect$(queue.pop() == nullptr);
+
+    return Ok();
+}
+
+// Tasks waiting on timers, ticked like the kernel does. The run
+// queue only touches the tasks that are due, where a plain list of
+// tasks would evaluate every one of them on each tick.
+test$(runQueueTicks) {
+    static constexpr usize TASKS = 100;
+    static constexpr usize TICKS = 1000;
+
+    Vec<FakeTask> tasks;
+    for (usize i = 0; i < TASKS; i++)
+        tasks.pushBack(FakeTask{i, i % 32});
+
+    auto deadline = [](usize i, usize tick) {
+        return _at(tick + 1 + (i * 7919 + tick) % 500);
+    };
+
+    RunQueue<FakeTask> queue;
+    for (usize i = 0; i < TASKS; i++) {
+        if (i % 10)
+            queue.sleep(tasks[i], deadline(i, 0));
+        else
+            queue.push(tasks[i]);
+    }
+
+    usize evals = 0;
+    for (usize tick = 1; tick <= TICKS; tick++) {
+        queue.expire(_at(tick), [&](FakeTask &t) {
+            evals++;
+            queue.push(t);
+        });
+
+        // Run one task, half of them go back to sleep afterward.
+        auto *t = queue.pop();
+        expect$(t != nullptr);
+        evals++;
+        if (t->id % 2)
+            queue.sleep(*t, deadline(t->id, tick));
+        else
+            queue.push(*t);
+    }
+
+    expectEq$(queue.ready() + queue.sleeping(), TASKS);
+    expect$(evals < TASKS * TICKS / 10);
+
+    return Ok();
+}
+
+} // namespace Karm::Base::Tests
@@ -0,0 +1,55 @@
+#include <karm-base/string.h>
+#include <karm-test/macros.h>
+
+namespace Karm::Base::Tests {
+
+test$(utf8AsciiLen) {
+    Str str = "hello, world! héhé";
+    expectEq$(Utf8::asciiLen(str.buf(), str.len()), 15uz);
+
+    Str ascii = "0123456789abcdefghijklmnopqrstuvwxyz";
+    expectEq$(Utf8::asciiLen(ascii.buf(), ascii.len()), ascii.len());
+
+    return Ok();
+}
+
+test$(utf8Validate) {
+    usize runes = 0;
+
+    Str valid = "hello, wörld! 👋";
+    expect$(Utf8::validate(valid.buf(), valid.len(), runes));
+    expectEq$(runes, 15uz);
+
+    char const truncated[] = {'a', (char)0xe2, (char)0x82};
+    expectNot$(Utf8::validate(truncated, sizeof(truncated), runes));
+
+    char const overlong[] = {(char)0xc0, (char)0xaf};
+    expectNot$(Utf8::validate(overlong, sizeof(overlong), runes));
+
+    char const surrogate[] = {(char)0xed, (char)0xa0, (char)0x80};
+    expectNot$(Utf8::validate(surrogate, sizeof(surrogate), runes));
+
+    char const stray[] = {'a', (char)0x80, 'b'};
+    expectNot$(Utf8::validate(stray, sizeof(stray), runes));
+
+    return Ok();
+}
+
+test$(stringBuilder) {
+    StringBuilder sb;
+    for (usize i = 0; i < 100; i++) {
+        sb.append(Str{"ab"});
+    }
+    sb.append(U'é');
+
+    expectEq$(sb.len(), 202uz);
+    expectGteq$(sb._buf.cap(), sb.len());
+
+    String str = sb.take();
+    expectEq$(str.len(), 202uz);
+    expectEq$(str[str.len()], '\0');
+
+    return Ok();
+}
+
+} // namespace Karm::Base::Tests
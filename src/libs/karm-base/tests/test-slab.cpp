@@ -0,0 +1,185 @@
+#include <karm-base/buf.h>
+#include <karm-base/slab.h>
+#include <karm-base/vec.h>
+#include <karm-sys/thread.h>
+#include <karm-test/macros.h>
+
+namespace Karm::Base::Tests {
+
+static thread_local usize _cpu = 0;
+
+// Hands out pages from a fixed arena, like the kernel does from the pmm.
+struct ArenaSlabs : public SlabBackend {
+    Buf<u8> _arena;
+    Lock _freeLock;
+    Vec<void *> _free;
+    usize _pages = 0;
+
+    ArenaSlabs(usize pages)
+        : _arena(Buf<u8>::init((pages + 1) * Slab::PAGE)) {
+        auto base = alignUp(reinterpret_cast<usize>(_arena.buf()), Slab::PAGE);
+        for (usize i = 0; i < pages; i++)
+            _free.pushBack(reinterpret_cast<void *>(base + i * Slab::PAGE));
+    }
+
+    void *allocPage() override {
+        LockScope scope(_freeLock);
+        if (_free.len() == 0)
+            return nullptr;
+        _pages++;
+        return _free.popBack();
+    }
+
+    void freePage(void *page) override {
+        LockScope scope(_freeLock);
+        _pages--;
+        _free.pushBack(page);
+    }
+
+    usize cpu() override {
+        return _cpu;
+    }
+};
+
+test$(slabAllocFree) {
+    ArenaSlabs backend{16};
+    Slab slab{"test", 24, backend};
+    expectEq$(slab.size(), 32uz);
+
+    Vec<u32 *> objs;
+    for (u32 i = 0; i < 1000; i++) {
+        auto *obj = static_cast<u32 *>(slab.alloc());
+        expect$(obj != nullptr);
+        *obj = i;
+        objs.pushBack(obj);
+    }
+
+    for (u32 i = 0; i < 1000; i++)
+        expectEq$(*objs[i], i);
+
+    expectEq$(slab.stats().used, 1000uz);
+
+    for (auto *obj : objs)
+        slab.free(obj);
+
+    slab.drain();
+    expectEq$(slab.stats().used, 0uz);
+    expectEq$(slab.stats().pages, 0uz);
+
+    // Only the spare page is kept around.
+    expectEq$(backend._pages, 1uz);
+
+    return Ok();
+}
+
+test$(slabOutOfPages) {
+    ArenaSlabs backend{1};
+    Slab slab{"test", 1024, backend};
+
+    usize count = 0;
+    while (slab.alloc())
+        count++;
+
+    expectEq$(count, (Slab::PAGE - Slab::_HEADER) / 1024);
+
+    return Ok();
+}
+
+test$(slabVisit) {
+    ArenaSlabs backend{4};
+    Slab a{"a", 16, backend};
+    Slab b{"b", 64, backend};
+
+    usize count = 0;
+    backend.visit([&](Slab &) {
+        count++;
+    });
+    expectEq$(count, 2uz);
+
+    return Ok();
+}
+
+test$(slabDestroy) {
+    ArenaSlabs backend{16};
+    Slab b{"b", 64, backend};
+
+    {
+        Slab a{"a", 32, backend};
+        Vec<void *> objs;
+        for (usize i = 0; i < 1000; i++)
+            objs.pushBack(a.alloc());
+
+        for (usize i = 0; i < objs.len(); i += 2)
+            a.free(objs[i]);
+
+        expect$(backend._pages > 1);
+    }
+
+    // Every page went back, even the ones with objects still on them.
+    expectEq$(backend._pages, 0uz);
+
+    usize count = 0;
+    Str name = "";
+    backend.visit([&](Slab &s) {
+        name = s._name;
+        count++;
+    });
+    expectEq$(count, 1uz);
+    expectEq$(name, Str{"b"});
+
+    return Ok();
+}
+
+test$(slabThreads) {
+    static constexpr usize THREADS = 4;
+    static constexpr usize ROUNDS = 2000;
+    static constexpr usize BATCH = 64;
+
+    ArenaSlabs backend{256};
+    Slab slab{"test", 48, backend};
+    Atomic<usize> errors{};
+
+    Vec<Strong<Sys::Thread>> threads;
+    for (usize t = 0; t < THREADS; t++) {
+        threads.pushBack(try$(Sys::Thread::spawn([&, t] {
+            _cpu = t;
+            usize *objs[BATCH];
+
+            for (usize r = 0; r < ROUNDS; r++) {
+                for (usize i = 0; i < BATCH; i++) {
+                    objs[i] = static_cast<usize *>(slab.alloc());
+                    if (not objs[i]) {
+                        errors.inc();
+                        return;
+                    }
+                    *objs[i] = (t << 32) | i;
+                }
+
+                // Any object handed out twice would have been overwritten.
+                for (usize i = 0; i < BATCH; i++) {
+                    if (*objs[i] != ((t << 32) | i))
+                        errors.inc();
+                    slab.free(objs[i]);
+                }
+            }
+        })));
+    }
+
+    for (auto &t : threads)
+        try$(t->join());
+
+    expectEq$(errors.load(), 0uz);
+
+    auto stats = slab.stats();
+    expectEq$(stats.allocs, THREADS * ROUNDS * BATCH);
+    expectEq$(stats.frees, THREADS * ROUNDS * BATCH);
+    expectEq$(stats.used, 0uz);
+    expect$(stats.hits > stats.allocs / 2);
+
+    slab.drain();
+    expectEq$(slab.stats().pages, 0uz);
+
+    return Ok();
+}
+
+} // namespace Karm::Base::Tests
@@ -0,0 +1,99 @@
+#include <karm-base/slot-table.h>
+#include <karm-base/vec.h>
+#include <karm-test/macros.h>
+
+namespace Karm::Base::Tests {
+
+test$(slotTableAdd) {
+    SlotTable<usize, 256, 16> table{1};
+
+    // Id 0 is reserved.
+    expectEq$(table.add(10).unwrap(), 1uz);
+    expectEq$(table.add(20).unwrap(), 2uz);
+    expectEq$(table.len(), 2uz);
+
+    expectEq$(*table.get(1), 10uz);
+    expectEq$(*table.get(2), 20uz);
+    expect$(table.get(0) == nullptr);
+    expect$(table.get(3) == nullptr);
+    expect$(table.get(1000) == nullptr);
+
+    return Ok();
+}
+
+test$(slotTableReuse) {
+    SlotTable<usize, 256, 16> table;
+
+    for (usize i = 0; i < 8; i++)
+        expect$(table.add(i));
+
+    expectEq$(table.take(3).unwrap(), 3uz);
+    expectEq$(table.take(5).unwrap(), 5uz);
+    expect$(not table.take(5));
+    expect$(not table.has(3));
+    expectEq$(table.len(), 6uz);
+
+    // The last freed id comes back first.
+    expectEq$(table.add(50).unwrap(), 5uz);
+    expectEq$(table.add(30).unwrap(), 3uz);
+    expectEq$(table.add(80).unwrap(), 8uz);
+
+    return Ok();
+}
+
+test$(slotTableFull) {
+    SlotTable<usize, 32, 16> table;
+
+    for (usize i = 0; i < 32; i++)
+        expectEq$(table.add(i).unwrap(), i);
+    expect$(not table.add(32));
+
+    expect$(table.take(17));
+    expectEq$(table.add(17).unwrap(), 17uz);
+
+    return Ok();
+}
+
+test$(slotTablePages) {
+    SlotTable<usize, 256, 16> table;
+
+    // Only the pages that were used are allocated.
+    for (usize i = 0; i < 20; i++)
+        expect$(table.add(i));
+
+    usize pages = 0;
+    for (auto &page : table._pages)
+        if (page)
+            pages++;
+    expectEq$(pages, 2uz);
+
+    return Ok();
+}
+
+// Keeps replacing capabilities in a table that is mostly full, every
+// slot freed must be reused with the others left untouched.
+test$(slotTableChurn) {
+    static constexpr usize LEN = 256;
+    static constexpr usize LIVE = 200;
+    static constexpr usize OPS = 2000;
+
+    SlotTable<usize, LEN> table{1};
+    Vec<usize> live;
+
+    for (usize i = 0; i < LIVE; i++)
+        live.pushBack(table.add(i).unwrap());
+
+    for (usize i = 0; i < OPS; i++) {
+        usize victim = (i * 7919) % LIVE;
+        expectEq$(table.take(live[victim]).unwrap(), victim);
+        live[victim] = table.add(victim).unwrap();
+    }
+
+    expectEq$(table.len(), LIVE);
+    for (usize i = 0; i < LIVE; i++)
+        expectEq$(*table.get(live[i]), i);
+
+    return Ok();
+}
+
+} // namespace Karm::Base::Tests
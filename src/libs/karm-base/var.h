@@ -180,6 +180,18 @@ struct Var {
             });
         return std::partial_ordering::unordered;
     }
+
+    // Alternatives that can't be compared are never equal.
+    bool operator==(Var const &other) const {
+        if (_index != other._index)
+            return false;
+        return visit([&]<typename T>(T const &ptr) {
+            if constexpr (Meta::Equatable<T>)
+                return ptr == other.unwrap<T>();
+            else
+                return false;
+        });
+    }
 };
 
 template <typename... Ts>
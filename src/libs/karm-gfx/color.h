@@ -35,6 +35,8 @@ struct Color {
     ALWAYS_INLINE constexpr Color(Math::Vec4u v)
         : red(v.x), green(v.y), blue(v.z), alpha(v.w) {}
 
+    ALWAYS_INLINE constexpr bool operator==(Color const &) const = default;
+
     ALWAYS_INLINE constexpr Color blendOver(Color const background) const {
         if (alpha == 0xff) {
             return *this;
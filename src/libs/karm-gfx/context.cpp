@@ -9,6 +9,7 @@ namespace Karm::Gfx {
 
 void Context::begin(MutPixels p) {
     _pixels = p;
+    _readBack = false;
     _stack.pushBack({
         .clip = pixels().bound(),
     });
@@ -57,6 +58,14 @@ void Context::restore() {
     _updateTransform();
 }
 
+void Context::record(DisplayList &list) {
+    _record = &list;
+}
+
+void Context::stopRecording() {
+    _record = nullptr;
+}
+
 /* --- Origin & Clipping ---------------------------------------------------- */
 
 Math::Recti Context::clip() const {
@@ -164,6 +173,12 @@ void Context::clear(Color color) { clear(pixels().bound(), color); }
 
 void Context::clear(Math::Recti rect, Color color) {
     rect = applyAll(rect);
+
+    if (_record) {
+        _record->add(DisplayList::Clear{rect, color});
+        return;
+    }
+
     mutPixels()
         .clip(rect)
         .clear(color);
@@ -177,6 +192,26 @@ void Context::clear(Math::Recti rect, Color color) {
     destRect = applyOrigin(destRect);
     auto clipDest = applyClip(destRect);
 
+    // Same size, no need to resample, this is what moving
+    // cached layers around boils down to.
+    if (srcRect.wh == destRect.wh) {
+        auto off = srcRect.xy - destRect.xy;
+        for (isize y = clipDest.y; y < clipDest.y + clipDest.height; ++y) {
+            u8 const *srcPx = static_cast<u8 const *>(src.pixelUnsafe({clipDest.x + off.x, y + off.y}));
+            u8 *destPx = static_cast<u8 *>(dest.pixelUnsafe({clipDest.x, y}));
+            for (isize x = 0; x < clipDest.width; ++x) {
+                auto srcC = srcFmt.load(srcPx);
+                if (srcC.alpha == 255)
+                    destFmt.store(destPx, srcC);
+                else if (srcC.alpha)
+                    destFmt.store(destPx, srcC.blendOver(destFmt.load(destPx)));
+                srcPx += srcFmt.bpp();
+                destPx += destFmt.bpp();
+            }
+        }
+        return;
+    }
+
     auto hratio = srcRect.height / (f64)destRect.height;
     auto wratio = srcRect.width / (f64)destRect.width;
 
@@ -202,6 +237,17 @@ void Context::clear(Math::Recti rect, Color color) {
 }
 
 void Context::blit(Math::Recti src, Math::Recti dest, Pixels p) {
+    if (_record) {
+        _record->add(DisplayList::Blit{
+            .bound = applyAll(dest),
+            .clip = clip(),
+            .pixels = p,
+            .src = src,
+            .dest = applyOrigin(dest),
+        });
+        return;
+    }
+
     auto d = mutPixels();
     d.fmt().visit([&](auto dfmt) {
         p.fmt().visit([&](auto pfmt) {
@@ -242,6 +288,12 @@ void Context::stroke(Math::Recti r, BorderRadius radius) {
 
 [[gnu::flatten]] void Context::_fillRect(Math::Recti r, Gfx::Color color) {
     r = applyAll(r);
+
+    if (_record) {
+        _record->add(DisplayList::Rect{r, color});
+        return;
+    }
+
     if (color.alpha == 255) {
         mutPixels()
             .clip(r)
@@ -370,6 +422,13 @@ void Context::fill(Math::Vec2f baseline, Str str) {
 
 void Context::debugPlot(Math::Vec2i point, Color color) {
     point = applyOrigin(point);
+
+    if (_record) {
+        if (clip().contains(point))
+            _record->add(DisplayList::Plot{Math::Recti{point, {1, 1}}, color});
+        return;
+    }
+
     if (clip().contains(point)) {
         mutPixels().blend(point, color);
     }
@@ -458,7 +517,7 @@ void Context::debugTrace(Gfx::Color color) {
 
 /* --- Paths ---------------------------------------------------------------- */
 
-[[gnu::flatten]] void Context::_fillImpl(auto paint, auto format, FillRule fillRule) {
+[[gnu::flatten]] void Context::_fillImpl(auto const &paint, auto format, FillRule fillRule) {
     _rast.fill(clip(), fillRule, [&](Rast::Frag frag) {
         u8 *pixel = static_cast<u8 *>(mutPixels().pixelUnsafe(frag.xy));
         auto color = paint.sample(frag.uv);
@@ -468,7 +527,7 @@ void Context::debugTrace(Gfx::Color color) {
     });
 }
 
-[[gnu::flatten]] void Context::_FillSmoothImpl(auto paint, auto format, FillRule fillRule) {
+[[gnu::flatten]] void Context::_FillSmoothImpl(auto const &paint, auto format, FillRule fillRule) {
     Math::Vec2f last = {0, 0};
     auto fillComponent = [&](auto comp, Math::Vec2f pos) {
         _rast.shape().offset(pos - last);
@@ -487,8 +546,32 @@ void Context::debugTrace(Gfx::Color color) {
     fillComponent(Color::BLUE_COMPONENT, _lcdLayout.blue);
 }
 
-void Context::_fill(Paint paint, FillRule fillRule) {
-    paint.visit([&](auto paint) {
+void Context::_fill(Paint const &paint, FillRule fillRule) {
+    if (_record) {
+        // NOTE: Subpixel antialiasing samples the shape slightly
+        //       offset on each component, hence the extra margin.
+        auto bound = _rast.shape()
+                         .bound()
+                         .grow(_useSpaa ? 1.0 : 0.3)
+                         .ceil()
+                         .cast<isize>()
+                         .clipTo(clip());
+
+        if (bound.width > 0 and bound.height > 0) {
+            _record->add(DisplayList::Fill{
+                .bound = bound,
+                .clip = clip(),
+                .shape = _rast.shape(),
+                .paint = paint,
+                .rule = fillRule,
+                .smooth = _useSpaa,
+                .lcd = _lcdLayout,
+            });
+        }
+        return;
+    }
+
+    paint.visit([&](auto const &paint) {
         pixels().fmt().visit([&](auto format) {
             if (_useSpaa)
                 _FillSmoothImpl(paint, format, fillRule);
@@ -588,6 +671,12 @@ void Context::apply(Filter filter) {
 }
 
 void Context::apply(Filter filter, Math::Recti r) {
+    _readBack = true;
+    if (_record) {
+        _record->invalidate();
+        return;
+    }
+
     filter.apply(mutPixels().clip(applyAll(r)));
 }
 
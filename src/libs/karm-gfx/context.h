@@ -4,6 +4,7 @@
 
 #include "buffer.h"
 #include "filters.h"
+#include "list.h"
 #include "paint.h"
 #include "path.h"
 #include "rast.h"
@@ -11,17 +12,6 @@
 
 namespace Karm::Gfx {
 
-struct LcdLayout {
-    Math::Vec2f red;
-    Math::Vec2f green;
-    Math::Vec2f blue;
-};
-
-static LcdLayout RGB = {{+0.33, 0.0}, {0.0, 0.0}, {-0.33, 0.0}};
-static LcdLayout BGR = {{-0.33, 0.0}, {0.0, 0.0}, {+0.33, 0.0}};
-static LcdLayout VRGB = {{0.0, +0.33}, {0.0, 0.0}, {0.0, -0.33}};
-
-
 struct Context {
     struct Scope {
         Paint paint = Gfx::WHITE;
@@ -44,6 +34,11 @@ struct Context {
     Rast _rast{};
     LcdLayout _lcdLayout = RGB;
     bool _useSpaa = false;
+    DisplayList *_record = nullptr;
+
+    // Set once something read back the pixels it draws over (layers,
+    // filters) since begin(), a recording of it couldn't be replayed.
+    bool _readBack = false;
 
     /* --- Scope ------------------------------------------------------------ */
 
@@ -71,6 +66,13 @@ struct Context {
     // Pop the current scope.
     void restore();
 
+    // Record the raster operations into the given list instead of
+    // drawing them, the pixels are only used for their size and format.
+    void record(DisplayList &list);
+
+    // Go back to drawing into the pixels.
+    void stopRecording();
+
     // A closure that receives a new Context as input.This context represents a
     // new transparency layer that you can draw into.When the closure returns,
     // karm-ui draws the new layer into the current context.
@@ -82,6 +84,12 @@ struct Context {
     // new transparency layer that you can draw into.When the closure returns,
     // karm-ui draws the new layer into the current context.
     void layer(Math::Vec2i offset, auto inner) {
+        _readBack = true;
+        if (_record) {
+            _record->invalidate();
+            return;
+        }
+
         auto old = mutPixels();
         auto layer = Media::Image::alloc(
             pixels().size(),
@@ -272,9 +280,9 @@ struct Context {
 
     // (internal) Fill the current shape with the given paint.
     // NOTE: The shape must be flattened before calling this function.
-    void _fillImpl(auto paint, auto format, FillRule fillRule);
-    void _FillSmoothImpl(auto paint, auto format, FillRule fillRule);
-    void _fill(Paint paint, FillRule rule = FillRule::NONZERO);
+    void _fillImpl(auto const &paint, auto format, FillRule fillRule);
+    void _FillSmoothImpl(auto const &paint, auto format, FillRule fillRule);
+    void _fill(Paint const &paint, FillRule rule = FillRule::NONZERO);
 
     // Begin a new path.
     void begin();
@@ -0,0 +1,58 @@
+#include "list.h"
+
+#include "context.h"
+
+namespace Karm::Gfx {
+
+void DisplayList::replay(Context &g, Math::Recti region) const {
+    for (auto const &cmd : _commands) {
+        cmd.visit(Visitor{
+            [&](Clear const &c) {
+                if (not c.bound.colide(region))
+                    return;
+
+                g.mutPixels()
+                    .clip(c.bound.clipTo(region))
+                    .clear(c.color);
+            },
+            [&](Rect const &r) {
+                if (not r.bound.colide(region))
+                    return;
+
+                g.save();
+                g.current().clip = region;
+                g._fillRect(r.bound, r.color);
+                g.restore();
+            },
+            [&](Fill const &f) {
+                if (not f.bound.colide(region))
+                    return;
+
+                g.save();
+                g.current().clip = f.clip.clipTo(region);
+                g._rast.clear();
+                g._rast._shape = f.shape;
+                g._useSpaa = f.smooth;
+                g._lcdLayout = f.lcd;
+                g._fill(f.paint, f.rule);
+                g._useSpaa = false;
+                g.restore();
+            },
+            [&](Blit const &b) {
+                if (not b.bound.colide(region))
+                    return;
+
+                g.save();
+                g.current().clip = b.clip.clipTo(region);
+                g.blit(b.src, b.dest, b.pixels);
+                g.restore();
+            },
+            [&](Plot const &p) {
+                if (region.contains(p.bound.xy))
+                    g.mutPixels().blend(p.bound.xy, p.color);
+            },
+        });
+    }
+}
+
+} // namespace Karm::Gfx
@@ -0,0 +1,90 @@
+#pragma once
+
+#include <karm-base/var.h>
+#include <karm-base/vec.h>
+
+#include "buffer.h"
+#include "paint.h"
+#include "rast.h"
+#include "style.h"
+
+namespace Karm::Gfx {
+
+struct Context;
+
+// A flat list of the raster operations issued to a recording context.
+// Every command is already in device space and carries the bound of the
+// pixels it touches, so it can be replayed over any sub-region of the
+// target, possibly from several threads at once as long as the regions
+// don't overlap.
+struct DisplayList {
+    struct Clear {
+        Math::Recti bound;
+        Color color;
+    };
+
+    struct Rect {
+        Math::Recti bound;
+        Color color;
+    };
+
+    struct Fill {
+        Math::Recti bound;
+        Math::Recti clip;
+        Shape shape;
+        Paint paint;
+        FillRule rule;
+        bool smooth;
+        LcdLayout lcd;
+    };
+
+    // NOTE: The source pixels are borrowed, they must outlive the list.
+    struct Blit {
+        Math::Recti bound;
+        Math::Recti clip;
+        Pixels pixels;
+        Math::Recti src;
+        Math::Recti dest;
+    };
+
+    struct Plot {
+        Math::Recti bound;
+        Color color;
+    };
+
+    using Command = Var<Clear, Rect, Fill, Blit, Plot>;
+
+    Vec<Command> _commands;
+
+    // Set when an operation that reads back the pixels it draws over
+    // (layers, filters) was recorded, such operations can't be split
+    // across regions and the list must not be replayed.
+    bool _replayable = true;
+
+    usize len() const {
+        return _commands.len();
+    }
+
+    bool replayable() const {
+        return _replayable;
+    }
+
+    void clear() {
+        _commands.clear();
+        _replayable = true;
+    }
+
+    void add(Command cmd) {
+        _commands.pushBack(std::move(cmd));
+    }
+
+    void invalidate() {
+        _replayable = false;
+    }
+
+    // Replay the commands touching the given region into the context,
+    // leaving the pixels outside of it untouched.
+    void replay(Context &g, Math::Recti region) const;
+};
+
+} // namespace Karm::Gfx
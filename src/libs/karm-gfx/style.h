@@ -26,6 +26,8 @@ struct BorderRadius {
 
     BorderRadius(f64 topLeft, f64 topRight, f64 bottomRight, f64 bottomLeft)
         : topLeft(topLeft), topRight(topRight), bottomRight(bottomRight), bottomLeft(bottomLeft) {}
+
+    bool operator==(BorderRadius const &) const = default;
 };
 
 /* --- Stroke Style --------------------------------------------------------- */
@@ -116,10 +118,24 @@ struct ShadowStyle {
         offset = o;
         return *this;
     }
+
+    bool operator==(ShadowStyle const &) const = default;
 };
 
 inline ShadowStyle shadow(auto... args) {
     return ShadowStyle(args...);
 }
 
+/* --- Lcd Layout ---------------------------------------------------------- */
+
+struct LcdLayout {
+    Math::Vec2f red;
+    Math::Vec2f green;
+    Math::Vec2f blue;
+};
+
+static LcdLayout RGB = {{+0.33, 0.0}, {0.0, 0.0}, {-0.33, 0.0}};
+static LcdLayout BGR = {{-0.33, 0.0}, {0.0, 0.0}, {+0.33, 0.0}};
+static LcdLayout VRGB = {{0.0, +0.33}, {0.0, 0.0}, {0.0, -0.33}};
+
 } // namespace Karm::Gfx
@@ -146,12 +146,8 @@ struct BufferWriter : public Writer, public Flusher {
     BufferWriter(usize cap = 16) : _buf(cap) {}
 
     Res<usize> write(Bytes bytes) override {
-        usize written = 0;
-        for (auto byte : iter(bytes)) {
-            _buf.insert(_buf.len(), std::move(byte));
-            written += 1;
-        }
-        return Ok(written);
+        _buf.insert(COPY, _buf.len(), bytes.buf(), bytes.len());
+        return Ok(bytes.len());
     }
 
     Bytes bytes() const {
@@ -198,15 +194,24 @@ struct BitReader {
 
 template <StaticEncoding E>
 struct _StringWriter : public TextWriter {
-    Buf<typename E::Unit> _buf{};
+    _StringBuilder<E> _builder;
 
-    _StringWriter(usize cap = 16) : _buf(cap) {}
+    _StringWriter(usize cap = 16) : _builder(cap) {}
 
     Res<usize> write(Bytes) override {
         panic("can't write raw bytes to a string");
     }
 
     Res<usize> writeStr(Str str) override {
+        if constexpr (Meta::Same<E, Utf8>) {
+            // Fast path: well-formed input can be copied as is.
+            usize runes;
+            if (Utf8::validate(str.buf(), str.len(), runes)) {
+                _builder.append(str);
+                return Ok(runes);
+            }
+        }
+
         usize written = 0;
         for (auto rune : iterRunes(str)) {
             written += try$(writeRune(rune));
@@ -220,27 +225,21 @@ struct _StringWriter : public TextWriter {
             return Error::invalidInput("invalid rune");
         }
 
-        for (auto unit : iter(one)) {
-            _buf.insert(_buf.len(), std::move(unit));
-        }
-
+        _builder.append(Slice<typename E::Unit>{one.buf(), one.len()});
         return Ok(1uz);
     }
 
     Res<usize> writeUnit(Slice<typename E::Unit> unit) {
-        _buf.insert(COPY, _buf.len(), unit.buf(), unit.len());
+        _builder.append(unit);
         return Ok(unit.len());
     }
 
-    Str str() {
-        return _buf;
+    _Str<E> str() {
+        return _builder.str();
     }
 
-    String take() {
-        usize len = _buf.size();
-        _buf.insert(len, 0);
-
-        return String{MOVE, _buf.take(), len};
+    _String<E> take() {
+        return _builder.take();
     }
 };
 
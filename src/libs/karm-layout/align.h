@@ -37,6 +37,8 @@ struct Align {
 
     Align(u16 value = 0) : _value(value) {}
 
+    bool operator==(Align const &) const = default;
+
     template <typename T>
     Math::Rect<T> apply(Flow flow, Math::Rect<T> inner, Math::Rect<T> outer) {
         if (_value == NONE)
@@ -28,6 +28,8 @@ struct Flow {
 
     Flow(_Flow flow) : _flow(flow) {}
 
+    bool operator==(Flow const &) const = default;
+
     Orien orien() const {
         return (_flow == LEFT_TO_RIGHT or _flow == RIGHT_TO_LEFT)
                    ? Orien::HORIZONTAL
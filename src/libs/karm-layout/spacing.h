@@ -22,6 +22,8 @@ struct Spacing {
     constexpr Spacing(T start, T top, T end, T bottom)
         : start(start), top(top), end(end), bottom(bottom) {}
 
+    constexpr bool operator==(Spacing const &) const = default;
+
     constexpr Math::Rect<T> shrink(Flow flow, Math::Rect<T> rect) const {
         rect = flow.setStart(rect, flow.getStart(rect) + start);
         rect = flow.setTop(rect, flow.getTop(rect) + top);
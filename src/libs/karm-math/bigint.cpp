@@ -1,48 +1,276 @@
+#include <karm-base/bits.h>
+
 #include "bigint.h"
 
 namespace Karm::Math {
 
-/* --- Unsigned Big Integer ------------------------------------------------- */
+/* --- Limbs --------------------------------------------------------------- */
 
-void _add(UBig &lhs, usize rhs) {
-    // FIXME: make this more efficient, right now we are
-    //        allocating a new UBig for every increment
-    UBig rhsBig{rhs};
-    _add(lhs, rhsBig);
+// Kernels working on little endian arrays of limbs, they
+// leave allocating and trimming to their callers.
+
+// Below this many limbs, schoolbook multiplication wins.
+static constexpr usize KARATSUBA_THRESHOLD = 32;
+
+static usize _limbs(UBig const &value) {
+    usize len = value._len();
+    while (len > 0 and value._value[len - 1] == 0)
+        len--;
+    return len;
 }
 
-void _add(UBig &lhs, UBig const &rhs) {
-    auto lhsLen = lhs._len();
-    auto rhsLen = rhs._len();
+static void _copyLimbs(usize *dst, usize const *src, usize n) {
+    for (usize i = 0; i < n; i++)
+        dst[i] = src[i];
+}
+
+static bool _lessLimbs(usize const *lhs, usize const *rhs, usize n) {
+    for (usize i = n; i-- > 0;)
+        if (lhs[i] != rhs[i])
+            return lhs[i] < rhs[i];
+    return false;
+}
+
+// dst[0..n) += src[0..n), returns the carry.
+static usize _addLimbs(usize *dst, usize const *src, usize n) {
+    usize carry = 0;
+    for (usize i = 0; i < n; i++) {
+        u128 sum = (u128)dst[i] + src[i] + carry;
+        dst[i] = (usize)sum;
+        carry = (usize)(sum >> BITS<usize>);
+    }
+    return carry;
+}
+
+// dst[0..n) -= src[0..n), returns the borrow.
+static usize _subLimbs(usize *dst, usize const *src, usize n) {
+    usize borrow = 0;
+    for (usize i = 0; i < n; i++) {
+        u128 diff = (u128)dst[i] - src[i] - borrow;
+        dst[i] = (usize)diff;
+        borrow = (usize)(diff >> BITS<usize>) & 1;
+    }
+    return borrow;
+}
+
+// Adds src to dst and carries through the rest of it, the limbs
+// of src past the end of dst must be zero.
+static void _addInto(usize *dst, usize dn, usize const *src, usize sn) {
+    usize n = min(dn, sn);
+    usize carry = _addLimbs(dst, src, n);
+    for (usize i = n; carry and i < dn; i++) {
+        dst[i]++;
+        carry = dst[i] == 0;
+    }
+}
+
+// Subtracts src from dst and borrows through the rest of it,
+// src must not be greater than dst.
+static void _subFrom(usize *dst, usize dn, usize const *src, usize sn) {
+    usize n = min(dn, sn);
+    usize borrow = _subLimbs(dst, src, n);
+    for (usize i = n; borrow and i < dn; i++) {
+        borrow = dst[i] == 0;
+        dst[i]--;
+    }
+}
 
+// dst[0..n) += src[0..n) * m, returns the carry.
+static usize _mulAddLimb(usize *dst, usize const *src, usize n, usize m) {
     usize carry = 0;
-    for (size_t i = 0; i < rhsLen; ++i) {
-        usize curr = 0;
-        if (willAddOverflow(rhs._value[i], lhs._value[i]))
-            curr = 1;
+    for (usize i = 0; i < n; i++) {
+        u128 prod = (u128)src[i] * m + dst[i] + carry;
+        dst[i] = (usize)prod;
+        carry = (usize)(prod >> BITS<usize>);
+    }
+    return carry;
+}
 
-        usize res = rhs._value[i] + lhs._value[i];
-        if (willAddOverflow(res, carry))
-            curr = 1;
+// dst[0..n] -= src[0..n) * m, returns the borrow.
+static usize _mulSubLimb(usize *dst, usize const *src, usize n, usize m) {
+    usize carry = 0;
+    usize borrow = 0;
+    for (usize i = 0; i < n; i++) {
+        u128 prod = (u128)src[i] * m + carry;
+        carry = (usize)(prod >> BITS<usize>);
+        u128 diff = (u128)dst[i] - (usize)prod - borrow;
+        dst[i] = (usize)diff;
+        borrow = (usize)(diff >> BITS<usize>) & 1;
+    }
+    u128 diff = (u128)dst[n] - carry - borrow;
+    dst[n] = (usize)diff;
+    return (usize)(diff >> BITS<usize>) & 1;
+}
 
-        res += carry;
-        carry = curr;
-        lhs._value[i] = res;
+// dst[0..n) = src[0..n) << bits, returns the bits shifted out.
+static usize _shlLimbs(usize *dst, usize const *src, usize n, usize bits) {
+    if (bits == 0) {
+        _copyLimbs(dst, src, n);
+        return 0;
     }
 
-    while (carry && lhsLen > rhsLen) {
-        usize curr = 0;
-        if (willAddOverflow(lhs._value[rhsLen], carry))
-            curr = 1;
+    usize carry = 0;
+    for (usize i = 0; i < n; i++) {
+        usize value = src[i];
+        dst[i] = (value << bits) | carry;
+        carry = value >> (BITS<usize> - bits);
+    }
+    return carry;
+}
 
-        lhs._value[rhsLen] += carry;
-        carry = curr;
-        rhsLen++;
+// dst[0..n) = src[0..n] >> bits, with bits less than a limb.
+static void _shrLimbs(usize *dst, usize const *src, usize n, usize bits) {
+    if (bits == 0) {
+        _copyLimbs(dst, src, n);
+        return;
     }
 
-    if (carry) {
-        lhs._value.pushBack(carry);
+    for (usize i = 0; i < n; i++)
+        dst[i] = (src[i] >> bits) | (src[i + 1] << (BITS<usize> - bits));
+}
+
+// q[0..n) = u[0..n) / v, returns the remainder, q may be u.
+static usize _divLimb(usize *q, usize const *u, usize n, usize v) {
+    u128 rem = 0;
+    for (usize i = n; i-- > 0;) {
+        u128 curr = (rem << BITS<usize>) | u[i];
+        q[i] = (usize)(curr / v);
+        rem = curr % v;
     }
+    return (usize)rem;
+}
+
+// dst[0..an+bn) = a * b, with dst zeroed.
+static void _mulSchool(usize *dst, usize const *a, usize an, usize const *b, usize bn) {
+    for (usize i = 0; i < bn; i++)
+        dst[i + an] = _mulAddLimb(dst + i, a, an, b[i]);
+}
+
+// dst[0..an+bn) = a * b, with dst zeroed.
+static void _mulLimbs(usize *dst, usize const *a, usize an, usize const *b, usize bn) {
+    if (an < bn) {
+        std::swap(a, b);
+        std::swap(an, bn);
+    }
+
+    if (bn == 0)
+        return;
+
+    if (bn < KARATSUBA_THRESHOLD) {
+        _mulSchool(dst, a, an, b, bn);
+        return;
+    }
+
+    // Much longer than the other one, multiply it slice by slice.
+    if (an >= 2 * bn) {
+        Vec<usize> tmp;
+        for (usize i = 0; i < an; i += bn) {
+            usize len = min(bn, an - i);
+            tmp.clear();
+            tmp.resize(len + bn, 0);
+            _mulLimbs(tmp.buf(), a + i, len, b, bn);
+            _addInto(dst + i, an + bn - i, tmp.buf(), len + bn);
+        }
+        return;
+    }
+
+    // Karatsuba: with a = a1·Bᵐ + a0 and b = b1·Bᵐ + b0,
+    // a·b = z2·B²ᵐ + (z1 - z2 - z0)·Bᵐ + z0
+    // where z0 = a0·b0, z2 = a1·b1 and z1 = (a0 + a1)·(b0 + b1).
+    usize m = an / 2;
+    _mulLimbs(dst, a, m, b, m);
+    _mulLimbs(dst + 2 * m, a + m, an - m, b + m, bn - m);
+
+    Vec<usize> sa;
+    sa.resize(an - m + 1, 0);
+    _copyLimbs(sa.buf(), a + m, an - m);
+    _addInto(sa.buf(), sa.len(), a, m);
+
+    Vec<usize> sb;
+    sb.resize(max(m, bn - m) + 1, 0);
+    _copyLimbs(sb.buf(), b, m);
+    _addInto(sb.buf(), sb.len(), b + m, bn - m);
+
+    usize san = sa.len();
+    while (san > 0 and sa[san - 1] == 0)
+        san--;
+    usize sbn = sb.len();
+    while (sbn > 0 and sb[sbn - 1] == 0)
+        sbn--;
+
+    Vec<usize> z1;
+    z1.resize(sa.len() + sb.len(), 0);
+    _mulLimbs(z1.buf(), sa.buf(), san, sb.buf(), sbn);
+    _subFrom(z1.buf(), z1.len(), dst, 2 * m);
+    _subFrom(z1.buf(), z1.len(), dst + 2 * m, an + bn - 2 * m);
+    _addInto(dst + m, an + bn - m, z1.buf(), z1.len());
+}
+
+// Knuth's algorithm D (TAOCP vol. 2, 4.3.1): u has un limbs, v has
+// n ≥ 2 with the top one non-zero, q gets un - n + 1 and r gets n.
+static void _divKnuth(usize *q, usize *r, usize const *u, usize un, usize const *v, usize n) {
+    // Normalize so that the top bit of the divisor is set, the
+    // estimated quotient limbs are then at most two off.
+    usize shift = clz(v[n - 1]);
+
+    Vec<usize> vn;
+    vn.resize(n, 0);
+    _shlLimbs(vn.buf(), v, n, shift);
+
+    Vec<usize> nu;
+    nu.resize(un + 1, 0);
+    nu[un] = _shlLimbs(nu.buf(), u, un, shift);
+
+    usize top = vn[n - 1];
+    usize next = vn[n - 2];
+
+    for (usize j = un - n + 1; j-- > 0;) {
+        u128 num = ((u128)nu[j + n] << BITS<usize>) | nu[j + n - 1];
+        u128 qhat = num / top;
+        u128 rhat = num % top;
+
+        while ((qhat >> BITS<usize>) or
+               qhat * next > ((rhat << BITS<usize>) | nu[j + n - 2])) {
+            qhat--;
+            rhat += top;
+            if (rhat >> BITS<usize>)
+                break;
+        }
+
+        // Still one too many, add the divisor back.
+        if (_mulSubLimb(nu.buf() + j, vn.buf(), n, (usize)qhat)) {
+            qhat--;
+            nu[j + n] += _addLimbs(nu.buf() + j, vn.buf(), n);
+        }
+
+        q[j] = (usize)qhat;
+    }
+
+    _shrLimbs(r, nu.buf(), n, shift);
+}
+
+/* --- Unsigned Big Integer ------------------------------------------------- */
+
+void _add(UBig &lhs, usize rhs) {
+    // FIXME: make this more efficient, right now we are
+    //        allocating a new UBig for every increment
+    UBig rhsBig{rhs};
+    _add(lhs, rhsBig);
+}
+
+void _add(UBig &lhs, UBig const &rhs) {
+    usize n = rhs._len();
+    if (lhs._len() < n)
+        lhs._value.resize(n, 0);
+
+    usize carry = _addLimbs(lhs._value.buf(), rhs._value.buf(), n);
+    for (usize i = n; carry and i < lhs._len(); i++) {
+        lhs._value[i]++;
+        carry = lhs._value[i] == 0;
+    }
+
+    if (carry)
+        lhs._value.pushBack(carry);
 }
 
 SubResult _sub(UBig &lhs, usize rhs) {
@@ -53,34 +281,14 @@ SubResult _sub(UBig &lhs, usize rhs) {
 }
 
 SubResult _sub(UBig &lhs, UBig const &rhs) {
-    u8 borrow = 0;
-    for (size_t i = 0; i < lhs._len(); i++) {
-        usize rhsV = i < rhs._len()
-                         ? rhs._value[i]
-                         : 0;
-
-        usize lhsV = lhs._value[i];
-
-        // apply the borrow
-        if (borrow) {
-            if (lhsV == 0) {
-                lhsV = MAX<usize>;
-                borrow = 1;
-            } else {
-                lhsV--;
-                borrow = 0;
-            }
-        }
-
-        // do we need to borrow?
-        if (lhsV < rhsV) {
-            rhsV -= lhsV;
-            lhsV = (MAX<usize> - rhsV) + 1;
-            borrow = 1;
-        }
-
-        lhsV -= rhsV;
-        lhs._value[i] = lhsV;
+    usize n = _limbs(rhs);
+    if (lhs._len() < n)
+        lhs._value.resize(n, 0);
+
+    usize borrow = _subLimbs(lhs._value.buf(), rhs._value.buf(), n);
+    for (usize i = n; borrow and i < lhs._len(); i++) {
+        borrow = lhs._value[i] == 0;
+        lhs._value[i]--;
     }
 
     if (borrow)
@@ -90,32 +298,45 @@ SubResult _sub(UBig &lhs, UBig const &rhs) {
 }
 
 void _shl(UBig &lhs, usize bits) {
-    if (lhs == 0 or bits == 0)
+    usize len = lhs._len();
+    if (len == 0 or bits == 0)
         return;
 
-    usize carry = 0;
+    usize limbs = bits / BITS<usize>;
+    bits %= BITS<usize>;
 
-    for (usize i = 0; i < lhs._len(); ++i) {
-        usize value = lhs._value[i];
-        lhs._value[i] = (value << bits) | carry;
-        carry = value >> (BITS<usize> - bits);
+    // From the top down, so that it can be done in place.
+    lhs._value.resize(len + limbs + 1, 0);
+    auto *buf = lhs._value.buf();
+    for (usize i = len + limbs + 1; i-- > 0;) {
+        usize hi = i >= limbs and i - limbs < len ? buf[i - limbs] : 0;
+        usize lo = bits and i > limbs and i - limbs - 1 < len ? buf[i - limbs - 1] : 0;
+        buf[i] = (hi << bits) | (bits ? lo >> (BITS<usize> - bits) : 0);
     }
 
-    if (carry)
-        lhs._value.pushBack(carry);
+    lhs._trim();
 }
 
 void _shr(UBig &lhs, usize bits) {
-    if (lhs == 0 or bits == 0)
-        return;
+    usize len = lhs._len();
+    usize limbs = bits / BITS<usize>;
+    bits %= BITS<usize>;
 
-    usize carry = 0;
+    if (limbs >= len) {
+        lhs.clear();
+        return;
+    }
 
-    for (usize i = lhs._len(); i-- > 0;) {
-        usize value = lhs._value[i];
-        lhs._value[i] = (value >> bits) | carry;
-        carry = value << (BITS<usize> - bits);
+    auto *buf = lhs._value.buf();
+    for (usize i = 0; i + limbs < len; i++) {
+        usize value = buf[i + limbs] >> bits;
+        if (bits and i + limbs + 1 < len)
+            value |= buf[i + limbs + 1] << (BITS<usize> - bits);
+        buf[i] = value;
     }
+
+    lhs._value.truncate(len - limbs);
+    lhs._trim();
 }
 
 void _binNot(UBig &lhs) {
@@ -145,48 +366,84 @@ void _binXor(UBig &lhs, UBig const &rhs) {
 }
 
 void _mul(UBig &lhs, UBig const &rhs) {
-    UBig shifted = lhs;
-    for (usize wi = 0; wi < rhs._len(); wi++) {
-        for (usize bi = 0; bi < BITS<usize>; bi++) {
-            auto bit = (rhs._value[wi] >> bi) & 1;
-            _shl(shifted, 1);
-            if (not bit)
-                continue;
-            _add(lhs, shifted);
-        }
+    usize an = _limbs(lhs);
+    usize bn = _limbs(rhs);
+    if (an == 0 or bn == 0) {
+        lhs.clear();
+        return;
     }
+
+    // Into a fresh buffer, lhs and rhs may be the same.
+    Vec<usize> res;
+    res.resize(an + bn, 0);
+    _mulLimbs(res.buf(), lhs._value.buf(), an, rhs._value.buf(), bn);
+    lhs._value = std::move(res);
+    lhs._trim();
 }
 
 void _div(UBig const &numerator, UBig const &denominator, UBig &quotient, UBig &remainder) {
-    quotient = 0_ubig;
-    remainder = numerator;
-
-    for (int wi = numerator._len() - 1; wi >= 0; wi--) {
-        for (int bi = BITS<usize> - 1; bi >= 0; bi--) {
-            size_t shift = wi * BITS<usize> + bi;
-            UBig shifted = denominator;
-            _shl(shifted, shift);
-            auto tmp = remainder;
-            if (_sub(tmp, shifted) == SubResult::UNDERFLOW)
-                continue;
-            remainder = tmp;
-            quotient._setBit(shift);
-        }
+    usize un = _limbs(numerator);
+    usize vn = _limbs(denominator);
+
+    if (vn == 0)
+        panic("division by zero");
+
+    if (un < vn) {
+        remainder = numerator;
+        remainder._trim();
+        quotient = 0_ubig;
+        return;
     }
+
+    Vec<usize> q;
+    q.resize(un - vn + 1, 0);
+    Vec<usize> r;
+    r.resize(vn, 0);
+
+    if (vn == 1)
+        r[0] = _divLimb(q.buf(), numerator._value.buf(), un, denominator._value[0]);
+    else
+        _divKnuth(q.buf(), r.buf(), numerator._value.buf(), un, denominator._value.buf(), vn);
+
+    quotient._value = std::move(q);
+    quotient._trim();
+    remainder._value = std::move(r);
+    remainder._trim();
+}
+
+static usize _ctz(UBig const &value) {
+    for (usize i = 0; i < value._len(); i++)
+        if (value._value[i])
+            return i * BITS<usize> + ctz(value._value[i]);
+    return 0;
 }
 
 void _gcd(UBig const &lhs, UBig const &rhs, UBig &gcd) {
-    if (lhs == 0 or rhs == 0)
+    if (_limbs(lhs) == 0 or _limbs(rhs) == 0)
         panic("gcd of zero");
 
-    gcd = lhs;
-    UBig b = rhs;
+    // Stein's algorithm, shifts and subtractions only.
+    UBig a = lhs, b = rhs;
+    usize za = _ctz(a);
+    usize zb = _ctz(b);
+    _shr(a, za);
+    _shr(b, zb);
 
-    while (b != 0_ubig) {
-        UBig tmp = b;
-        b = gcd % b;
-        gcd = tmp;
+    while (true) {
+        // Both are odd here.
+        if (a > b)
+            std::swap(a, b);
+
+        (void)_sub(b, a);
+        b._trim();
+        if (b._len() == 0)
+            break;
+
+        _shr(b, _ctz(b));
     }
+
+    _shl(a, min(za, zb));
+    gcd = std::move(a);
 }
 
 void _pow(UBig const &base, UBig const &exp, UBig &res) {
@@ -201,6 +458,245 @@ void _pow(UBig const &base, UBig const &exp, UBig &res) {
     }
 }
 
+/* --- Modular Exponentiation ----------------------------------------------- */
+
+// -m⁻¹ mod 2⁶⁴ for an odd m, by Newton's iteration. m is its own inverse
+// modulo 8, and each step doubles the number of correct bits.
+static usize _montInverse(usize m) {
+    usize x = m;
+    for (usize i = 0; i < 5; i++)
+        x *= 2 - m * x;
+    return -x;
+}
+
+// out = a·b·B⁻ⁿ mod m, with a and b less than m, and t
+// scratch space for n + 2 limbs.
+static void _montMul(usize *out, usize const *a, usize const *b, usize const *m, usize n, usize inv, usize *t) {
+    for (usize i = 0; i < n + 2; i++)
+        t[i] = 0;
+
+    for (usize i = 0; i < n; i++) {
+        u128 top = (u128)t[n] + _mulAddLimb(t, b, n, a[i]);
+        t[n] = (usize)top;
+        t[n + 1] += (usize)(top >> BITS<usize>);
+
+        // Add a multiple of m that clears the low limb, and drop it.
+        usize u = t[0] * inv;
+        top = (u128)t[n] + _mulAddLimb(t, m, n, u);
+        t[n] = (usize)top;
+        t[n + 1] += (usize)(top >> BITS<usize>);
+
+        for (usize k = 0; k <= n; k++)
+            t[k] = t[k + 1];
+        t[n + 1] = 0;
+    }
+
+    if (t[n] or not _lessLimbs(t, m, n))
+        _subLimbs(t, m, n);
+
+    _copyLimbs(out, t, n);
+}
+
+static void _powModSlow(UBig const &base, UBig const &exp, UBig const &mod, UBig &res) {
+    UBig acc = 1_ubig;
+    for (usize i = exp._len() * BITS<usize>; i-- > 0;) {
+        acc *= acc;
+        acc %= mod;
+        if (exp._getBit(i)) {
+            acc *= base;
+            acc %= mod;
+        }
+    }
+    res = std::move(acc);
+}
+
+void _powMod(UBig const &base, UBig const &exp, UBig const &mod, UBig &res) {
+    usize n = _limbs(mod);
+    if (n == 0)
+        panic("modulo by zero");
+
+    UBig b = base % mod;
+
+    // Montgomery's reduction needs an odd modulus.
+    if (not(mod._value[0] & 1)) {
+        _powModSlow(b, exp, mod, res);
+        return;
+    }
+
+    usize inv = _montInverse(mod._value[0]);
+    usize const *m = mod._value.buf();
+
+    // Into Montgomery form, x·Bⁿ mod m.
+    UBig one = 1_ubig;
+    _shl(one, n * BITS<usize>);
+    one %= mod;
+    _shl(b, n * BITS<usize>);
+    b %= mod;
+
+    Vec<usize> x, a, t, tmp;
+    x.resize(n, 0);
+    _copyLimbs(x.buf(), one._value.buf(), one._len());
+    a.resize(n, 0);
+    _copyLimbs(a.buf(), b._value.buf(), b._len());
+    t.resize(n + 2, 0);
+    tmp.resize(n, 0);
+
+    for (usize i = exp._len() * BITS<usize>; i-- > 0;) {
+        _montMul(tmp.buf(), x.buf(), x.buf(), m, n, inv, t.buf());
+        std::swap(x, tmp);
+        if (exp._getBit(i)) {
+            _montMul(tmp.buf(), x.buf(), a.buf(), m, n, inv, t.buf());
+            std::swap(x, tmp);
+        }
+    }
+
+    // And back out of it.
+    Vec<usize> unit;
+    unit.resize(n, 0);
+    unit[0] = 1;
+    _montMul(tmp.buf(), x.buf(), unit.buf(), m, n, inv, t.buf());
+
+    res._value = std::move(tmp);
+    res._trim();
+}
+
+/* --- Decimal -------------------------------------------------------------- */
+
+// The largest power of ten that fits in a limb.
+static constexpr usize DEC_LIMB = 10000000000000000000uz;
+static constexpr usize DEC_DIGITS = 19;
+
+// Up to this level, chunks are converted limb by limb.
+static constexpr usize DEC_LEAF = 3;
+
+// pows[k] = 10^(19·2ᵏ)
+static void _decPows(Vec<UBig> &pows, usize level) {
+    if (pows.len() == 0)
+        pows.pushBack(UBig{DEC_LIMB});
+    while (pows.len() <= level)
+        pows.pushBack(last(pows) * last(pows));
+}
+
+// Writes exactly 19·2ᵏ digits, padded with zeros, the
+// value must be less than 10^(19·2ᵏ).
+static void _toDec(UBig const &value, Vec<UBig> const &pows, usize level, char *out) {
+    usize digits = DEC_DIGITS << level;
+    usize n = _limbs(value);
+
+    if (n == 0) {
+        for (usize i = 0; i < digits; i++)
+            out[i] = '0';
+        return;
+    }
+
+    if (level <= DEC_LEAF) {
+        Vec<usize> limbs;
+        limbs.resize(n, 0);
+        _copyLimbs(limbs.buf(), value._value.buf(), n);
+
+        for (usize c = 1uz << level; c-- > 0;) {
+            usize chunk = _divLimb(limbs.buf(), limbs.buf(), n, DEC_LIMB);
+            for (usize i = DEC_DIGITS; i-- > 0;) {
+                out[c * DEC_DIGITS + i] = '0' + chunk % 10;
+                chunk /= 10;
+            }
+        }
+        return;
+    }
+
+    // Divide and conquer, each half has half the digits.
+    UBig hi, lo;
+    _div(value, pows[level - 1], hi, lo);
+    _toDec(hi, pows, level - 1, out);
+    _toDec(lo, pows, level - 1, out + digits / 2);
+}
+
+String _toDec(UBig const &value) {
+    usize n = _limbs(value);
+    if (n == 0)
+        return "0";
+
+    // log₁₀(2) < 0.30103, so this never falls short.
+    usize bits = n * BITS<usize> - clz(value._value[n - 1]);
+    usize digits = bits * 30103 / 100000 + 1;
+
+    usize level = 0;
+    while ((DEC_DIGITS << level) < digits)
+        level++;
+
+    Vec<UBig> pows;
+    if (level > DEC_LEAF)
+        _decPows(pows, level - 1);
+
+    Vec<char> buf;
+    buf.resize(DEC_DIGITS << level, '0');
+    _toDec(value, pows, level, buf.buf());
+
+    usize start = 0;
+    while (start + 1 < buf.len() and buf[start] == '0')
+        start++;
+
+    return Str{buf.buf() + start, buf.len() - start};
+}
+
+static UBig _fromDec(Str str, Vec<UBig> &pows) {
+    if (str.len() <= (DEC_DIGITS << DEC_LEAF)) {
+        UBig res;
+        usize i = 0;
+        while (i < str.len()) {
+            // The first chunk takes what is left over.
+            usize len = i == 0 and str.len() % DEC_DIGITS
+                            ? str.len() % DEC_DIGITS
+                            : DEC_DIGITS;
+
+            usize chunk = 0;
+            usize scale = 1;
+            for (usize j = 0; j < len; j++) {
+                chunk = chunk * 10 + (str[i + j] - '0');
+                scale *= 10;
+            }
+            i += len;
+
+            // res = res·10ˡᵉⁿ + chunk
+            usize carry = chunk;
+            for (usize j = 0; j < res._len(); j++) {
+                u128 prod = (u128)res._value[j] * scale + carry;
+                res._value[j] = (usize)prod;
+                carry = (usize)(prod >> BITS<usize>);
+            }
+            if (carry)
+                res._value.pushBack(carry);
+        }
+        return res;
+    }
+
+    // The low part gets 19·2ᵏ digits, at least half of them.
+    usize level = 0;
+    while ((DEC_DIGITS << (level + 1)) < str.len())
+        level++;
+    _decPows(pows, level);
+
+    usize split = str.len() - (DEC_DIGITS << level);
+    UBig res = _fromDec(sub(str, 0, split), pows);
+    _mul(res, pows[level]);
+    _add(res, _fromDec(sub(str, split, str.len()), pows));
+    res._trim();
+    return res;
+}
+
+Res<> _fromDec(UBig &value, Str str) {
+    if (str.len() == 0)
+        return Error::invalidInput("expected a decimal number");
+
+    for (auto c : str)
+        if (c < '0' or c > '9')
+            return Error::invalidInput("expected a decimal digit");
+
+    Vec<UBig> pows;
+    value = _fromDec(str, pows);
+    return Ok();
+}
+
 /* --- Signed Big Integer --------------------------------------------------- */
 
 void _add(IBig &lhs, IBig const &rhs) {
@@ -2,6 +2,7 @@
 
 #include <karm-base/checked.h>
 #include <karm-base/res.h>
+#include <karm-base/string.h>
 #include <karm-base/vec.h>
 
 namespace Karm::Math {
@@ -44,6 +45,12 @@ void _gcd(UBig const &lhs, UBig const &rhs, UBig &gcd);
 
 void _pow(UBig const &base, UBig const &exp, UBig &res);
 
+void _powMod(UBig const &base, UBig const &exp, UBig const &mod, UBig &res);
+
+String _toDec(UBig const &value);
+
+Res<> _fromDec(UBig &value, Str str);
+
 struct UBig {
     Vec<usize> _value;
 
@@ -77,12 +84,12 @@ struct UBig {
     void _setBit(usize bit) {
         if (bit >= _value.len() * BITS<usize>)
             _value.resize(bit / BITS<usize> + 1);
-        _value[bit / BITS<usize>] |= 1 << (bit % BITS<usize>);
+        _value[bit / BITS<usize>] |= 1uz << (bit % BITS<usize>);
     }
 
     bool _getBit(usize bit) const {
         return bit < _value.len() * BITS<usize> and
-               (_value[bit / BITS<usize>] & (1 << (bit % BITS<usize>))) != 0;
+               (_value[bit / BITS<usize>] & (1uz << (bit % BITS<usize>))) != 0;
     }
 
     UBig operator~() {
@@ -237,6 +237,14 @@ union Rect {
     ALWAYS_INLINE Rect offset(Vec2<T> v) const {
         return {x + v.x, y + v.y, width, height};
     }
+
+    ALWAYS_INLINE constexpr bool empty() const {
+        return width <= 0 or height <= 0;
+    }
+
+    ALWAYS_INLINE constexpr bool operator==(Rect const &other) const {
+        return _els == other._els;
+    }
 };
 
 using Recti = Rect<isize>;
@@ -0,0 +1,159 @@
+#include <karm-math/bigint.h>
+#include <karm-math/rand.h>
+#include <karm-test/macros.h>
+
+namespace Karm::Math::Tests {
+
+static UBig _randomBits(usize bits, u64 seed = 0x1234) {
+    Rand rand{seed};
+    UBig res;
+    for (usize i = 0; i < bits / BITS<usize>; i++)
+        res._value.pushBack(rand.nextU64());
+    res._value[res._len() - 1] |= 1uz << (BITS<usize> - 1);
+    return res;
+}
+
+static void _benchMul(Bencher &b, usize bits) {
+    auto x = _randomBits(bits, 1);
+    auto y = _randomBits(bits, 2);
+    b.items(1);
+    b.run([&] {
+        doNotOptimize(x * y);
+    });
+}
+
+// A 2n bits number by a n bits one.
+static void _benchDiv(Bencher &b, usize bits) {
+    auto x = _randomBits(bits * 2, 1);
+    auto y = _randomBits(bits, 2);
+    b.items(1);
+    b.run([&] {
+        UBig q, r;
+        _div(x, y, q, r);
+        doNotOptimize(q);
+    });
+}
+
+static void _benchToDec(Bencher &b, usize bits) {
+    auto x = _randomBits(bits);
+    b.items(1);
+    b.run([&] {
+        doNotOptimize(_toDec(x));
+    });
+}
+
+static void _benchFromDec(Bencher &b, usize bits) {
+    auto str = _toDec(_randomBits(bits));
+    b.bytes(str.len());
+    b.run([&] {
+        UBig x;
+        (void)_fromDec(x, str);
+        doNotOptimize(x);
+    });
+}
+
+static void _benchGcd(Bencher &b, usize bits) {
+    auto x = _randomBits(bits, 1);
+    auto y = _randomBits(bits, 2);
+    b.items(1);
+    b.run([&] {
+        UBig gcd;
+        _gcd(x, y, gcd);
+        doNotOptimize(gcd);
+    });
+}
+
+static void _benchPowMod(Bencher &b, usize bits) {
+    auto base = _randomBits(bits, 1);
+    auto exp = _randomBits(bits, 2);
+    auto mod = _randomBits(bits, 3) | 1_ubig;
+    b.items(1);
+    b.run([&] {
+        UBig res;
+        _powMod(base, exp, mod, res);
+        doNotOptimize(res);
+    });
+}
+
+bench$(ubigMul256) {
+    _benchMul(b, 256);
+}
+
+bench$(ubigMul1024) {
+    _benchMul(b, 1024);
+}
+
+bench$(ubigMul4096) {
+    _benchMul(b, 4096);
+}
+
+bench$(ubigMul16384) {
+    _benchMul(b, 16384);
+}
+
+bench$(ubigMul65536) {
+    _benchMul(b, 65536);
+}
+
+bench$(ubigDiv256) {
+    _benchDiv(b, 256);
+}
+
+bench$(ubigDiv4096) {
+    _benchDiv(b, 4096);
+}
+
+bench$(ubigDiv16384) {
+    _benchDiv(b, 16384);
+}
+
+bench$(ubigDiv65536) {
+    _benchDiv(b, 65536);
+}
+
+bench$(ubigToDec256) {
+    _benchToDec(b, 256);
+}
+
+bench$(ubigToDec4096) {
+    _benchToDec(b, 4096);
+}
+
+bench$(ubigToDec65536) {
+    _benchToDec(b, 65536);
+}
+
+bench$(ubigFromDec256) {
+    _benchFromDec(b, 256);
+}
+
+bench$(ubigFromDec4096) {
+    _benchFromDec(b, 4096);
+}
+
+bench$(ubigFromDec65536) {
+    _benchFromDec(b, 65536);
+}
+
+bench$(ubigGcd256) {
+    _benchGcd(b, 256);
+}
+
+bench$(ubigGcd4096) {
+    _benchGcd(b, 4096);
+}
+
+// Exponents as long as the modulus, as in RSA.
+bench$(ubigPowMod256) {
+    _benchPowMod(b, 256);
+}
+
+bench$(ubigPowMod1024) {
+    _benchPowMod(b, 1024);
+}
+
+bench$(ubigPowMod2048) {
+    _benchPowMod(b, 2048);
+}
+
+} // namespace Karm::Math::Tests
@@ -0,0 +1,130 @@
+#include <karm-base/cons.h>
+#include <karm-math/bigint.h>
+#include <karm-math/rand.h>
+#include <karm-test/macros.h>
+
+namespace Karm::Math::Tests {
+
+static UBig _random(Rand &rand, usize limbs) {
+    UBig res;
+    for (usize i = 0; i < limbs; i++)
+        res._value.pushBack(rand.nextU64());
+    res._trim();
+    return res;
+}
+
+static UBig _dec(Str str) {
+    UBig res;
+    _fromDec(res, str).unwrap();
+    return res;
+}
+
+test$(ubigDecimal) {
+    expect$(_toDec(0_ubig) == Str{"0"});
+    expect$(_toDec(1234_ubig) == Str{"1234"});
+    expect$(_toDec(1_ubig << 200) == Str{"1606938044258990275541962092341162602522202993782792835301376"});
+    expect$(_dec("0000000000000000000000000000000000000000000012") == 12_ubig);
+
+    UBig invalid;
+    expect$(not _fromDec(invalid, "12a"));
+
+    // Long enough to be split in halves a few times over.
+    Rand rand{0x1234};
+    for (usize limbs : {1uz, 7uz, 40uz, 300uz}) {
+        auto value = _random(rand, limbs);
+        expect$(_dec(_toDec(value)) == value);
+    }
+
+    return Ok();
+}
+
+test$(ubigMul) {
+    expect$(_dec("123456789012345678901234567890") * _dec("987654321098765432109876543210") ==
+            _dec("121932631137021795226185032733622923332237463801111263526900"));
+
+    // Large enough for Karatsuba, both balanced and not.
+    Rand rand{0x5678};
+    for (auto [an, bn] : {Cons{33uz, 33uz}, Cons{100uz, 64uz}, Cons{300uz, 40uz}, Cons{257uz, 255uz}}) {
+        auto a = _random(rand, an);
+        auto b = _random(rand, bn);
+        auto c = _random(rand, 3);
+
+        auto ab = a * b;
+        expect$(ab == b * a);
+        expect$(ab / b == a);
+        expect$(ab % b == 0_ubig);
+        expect$((a + c) * b == ab + c * b);
+    }
+
+    auto a = _random(rand, 50);
+    auto square = a;
+    _mul(square, square);
+    expect$(square == a * a);
+
+    return Ok();
+}
+
+test$(ubigDiv) {
+    Rand rand{0x9abc};
+    for (auto [an, bn] : {Cons{2uz, 1uz}, Cons{10uz, 3uz}, Cons{64uz, 63uz}, Cons{200uz, 37uz}}) {
+        auto n = _random(rand, an);
+        auto d = _random(rand, bn);
+
+        UBig q, r;
+        _div(n, d, q, r);
+        expect$(r < d);
+        expect$(q * d + r == n);
+    }
+
+    // The quotient estimate is off by one and the divisor is added back.
+    auto n = _dec("340282366920938463463374607431768211455");
+    auto d = _dec("18446744073709551617");
+    expect$(n / d == _dec("18446744073709551615"));
+    expect$(n % d == 0_ubig);
+
+    expect$(5_ubig / 7_ubig == 0_ubig);
+    expect$(5_ubig % 7_ubig == 5_ubig);
+
+    return Ok();
+}
+
+test$(ubigGcd) {
+    UBig gcd;
+    _gcd((1_ubig << 100) * 3_ubig, (1_ubig << 50) * 9_ubig, gcd);
+    expect$(gcd == (1_ubig << 50) * 3_ubig);
+
+    Rand rand{0xdef0};
+    auto a = _random(rand, 20);
+    auto b = _random(rand, 15);
+    auto c = _random(rand, 5);
+    _gcd(a * c, b * c, gcd);
+    expect$((a * c) % gcd == 0_ubig);
+    expect$((b * c) % gcd == 0_ubig);
+    expect$(gcd % c == 0_ubig);
+
+    return Ok();
+}
+
+test$(ubigPowMod) {
+    // Fermat: aᵖ⁻¹ ≡ 1 (mod p), with p = 2¹²⁷ - 1.
+    auto p = (1_ubig << 127) - 1_ubig;
+    UBig res;
+    _powMod(3_ubig, p - 1_ubig, p, res);
+    expect$(res == 1_ubig);
+
+    Rand rand{0x1357};
+    auto base = _random(rand, 8);
+    auto exp = 1000_ubig;
+    for (auto mod : {_random(rand, 4) | 1_ubig, _random(rand, 4) << 1, 1_ubig}) {
+        UBig want;
+        _pow(base, exp, want);
+        want %= mod;
+
+        _powMod(base, exp, mod, res);
+        expect$(res == want);
+    }
+
+    return Ok();
+}
+
+} // namespace Karm::Math::Tests
@@ -20,6 +20,8 @@ struct Icon {
     Icon(Mdi::Icon code, f64 size = 18)
         : _code(code), _size(size) {}
 
+    bool operator==(Icon const &) const = default;
+
     Str name() {
         return Mdi::name(_code);
     }
@@ -53,8 +53,6 @@ Res<Font> loadFontOrFallback(f64 size, Url::Url url) {
 
 static Res<Image> loadBmp(Bytes bytes) {
     auto bmp = try$(Bmp::Image::load(bytes));
-    Io::Emit e{Sys::out()};
-    bmp.dump(e);
     auto img = Image::alloc({bmp.width(), bmp.height()});
     try$(bmp.decode(img));
 
@@ -109,4 +107,17 @@ Res<Image> loadImageOrFallback(Url::Url url) {
     return Ok(Image::fallback());
 }
 
+/* --- Image saving --------------------------------------------------------- */
+
+Res<> saveImage(Gfx::Pixels pixels, Url::Url url) {
+    Io::BufferWriter buf{(usize)(pixels.width() * pixels.height())};
+    Io::BEmit e{buf};
+    Qoi::encode(pixels, e);
+
+    auto file = try$(Sys::File::create(url));
+    try$(file.write(buf.bytes()));
+    try$(file.flush());
+    return Ok();
+}
+
 } // namespace Karm::Media
@@ -27,4 +27,9 @@ Res<Image> loadImage(Url::Url url);
 
 Res<Image> loadImageOrFallback(Url::Url url);
 
+/* --- Image saving --------------------------------------------------------- */
+
+// Saves the pixels as a QOI image, which is lossless and fast to encode.
+Res<> saveImage(Gfx::Pixels pixels, Url::Url url);
+
 } // namespace Karm::Media
@@ -6,6 +6,8 @@
 #include <karm-sys/dir.h>
 #include <karm-sys/fd.h>
 #include <karm-sys/info.h>
+#include <karm-sys/mutex.h>
+#include <karm-sys/thread.h>
 #include <karm-sys/types.h>
 
 #include "defs.h"
@@ -56,6 +58,18 @@ Res<> populate(Sys::UserInfo &);
 
 Res<> populate(Vec<Sys::UserInfo> &);
 
+/* --- Threading ------------------------------------------------------------ */
+
+Res<Strong<Sys::Thread>> spawnThread(Func<void()> entry);
+
+usize cpuCount();
+
+Res<Strong<Sys::Mutex>> createMutex();
+
+Res<Strong<Sys::Sema>> createSema(usize count);
+
+Res<Strong<Sys::CondVar>> createCondVar();
+
 /* --- Process Managment ---------------------------------------------------- */
 
 Res<> sleep(TimeSpan);
@@ -20,6 +20,12 @@ struct Fd : Meta::NoCopy {
     virtual Res<usize> flush() = 0;
 
     virtual Res<Strong<Fd>> dup() = 0;
+
+    // The underlying platform handle (eg. a posix file descriptor),
+    // used by the event loop to wait for the fd to become ready.
+    virtual Opt<usize> handle() const {
+        return NONE;
+    }
 };
 
 struct DummyFd : public Fd {
@@ -2,41 +2,57 @@
 
 #include <karm-base/rc.h>
 #include <karm-base/res.h>
+#include <karm-meta/nocopy.h>
 
 namespace Karm::Sys {
 
-struct Mutext {
-    Res<Strong<Mutext>> create();
+struct Mutex : Meta::NoCopy {
+    static Res<Strong<Mutex>> create();
 
-    virtual ~Mutext() = default;
+    virtual ~Mutex() = default;
 
     virtual void lock() = 0;
 
-    virtual void tryLock() = 0;
+    virtual bool tryLock() = 0;
 
     virtual void unlock() = 0;
 };
 
-struct Sema {
-    Res<Strong<Sema>> create();
+struct MutexScope : Meta::Static {
+    Mutex &_mutex;
+
+    MutexScope(Mutex &mutex)
+        : _mutex(mutex) {
+        _mutex.lock();
+    }
+
+    ~MutexScope() {
+        _mutex.unlock();
+    }
+};
+
+struct Sema : Meta::NoCopy {
+    static Res<Strong<Sema>> create(usize count = 0);
 
     virtual ~Sema() = default;
 
     virtual void wait() = 0;
 
-    virtual void tryWait() = 0;
+    virtual bool tryWait() = 0;
 
     virtual void signal(usize n = 1) = 0;
 
-    virtual void count() = 0;
+    virtual usize count() = 0;
 };
 
-struct CondVar {
-    Res<Strong<CondVar>> create();
+struct CondVar : Meta::NoCopy {
+    static Res<Strong<CondVar>> create();
 
     virtual ~CondVar() = default;
 
-    virtual void wait() = 0;
+    // Atomically releases the mutex and blocks until signaled,
+    // the mutex is held again when this returns.
+    virtual void wait(Mutex &mutex) = 0;
 
     virtual void signal() = 0;
 
@@ -0,0 +1,110 @@
+#include <karm-base/ring.h>
+#include <karm-sys/thread.h>
+#include <karm-test/macros.h>
+
+namespace Karm::Sys::Tests {
+
+static constexpr usize ITEMS = 1 << 12;
+
+// The spinlocked ring Sys::Channel used to be built on, kept here
+// as a baseline.
+struct LockedRing {
+    Lock _lock;
+    Ring<usize> _ring{1024};
+
+    bool push(usize value) {
+        LockScope scope(_lock);
+        if (_ring.len() == 1024)
+            return false;
+        _ring.pushBack(value);
+        return true;
+    }
+
+    Opt<usize> pop() {
+        LockScope scope(_lock);
+        if (_ring.len() == 0)
+            return NONE;
+        return _ring.dequeue();
+    }
+};
+
+// Pairs of spinning producers and consumers going through the
+// same queue, each pair moving ITEMS values.
+static void _contend(usize threads, auto push, auto pop) {
+    Vec<Strong<Thread>> workers;
+
+    for (usize i = 0; i < threads; i++) {
+        workers.pushBack(Thread::spawn([&] {
+                             for (usize j = 0; j < ITEMS; j++)
+                                 while (not push(j))
+                                     ::Karm::_Embed::relaxe();
+                         }).unwrap());
+
+        workers.pushBack(Thread::spawn([&] {
+                             for (usize j = 0; j < ITEMS; j++)
+                                 while (not pop())
+                                     ::Karm::_Embed::relaxe();
+                         }).unwrap());
+    }
+
+    for (auto &w : workers)
+        w->join().unwrap();
+}
+
+static void _benchLocked(Bencher &b, usize threads) {
+    b.items(threads * ITEMS);
+    b.run([&] {
+        LockedRing locked;
+        _contend(
+            threads,
+            [&](usize v) {
+                return locked.push(v);
+            },
+            [&] {
+                return locked.pop();
+            }
+        );
+    });
+}
+
+static void _benchMpmc(Bencher &b, usize threads) {
+    b.items(threads * ITEMS);
+    b.run([&] {
+        MpmcQueue<usize> queue{1024};
+        _contend(
+            threads,
+            [&](usize v) {
+                return queue.tryPush(std::move(v));
+            },
+            [&] {
+                return queue.tryPop();
+            }
+        );
+    });
+}
+
+bench$(lockedRing1) {
+    _benchLocked(b, 1);
+}
+
+bench$(lockedRing4) {
+    _benchLocked(b, 4);
+}
+
+bench$(lockedRing16) {
+    _benchLocked(b, 16);
+}
+
+bench$(mpmcQueue1) {
+    _benchMpmc(b, 1);
+}
+
+bench$(mpmcQueue4) {
+    _benchMpmc(b, 4);
+}
+
+bench$(mpmcQueue16) {
+    _benchMpmc(b, 16);
+}
+
+} // namespace Karm::Sys::Tests
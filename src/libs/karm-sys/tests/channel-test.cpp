@@ -0,0 +1,83 @@
+#include <karm-sys/thread.h>
+#include <karm-test/macros.h>
+
+namespace Karm::Sys::Tests {
+
+test$(mpmcQueueOrder) {
+    MpmcQueue<usize> queue{8};
+
+    for (usize i = 0; i < 8; i++)
+        expect$(queue.tryPush(usize{i}));
+    expectNot$(queue.tryPush(8uz));
+
+    for (usize i = 0; i < 8; i++)
+        expectEq$(queue.tryPop().unwrap(), i);
+    expect$(not queue.tryPop());
+
+    return Ok();
+}
+
+test$(spscQueueSegments) {
+    SpscQueue<usize, 4> queue;
+
+    for (usize i = 0; i < 100; i++)
+        queue.push(i);
+
+    for (usize i = 0; i < 100; i++)
+        expectEq$(queue.pop().unwrap(), i);
+    expect$(not queue.pop());
+
+    return Ok();
+}
+
+test$(channelSendReceive) {
+    auto chan = try$(makeChannel<usize>(4));
+    auto &tx = chan.car;
+    auto &rx = chan.cdr;
+
+    Array<usize, 3> values = {1, 2, 3};
+    expectEq$(tx.sendBatch(values), 3uz);
+    try$(tx.send(4));
+    expect$(not tx.send(5));
+
+    expectEq$(rx.receive(), 1uz);
+
+    Array<usize, 8> out = {};
+    expectEq$(rx.receiveBatch(out), 3uz);
+    expectEq$(out[2], 4uz);
+    expect$(not rx.tryReceive());
+
+    return Ok();
+}
+
+test$(channelManyProducers) {
+    static constexpr usize PRODUCERS = 4;
+    static constexpr usize ITEMS = 1000;
+
+    auto chan = try$(makeChannel<usize>(16));
+    auto &tx = chan.car;
+    auto &rx = chan.cdr;
+
+    Vec<Strong<Thread>> producers;
+    for (usize i = 0; i < PRODUCERS; i++) {
+        producers.pushBack(try$(Thread::spawn([&] {
+            for (usize j = 1; j <= ITEMS; j++)
+                while (not tx.send(usize{j}))
+                    ::Karm::_Embed::relaxe();
+        })));
+    }
+
+    usize sum = 0;
+    for (usize i = 0; i < PRODUCERS * ITEMS; i++)
+        sum += rx.receive();
+
+    for (auto &p : producers)
+        try$(p->join());
+
+    expectEq$(sum, PRODUCERS * ITEMS * (ITEMS + 1) / 2);
+    expect$(not rx.tryReceive());
+
+    return Ok();
+}
+
+} // namespace Karm::Sys::Tests
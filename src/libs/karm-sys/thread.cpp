@@ -0,0 +1,28 @@
+#include "thread.h"
+
+#include "_embed.h"
+#include "mutex.h"
+
+namespace Karm::Sys {
+
+Res<Strong<Thread>> Thread::spawn(Func<void()> entry) {
+    return _Embed::spawnThread(std::move(entry));
+}
+
+usize cpuCount() {
+    return _Embed::cpuCount();
+}
+
+Res<Strong<Mutex>> Mutex::create() {
+    return _Embed::createMutex();
+}
+
+Res<Strong<Sema>> Sema::create(usize count) {
+    return _Embed::createSema(count);
+}
+
+Res<Strong<CondVar>> CondVar::create() {
+    return _Embed::createCondVar();
+}
+
+} // namespace Karm::Sys
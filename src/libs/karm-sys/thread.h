@@ -1,41 +1,145 @@
 #pragma once
 
+#include <karm-base/atomic.h>
+#include <karm-base/clamp.h>
 #include <karm-base/cons.h>
 #include <karm-base/func.h>
 #include <karm-base/lock.h>
+#include <karm-base/queue.h>
 #include <karm-base/rc.h>
 #include <karm-base/res.h>
-#include <karm-base/ring.h>
+#include <karm-meta/nocopy.h>
+
+#include "mutex.h"
+#include "pipe.h"
 
 namespace Karm::Sys {
 
 template <typename T>
-struct Channel {
+struct Channel : Meta::Static {
+    MpmcQueue<T> _queue;
+    Strong<Sema> _sema;
+
+    // Receivers parked in recvWait() that no sender has claimed yet,
+    // each claim is paid with exactly one signal of the semaphore.
+    Atomic<usize> _sleeping{};
+
+    // Receivers waiting on the notifier, and whether the notifier
+    // holds its byte. It never holds more than one, so writing to it
+    // can't block, the receiver clearing the latch reads it back.
+    Atomic<usize> _listening{};
+    Atomic<bool> _notified{};
+
     Lock _lock;
-    Ring<T> _ring;
+    Opt<Pipe> _notify = NONE;
+
+    Channel(usize cap, Strong<Sema> sema)
+        : _queue(cap), _sema(sema) {}
+
+    // Claims up to `n` parked receivers, and returns how many.
+    usize _claim(usize n) {
+        usize claimed = 0;
+        while (claimed < n) {
+            usize sleeping = _sleeping.load();
+            if (sleeping == 0)
+                break;
+
+            usize take = min(n - claimed, sleeping);
+            if (_sleeping.cmpxchg(sleeping, sleeping - take))
+                claimed += take;
+        }
+        return claimed;
+    }
 
-    Channel(usize capacity)
-        : _ring(capacity) {}
+    void _wake(usize sent) {
+        if (usize claimed = _claim(sent))
+            _sema->signal(claimed);
 
-    Res<T> recv() {
-        LockScope guard(_lock);
+        if (_listening.load() == 0 or not _notified.cmpxchg(false, true))
+            return;
+
+        Opt<Strong<Fd>> out = NONE;
+        {
+            LockScope scope(_lock);
+            if (_notify)
+                out = _notify->out();
+        }
 
-        if (_ring.empty()) {
-            return Error::WOULD_BLOCK;
+        if (not out) {
+            _notified.store(false);
+            return;
         }
 
-        return _ring.pop();
+        Byte b = 0;
+        (void)(*out)->write({&b, 1});
     }
 
     Res<> send(T value) {
-        LockScope guard(_lock);
+        if (not _queue.tryPush(std::move(value)))
+            return Error::wouldBlock("channel full");
 
-        if (_ring.full()) {
-            return Error::wouldBlock();
+        _wake(1);
+        return Ok();
+    }
+
+    // Sends as many values as possible without blocking,
+    // and returns how many were sent.
+    usize sendBatch(MutSlice<T> values) {
+        usize sent = 0;
+        while (sent < values.len() and _queue.tryPush(std::move(values[sent])))
+            sent++;
+
+        if (sent)
+            _wake(sent);
+
+        return sent;
+    }
+
+    Res<T> recv() {
+        auto value = _queue.tryPop();
+        if (not value)
+            return Error::wouldBlock("channel empty");
+        return Ok(value.take());
+    }
+
+    usize recvBatch(MutSlice<T> values) {
+        usize received = 0;
+        while (received < values.len()) {
+            auto value = _queue.tryPop();
+            if (not value)
+                break;
+            values[received++] = value.take();
         }
+        return received;
+    }
 
-        _ring.push(value);
-        return Ok();
+    T recvWait() {
+        while (true) {
+            if (auto value = _queue.tryPop())
+                return value.take();
+
+            // NOTE: _sleeping is published before checking the queue again
+            //       while senders do the opposite, so no wakeup is lost.
+            _sleeping.inc();
+            if (auto value = _queue.tryPop()) {
+                // A sender may have claimed us in the meantime,
+                // its signal is ours to consume then.
+                if (_claim(1) == 0)
+                    _sema->wait();
+                return value.take();
+            }
+
+            _sema->wait();
+        }
+    }
+
+    // A fd that becomes readable when values are sent while a receiver
+    // is listening, used to integrate the channel with an event loop.
+    Res<Strong<Fd>> notifier() {
+        LockScope scope(_lock);
+        if (not _notify)
+            _notify = try$(Pipe::create());
+        return Ok(_notify->in());
     }
 };
 
@@ -45,7 +149,13 @@ struct Tx {
 
     Strong<Channel<T>> _channel;
 
-    Res<void> send(T const &value);
+    Res<> send(T value) {
+        return _channel->send(std::move(value));
+    }
+
+    usize sendBatch(MutSlice<T> values) {
+        return _channel->sendBatch(values);
+    }
 };
 
 template <typename T>
@@ -54,29 +164,41 @@ struct Rx {
 
     Strong<Channel<T>> _channel;
 
-    Res<T> receive();
+    // Blocks until a value is available.
+    T receive() {
+        return _channel->recvWait();
+    }
+
+    Res<T> tryReceive() {
+        return _channel->recv();
+    }
+
+    usize receiveBatch(MutSlice<T> values) {
+        return _channel->recvBatch(values);
+    }
 };
 
 template <typename T>
-Cons<Tx<T>, Rx<T>> makeChannel() {
-    auto channel = makeStrong<Channel<T>>(128);
+Res<Cons<Tx<T>, Rx<T>>> makeChannel(usize cap = 128) {
+    auto channel = makeStrong<Channel<T>>(cap, try$(Sema::create()));
 
-    return {
+    return Ok(Cons<Tx<T>, Rx<T>>{
         Tx<T>{channel},
         Rx<T>{channel},
-    };
+    });
 }
 
-struct Thread {
-    Res<Thread> spawn(Func<void(void)>);
+struct Thread : Meta::NoCopy {
+    static Res<Strong<Thread>> spawn(Func<void()> entry);
 
-    void join();
+    virtual ~Thread() = default;
 
-    void detach();
+    virtual Res<> join() = 0;
 
-    void exit();
-
-    void sleep(isize ms);
+    virtual Res<> detach() = 0;
 };
 
+// Number of hardware threads available to the process.
+usize cpuCount();
+
 } // namespace Karm::Sys
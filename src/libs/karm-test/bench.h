@@ -0,0 +1,132 @@
+#pragma once
+
+#include <karm-base/loc.h>
+#include <karm-base/macros.h>
+#include <karm-base/string.h>
+#include <karm-base/vec.h>
+#include <karm-meta/nocopy.h>
+#include <karm-sys/time.h>
+
+#include "_prelude.h"
+
+#include "driver.h"
+
+namespace Karm::Test {
+
+/* --- Optimization Barriers ------------------------------------------------ */
+
+// Makes the compiler believe the value is read, so the
+// computation producing it can't be optimized away.
+template <typename T>
+ALWAYS_INLINE void doNotOptimize(T const &value) {
+    asm volatile("" : : "r,m"(value) : "memory");
+}
+
+// Makes the compiler believe all of memory is read and
+// written, so stores before it can't be optimized away.
+ALWAYS_INLINE inline void clobber() {
+    asm volatile("" : : : "memory");
+}
+
+/* --- Bencher -------------------------------------------------------------- */
+
+struct BenchStats {
+    usize iters;
+    usize samples;
+    f64 median; // ns per iteration
+    f64 p95;
+    f64 mean;
+    f64 stddev;
+    usize bytes; // per iteration
+    usize items;
+
+    // Bytes or items per second, at the median.
+    f64 throughput() const {
+        if (median <= 0)
+            return 0;
+        return (bytes ? bytes : items) * 1e9 / median;
+    }
+};
+
+struct Bencher {
+    // A sample has to be long enough for the clock to
+    // be precise, the first few are warmup.
+    static constexpr TimeSpan SAMPLE_TIME = TimeSpan::fromMSecs(5);
+    static constexpr usize WARMUP = 3;
+    static constexpr usize SAMPLES = 32;
+
+    usize _batch = 0;
+    usize _bytes = 0;
+    usize _items = 0;
+    Vec<f64> _samples;
+
+    // What one iteration processes, for reporting throughput.
+    void bytes(usize n) {
+        _bytes = n;
+    }
+
+    void items(usize n) {
+        _items = n;
+    }
+
+    // NOTE: Timed on the monotonic clock, the wall clock can jump.
+    TimeSpan _time(auto &fn, usize batch) {
+        auto start = Sys::uptime();
+        for (usize i = 0; i < batch; i++)
+            fn();
+        return Sys::uptime() - start;
+    }
+
+    // Runs `fn` in batches sized to last a sample, then
+    // records how long each iteration took.
+    void run(auto fn) {
+        usize batch = 1;
+        while (true) {
+            auto elapsed = _time(fn, batch);
+            if (elapsed >= SAMPLE_TIME)
+                break;
+
+            // Grow fast while the clock can't see it,
+            // then aim right at the sample time.
+            if (elapsed.toUSecs() < 100)
+                batch *= 10;
+            else
+                batch = batch * SAMPLE_TIME.toUSecs() / elapsed.toUSecs() + 1;
+        }
+        _batch = batch;
+
+        for (usize i = 0; i < WARMUP; i++)
+            _time(fn, batch);
+
+        _samples.clear();
+        for (usize i = 0; i < SAMPLES; i++) {
+            auto elapsed = _time(fn, batch);
+            _samples.pushBack(elapsed.toUSecs() * 1000.0 / batch);
+        }
+    }
+
+    BenchStats stats() const;
+};
+
+/* --- Bench ---------------------------------------------------------------- */
+
+struct Bench : Meta::Static {
+    using Func = void (*)(Bencher &);
+
+    Str _name;
+    Func _func;
+    Loc _loc;
+
+    Bench(Str name, Func func, Loc loc = Loc::current())
+        : _name(name), _func(func), _loc(loc) {
+        driver().add(this);
+    }
+
+    BenchStats run() {
+        Bencher b;
+        _func(b);
+        return b.stats();
+    }
+};
+
+} // namespace Karm::Test
@@ -3,9 +3,13 @@
 #include <karm-cli/spinner.h>
 #include <karm-cli/style.h>
 #include <karm-fmt/case.h>
+#include <karm-io/emit.h>
+#include <karm-math/funcs.h>
 #include <karm-sys/chan.h>
+#include <karm-sys/file.h>
 #include <karm-sys/time.h>
 
+#include "bench.h"
 #include "driver.h"
 #include "test.h"
 
@@ -15,16 +19,30 @@ void Driver::add(Test *test) {
     _tests.pushBack(test);
 }
 
+void Driver::add(Bench *bench) {
+    _benches.pushBack(bench);
+}
+
+static bool _match(Str name, Str filter) {
+    for (usize i = 0; i + filter.len() <= name.len(); i++)
+        if (sub(name, i, i + filter.len()) == filter)
+            return true;
+    return false;
+}
+
 static auto GREEN = Cli::Style{Cli::GREEN}.bold();
 static auto RED = Cli::Style{Cli::RED}.bold();
 static auto NOTE = Cli::Style{Cli::GRAY_DARK}.bold();
 
-void Driver::runAll() {
+void Driver::runAll(Str filter) {
     usize passed = 0, failed = 0;
 
     Sys::errln("Running {} tests...\n", _tests.len());
 
     for (auto *test : _tests) {
+        if (not _match(test->_name, filter))
+            continue;
+
         Sys::err("{}{} Running {}...{}{}", Cli::Cmd::clearLineAfter(), Cli::styled(" TEST ", Cli::style().bold().bg(Cli::CYAN)), Fmt::toNoCase(test->_name).unwrap(), Cli::Cmd::horizontal(0));
 
         auto result = test->run(*this);
@@ -58,6 +76,151 @@ void Driver::runAll() {
     }
 }
 
+/* --- Benches ------------------------------------------------------------- */
+
+BenchStats Bencher::stats() const {
+    BenchStats stats{
+        .iters = _batch,
+        .samples = _samples.len(),
+        .median = 0,
+        .p95 = 0,
+        .mean = 0,
+        .stddev = 0,
+        .bytes = _bytes,
+        .items = _items,
+    };
+
+    if (_samples.len() == 0)
+        return stats;
+
+    Vec<f64> sorted = _samples;
+    sort(sorted);
+
+    stats.median = sorted[sorted.len() / 2];
+    stats.p95 = sorted[sorted.len() * 95 / 100];
+
+    for (auto s : sorted)
+        stats.mean += s;
+    stats.mean /= sorted.len();
+
+    f64 var = 0;
+    for (auto s : sorted)
+        var += Math::pow2(s - stats.mean);
+    stats.stddev = Math::sqrt(var / sorted.len());
+
+    return stats;
+}
+
+// Keeps a single decimal, so columns stay readable.
+static void _emitNum(Io::Emit &e, f64 value, Str unit) {
+    e("{}.{} {}", (usize)value, (usize)(value * 10) % 10, unit);
+}
+
+static void _emitTime(Io::Emit &e, f64 ns) {
+    if (ns < 1e3)
+        _emitNum(e, ns, "ns");
+    else if (ns < 1e6)
+        _emitNum(e, ns / 1e3, "us");
+    else
+        _emitNum(e, ns / 1e6, "ms");
+}
+
+static void _emitThroughput(Io::Emit &e, BenchStats const &stats) {
+    f64 rate = stats.throughput();
+    Str unit = stats.bytes ? "B/s" : "items/s";
+    if (rate >= 1e9)
+        _emitNum(e, rate / 1e9, stats.bytes ? "GB/s" : "G items/s");
+    else if (rate >= 1e6)
+        _emitNum(e, rate / 1e6, stats.bytes ? "MB/s" : "M items/s");
+    else if (rate >= 1e3)
+        _emitNum(e, rate / 1e3, stats.bytes ? "KB/s" : "K items/s");
+    else
+        _emitNum(e, rate, unit);
+}
+
+static void _emitJsonStr(Io::Emit &e, Str str) {
+    e('"');
+    for (auto c : str) {
+        if (c == '"' or c == '\\')
+            e('\\');
+        e((Rune)c);
+    }
+    e('"');
+}
+
+static Res<> _saveJson(Url::Url url, Vec<Cons<Bench *, BenchStats>> const &results) {
+    Io::StringWriter writer;
+    Io::Emit e{writer};
+
+    e(Str{"{\"benches\":["});
+    for (usize i = 0; i < results.len(); i++) {
+        auto &[bench, stats] = results[i];
+        if (i)
+            e(',');
+        e('\n');
+        e(Str{"{\"name\":"});
+        _emitJsonStr(e, bench->_name);
+        e(",\"iters\":{},\"samples\":{}", stats.iters, stats.samples);
+        e(",\"median_ns\":{},\"p95_ns\":{}", stats.median, stats.p95);
+        e(",\"mean_ns\":{},\"stddev_ns\":{}", stats.mean, stats.stddev);
+        e(",\"bytes\":{},\"items\":{}", stats.bytes, stats.items);
+        e(",\"throughput\":{}", stats.throughput());
+        e('}');
+    }
+    e('\n');
+    e(Str{"]}"});
+    e('\n');
+    try$(e._error);
+
+    auto json = writer.take();
+    auto file = try$(Sys::File::create(url));
+    try$(file.write(bytes(json)));
+    try$(file.flush());
+    return Ok();
+}
+
+Res<> Driver::runBenches(Str filter, Opt<Url::Url> json) {
+    Sys::errln("Running {} benches...\n", _benches.len());
+
+    Vec<Cons<Bench *, BenchStats>> results;
+    for (auto *bench : _benches) {
+        if (not _match(bench->_name, filter))
+            continue;
+
+        Sys::err("{}{} Running {}...{}", Cli::Cmd::clearLineAfter(), Cli::styled(" BENCH ", Cli::style().bold().bg(Cli::CYAN)), Fmt::toNoCase(bench->_name).unwrap(), Cli::Cmd::horizontal(0));
+
+        auto stats = bench->run();
+        results.pushBack({bench, stats});
+
+        Io::StringWriter line;
+        Io::Emit e{line};
+        _emitTime(e, stats.median);
+        e(Str{" median, "});
+        _emitTime(e, stats.p95);
+        e(Str{" p95, ± "});
+        _emitTime(e, stats.stddev);
+        if (stats.bytes or stats.items) {
+            e(Str{", "});
+            _emitThroughput(e, stats);
+        }
+
+        Sys::errln(
+            "{}{} {} - {}",
+            Cli::Cmd::clearLineAfter(),
+            Cli::styled(" DONE ", Cli::style(Cli::WHITE).bold().bg(Cli::GREEN_LIGHT)),
+            Fmt::toNoCase(bench->_name).unwrap(),
+            Cli::styled(line.str(), NOTE)
+        );
+    }
+
+    Sys::errln("");
+
+    if (json)
+        try$(_saveJson(*json, results));
+
+    return Ok();
+}
+
 Driver &driver() {
     static Opt<Driver> driver;
     if (not driver) {
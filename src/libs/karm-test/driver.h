@@ -3,17 +3,28 @@
 #include <karm-base/loc.h>
 #include <karm-base/vec.h>
 #include <karm-sys/chan.h>
+#include <url/url.h>
 
 namespace Karm::Test {
 
 struct Test;
 
+struct Bench;
+
 struct Driver {
     Vec<Test *> _tests;
+    Vec<Bench *> _benches;
 
     void add(Test *test);
 
-    void runAll();
+    void add(Bench *bench);
+
+    // Only the tests and benches with `filter` in their name are run.
+    void runAll(Str filter = "");
+
+    // Saves the results as JSON to `json`, if given, so
+    // that runs can be compared.
+    Res<> runBenches(Str filter = "", Opt<Url::Url> json = NONE);
 
     Res<> unexpect(auto const &__lhs, auto const &__rhs, Str op, Loc = Loc::current()) {
         Sys::errln("unexpected: '{}' {} '{}'", __lhs, op, __rhs);
@@ -2,6 +2,7 @@
 
 #include <karm-base/macros.h>
 
+#include "bench.h"
 #include "driver.h"
 #include "test.h"
 
@@ -12,6 +13,12 @@ namespace Karm::Test {
     static ::Karm::Test::Test var$(_test){#ID, var$(ID)};                           \
     static ::Karm::Res<> var$(ID)([[maybe_unused]] ::Karm::Test::Driver & _driver)
 
+// Benches are only run with `+bench`, the bencher is named `b`.
+#define bench$(ID)                                                    \
+    static void var$(ID)([[maybe_unused]] ::Karm::Test::Bencher & b); \
+    static ::Karm::Test::Bench var$(_bench){#ID, var$(ID)};           \
+    static void var$(ID)([[maybe_unused]] ::Karm::Test::Bencher & b)
+
 #define __expect$(LHS, RHS, OP)                         \
     ({                                                  \
         /* Make sure LHS and RHS are evaluated once */  \
@@ -1,7 +1,30 @@
 #include <karm-main/main.h>
 #include <karm-test/driver.h>
 
-Res<> entryPoint(Ctx &) {
-    Test::driver().runAll();
+// The value following `option`, if any.
+static Opt<Str> _arg(ArgsHook const &args, Str option) {
+    for (usize i = 0; i + 1 < args.len(); i++)
+        if (args[i] == option)
+            return args[i + 1];
+    return NONE;
+}
+
+// `+filter <text>` only runs what has `text` in its name, `+bench`
+// runs the benches instead of the tests, and `+json <url>` saves
+// their results.
+Res<> entryPoint(Ctx &ctx) {
+    auto &args = useArgs(ctx);
+    Str filter = "";
+    if (auto f = _arg(args, "+filter"))
+        filter = *f;
+
+    if (args.has("+bench")) {
+        Opt<Url::Url> json = NONE;
+        if (auto url = _arg(args, "+json"))
+            json = Url::Url::parse(*url);
+        return Test::driver().runBenches(filter, json);
+    }
+
+    Test::driver().runAll(filter);
     return Ok();
 }
@@ -1,4 +1,5 @@
 #include "anim.h"
+#include "layer.h"
 
 namespace Karm::Ui {
 
@@ -7,6 +8,7 @@ namespace Karm::Ui {
 struct SlideIn : public ProxyNode<SlideIn> {
     SlideFrom _from;
     Easedf _slide{};
+    Layer _layer;
 
     SlideIn(SlideFrom from, Ui::Child child)
         : ProxyNode(std::move(child)),
@@ -34,18 +36,35 @@ struct SlideIn : public ProxyNode<SlideIn> {
 
         g.clip(bound());
         auto anim = lerp(outside(), Math::Vec2f{}, _slide.value());
-        g.origin(anim.cast<isize>());
-        r.xy = r.xy - anim.cast<isize>();
-        child().paint(g, r);
+
+        // While sliding, the child is painted once and then moved around.
+        if (not _slide.reached()) {
+            _layer.update(child().bound(), g.pixels().fmt(), [&](Gfx::Context &lg, Math::Recti lr) {
+                child().paint(lg, lr);
+            });
+            _layer.paint(g, anim.cast<isize>());
+        } else {
+            _layer.drop();
+            g.origin(anim.cast<isize>());
+            r.xy = r.xy - anim.cast<isize>();
+            child().paint(g, r);
+        }
 
         g.restore();
     }
 
-    void event(Async::Event &e) override {
-        if (_slide.needRepaint(*this, e))
-            Ui::shouldRepaint(*this, bound());
+    void bubble(Async::Event &e) override {
+        if (auto *pe = e.is<Node::PaintEvent>())
+            _layer.invalidate(pe->bound);
+
+        Ui::ProxyNode<SlideIn>::bubble(e);
+    }
 
-        Ui::ProxyNode<SlideIn>::event(e);
+    // NOTE: The repaint goes to the parent, only repaints coming
+    //       from the child itself invalidate the layer.
+    void tick(f64 dt) override {
+        if (_slide.tick(*this, dt))
+            Ui::shouldRepaint(*parent(), bound());
     }
 
     void attach(Node *parent) override {
@@ -79,10 +98,10 @@ struct SlideInOut : public ProxyNode<SlideInOut> {
           _from(from) {
     }
 
-    void reconcile(SlideInOut &o) override {
-        _visible = o._visible;
-        _from = o._from;
-        ProxyNode<SlideInOut>::reconcile(o);
+    bool reconcile(SlideInOut &o) override {
+        bool changed = reconcileProp(_visible, o._visible);
+        changed |= reconcileProp(_from, o._from);
+        return ProxyNode<SlideInOut>::reconcile(o) or changed;
     }
 };
 
@@ -58,28 +58,24 @@ struct Eased {
         Ui::shouldAnimate(n);
     }
 
-    bool needRepaint(Node &n, Async::Event &e) {
-        bool shouldRepaint = false;
-
-        e.handle<Node::AnimateEvent>([&](auto &a) {
-            if (_animated) {
-                Ui::shouldAnimate(n);
-                shouldRepaint = true;
-
-                _elapsed += a.dt;
-                if (_elapsed > _duration) {
-                    _elapsed = _duration;
-                    _value = _target;
-                    _animated = false;
-                } else {
-                    f64 p = _elapsed / _duration;
-                    _value = Math::lerp(_start, _target, _easing(p));
-                }
-            }
+    // Returns true if the value changed and the node needs a repaint.
+    bool tick(Node &n, f64 dt) {
+        if (not _animated)
             return false;
-        });
 
-        return shouldRepaint;
+        Ui::shouldAnimate(n);
+
+        _elapsed += dt;
+        if (_elapsed > _duration) {
+            _elapsed = _duration;
+            _value = _target;
+            _animated = false;
+        } else {
+            f64 p = _elapsed / _duration;
+            _value = Math::lerp(_start, _target, _easing(p));
+        }
+
+        return true;
     }
 
     bool reached() const {
@@ -124,9 +120,9 @@ struct Eased2 {
         _y.animate(n, target.y, duration, easing);
     }
 
-    bool needRepaint(Node &n, Async::Event &e) {
-        bool sx = _x.needRepaint(n, e);
-        bool sy = _y.needRepaint(n, e);
+    bool tick(Node &n, f64 dt) {
+        bool sx = _x.tick(n, dt);
+        bool sy = _y.tick(n, dt);
         return sx or sy;
     }
 
@@ -4,6 +4,7 @@
 
 #include "_embed.h"
 
+#include "headless.h"
 #include "host.h"
 #include "input.h"
 #include "layout.h"
@@ -11,6 +12,14 @@
 
 namespace Karm::Ui {
 
+// The debug switches change how everything is painted.
+inline void _shouldRepaintAll(Node &n) {
+    Node *root = &n;
+    while (root->parent())
+        root = root->parent();
+    shouldRepaint(*root);
+}
+
 Child inspector(Child child) {
     return hflow(
         child | Ui::grow(),
@@ -22,35 +31,35 @@ Child inspector(Child child) {
             button(
                 [](auto &n) {
                     debugShowLayoutBounds = !debugShowLayoutBounds;
-                    Ui::shouldLayout(n);
+                    _shouldRepaintAll(n);
                 },
                 ButtonStyle::subtle(),
                 Mdi::RULER_SQUARE),
             button(
                 [](auto &n) {
                     debugShowRepaintBounds = !debugShowRepaintBounds;
-                    Ui::shouldLayout(n);
+                    _shouldRepaintAll(n);
                 },
                 ButtonStyle::subtle(),
                 Mdi::BRUSH),
             button(
                 [](auto &n) {
                     debugShowEmptyBounds = !debugShowEmptyBounds;
-                    Ui::shouldLayout(n);
+                    _shouldRepaintAll(n);
                 },
                 ButtonStyle::subtle(),
                 Mdi::BORDER_NONE_VARIANT),
             button(
                 [](auto &n) {
                     debugShowScrollBounds = !debugShowScrollBounds;
-                    Ui::shouldLayout(n);
+                    _shouldRepaintAll(n);
                 },
                 ButtonStyle::subtle(),
                 Mdi::ARROW_UP_DOWN),
             button(
                 [](auto &n) {
                     debugShowPerfGraph = !debugShowPerfGraph;
-                    Ui::shouldLayout(n);
+                    _shouldRepaintAll(n);
                 },
                 ButtonStyle::subtle(),
                 Mdi::CHART_HISTOGRAM)) |
@@ -60,13 +69,65 @@ Child inspector(Child child) {
             }));
 }
 
+// The url following an option, or the fallback if there is none.
+inline Opt<Url::Url> _urlArg(ArgsHook const &args, Str option, Url::Url fallback) {
+    for (usize i = 0; i < args.len(); i++) {
+        if (args[i] != option)
+            continue;
+        if (i + 1 < args.len() and args[i + 1][0] != '+')
+            return Url::Url::parse(args[i + 1]);
+        return fallback;
+    }
+    return NONE;
+}
+
+// `+bench` plays a scripted session in a headless host, as fast as
+// it can, and reports what each frame cost. `+report <url>` saves the
+// cost of each frame as CSV and `+capture <url>` the last frame as QOI.
+inline Res<> _benchApp(ArgsHook const &args, Child root) {
+    static constexpr Math::Vec2i SIZE = {800, 600};
+
+    auto script = Script::explore(SIZE);
+    if (auto capture = _urlArg(args, "+capture", "file:frame.qoi"_url))
+        script.capture(*capture);
+
+    HeadlessHost host{root, SIZE, std::move(script)};
+    try$(host.play());
+    host.summarize(args.self());
+
+    if (auto report = _urlArg(args, "+report", "file:frames.csv"_url))
+        try$(host.saveReport(*report));
+
+    return Ok();
+}
+
 inline Res<> runApp(Ctx &ctx, Child root) {
     auto &args = useArgs(ctx);
     if (args.has("+debug")) {
         root = inspector(root);
     }
-    auto host = try$(_Embed::makeHost(root));
-    return host->run();
+
+    // `+trace <url>` records the whole session, and saves it there
+    // as Chrome trace events once the app exits.
+    auto trace = _urlArg(args, "+trace", "file:trace.json"_url);
+    debugTrace = trace.has();
+
+    Res<> res = Ok();
+    if (args.has("+bench")) {
+        res = _benchApp(args, root);
+    } else {
+        auto host = try$(_Embed::makeHost(root));
+        res = host->run();
+    }
+
+    if (trace) {
+        debugTrace = false;
+        auto saved = Tracer::global().save(*trace);
+        if (not saved)
+            logError("Could not save the trace: {}", saved.none().msg());
+    }
+
+    return res;
 }
 
 } // namespace Karm::Ui
@@ -66,6 +66,8 @@ struct BoxStyle {
         return copy;
     }
 
+    bool operator==(BoxStyle const &) const = default;
+
     void paint(Gfx::Context &g, Math::Recti bound, auto inner) {
         bound = padding.grow(Layout::Flow::LEFT_TO_RIGHT, bound);
 
@@ -117,14 +119,14 @@ struct _Box : public ProxyNode<Crtp> {
         rect = boxStyle().margin.shrink(Layout::Flow::LEFT_TO_RIGHT, rect);
         rect = boxStyle().padding.shrink(Layout::Flow::LEFT_TO_RIGHT, rect);
 
-        ProxyNode<Crtp>::child().layout(rect);
+        ProxyNode<Crtp>::child().relayout(rect);
     }
 
     Math::Vec2i size(Math::Vec2i s, Layout::Hint hint) override {
         s = s - boxStyle().margin.all();
         s = s - boxStyle().padding.all();
 
-        s = ProxyNode<Crtp>::child().size(s, hint);
+        s = ProxyNode<Crtp>::child().measure(s, hint);
 
         s = s + boxStyle().padding.all();
         s = s + boxStyle().margin.all();
@@ -144,9 +146,9 @@ struct Box : public _Box<Box> {
     Box(BoxStyle style, Child child)
         : _Box(child), _style(style) {}
 
-    void reconcile(Box &o) override {
-        _style = o._style;
-        _Box<Box>::reconcile(o);
+    bool reconcile(Box &o) override {
+        bool changed = reconcileProp(_style, o._style);
+        return _Box<Box>::reconcile(o) or changed;
     }
 
     BoxStyle &boxStyle() override {
@@ -95,9 +95,17 @@ struct DialogLayer : public LeafNode<DialogLayer> {
         return (bool)_popover;
     }
 
-    void reconcile(DialogLayer &o) override {
-        _child = tryOr(_child->reconcile(o._child), _child);
-        _child->attach(this);
+    bool reconcile(DialogLayer &o) override {
+        if (auto fresh = _child->reconcile(o._child)) {
+            _child->detach(this);
+            _child = *fresh;
+            _child->attach(this);
+            return true;
+        }
+
+        if (_child->_needsLayout)
+            invalidateLayout();
+        return false;
     }
 
     void paint(Gfx::Context &g, Math::Recti r) override {
@@ -115,11 +123,13 @@ struct DialogLayer : public LeafNode<DialogLayer> {
         }
     }
 
-    void event(Async::Event &e) override {
-        if (_opacity.needRepaint(*this, e)) {
+    void tick(f64 dt) override {
+        if (_opacity.tick(*this, dt)) {
             Ui::shouldRepaint(*this);
         }
+    }
 
+    void event(Async::Event &e) override {
         if (popoverVisible()) {
             popover().event(e);
         } else if (dialogVisible()) {
@@ -192,20 +202,20 @@ struct DialogLayer : public LeafNode<DialogLayer> {
             _shouldPopover = NONE;
         }
 
-        child().layout(r);
+        child().relayout(r);
 
         if (dialogVisible()) {
-            (*_dialog)->layout(r);
+            (*_dialog)->relayout(r);
         }
 
         if (popoverVisible()) {
-            auto popoverSize = (*_popover)->size(r.size(), Layout::Hint::MIN);
-            (*_popover)->layout({_popoverAt, popoverSize});
+            auto popoverSize = (*_popover)->measure(r.size(), Layout::Hint::MIN);
+            (*_popover)->relayout({_popoverAt, popoverSize});
         }
     }
 
     Math::Vec2i size(Math::Vec2i s, Layout::Hint hint) override {
-        return child().size(s, hint);
+        return child().measure(s, hint);
     }
 
     Math::Recti bound() override {
@@ -21,15 +21,16 @@ struct Dismisable :
           _dir(dir),
           _threshold(threshold) {}
 
-    void reconcile(Dismisable &o) override {
-        if (not match(key(), o.key()))
+    bool reconcile(Dismisable &o) override {
+        bool changed = not match(key(), o.key());
+        if (changed)
             reset();
 
         _onDismis = std::move(o._onDismis);
         _dir = o._dir;
         _threshold = o._threshold;
 
-        ProxyNode<Dismisable>::reconcile(o);
+        return ProxyNode<Dismisable>::reconcile(o) or changed;
     }
 
     Math::Vec2i drag() const {
@@ -58,18 +59,20 @@ struct Dismisable :
             me->pos = me->pos - drag();
             child().event(e);
             me->pos = me->pos + drag();
-        } else if (e.is<Node::AnimateEvent>() and _dismissed and _drag.reached()) {
+        } else {
+            Ui::ProxyNode<Dismisable>::event(e);
+        }
+    }
+
+    void tick(f64 dt) override {
+        if (_dismissed and _drag.reached()) {
             _onDismis(*this);
             _dismissed = false;
-            Ui::ProxyNode<Dismisable>::event(e);
-        } else if (_drag.needRepaint(*this, e)) {
+        } else if (_drag.tick(*this, dt)) {
             auto oldBound = bound().clipTo(child().bound().offset(_last));
             auto newBound = bound().clipTo(child().bound().offset(drag()));
             _last = drag();
             Ui::shouldRepaint(*this, oldBound.mergeWith(newBound));
-            Ui::ProxyNode<Dismisable>::event(e);
-        } else {
-            Ui::ProxyNode<Dismisable>::event(e);
         }
     }
 
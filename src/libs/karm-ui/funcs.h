@@ -56,12 +56,29 @@ inline void shouldRepaint(Node &n, Math::Recti bound) {
     bubble<Node::PaintEvent>(n, bound);
 }
 
-inline void shouldLayout(Node &n) {
+// Lays out the node again, along with its ancestors since their layout
+// might depend on it, but leaves the rest of the tree alone. Only what
+// moves or changes while doing so is repainted.
+inline void shouldRelayout(Node &n) {
+    n.invalidateLayout();
+    for (auto *p = n.parent(); p; p = p->parent())
+        p->invalidateLayout();
     bubble<Node::LayoutEvent>(n);
 }
 
+// Same as shouldRelayout(), but the node is repainted as a whole.
+inline void shouldLayout(Node &n) {
+    n._changed = true;
+    shouldRelayout(n);
+}
+
 inline void shouldAnimate(Node &n) {
-    bubble<Node::AnimateEvent>(n, .0);
+    auto e = Async::makeEvent<Node::AnimateEvent>(Async::Propagation::UP, &n);
+    n.bubble(*e);
+
+    // The host picks it up once the node is attached to it.
+    if (not e->accepted())
+        Ticker::orphans().subscribe(n);
 }
 
 inline void mouseLeave(Node &n) {
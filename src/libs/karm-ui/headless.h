@@ -0,0 +1,267 @@
+#pragma once
+
+#include <karm-io/emit.h>
+#include <karm-media/image.h>
+#include <karm-media/loader.h>
+#include <karm-sys/file.h>
+
+#include "funcs.h"
+#include "host.h"
+
+namespace Karm::Ui {
+
+/* --- Script --------------------------------------------------------------- */
+
+// Input to feed to a headless host, each action is scheduled on
+// the frame the script was at when it was added.
+struct Script {
+    using Action = Func<void(Host &)>;
+
+    Vec<Cons<usize, Action>> _actions;
+    usize _frame = 0;
+
+    // How many frames the script lasts.
+    usize len() const {
+        return _frame;
+    }
+
+    Script &wait(usize frames = 1) {
+        _frame += frames;
+        return *this;
+    }
+
+    Script &then(Action action) {
+        _actions.pushBack({_frame, std::move(action)});
+        return *this;
+    }
+
+    Script &mouse(Events::MouseEvent e) {
+        return then([e](Host &host) {
+            event<Events::MouseEvent>(host, e);
+        });
+    }
+
+    Script &move(Math::Vec2i pos) {
+        return mouse({.type = Events::MouseEvent::MOVE, .pos = pos});
+    }
+
+    Script &click(Math::Vec2i pos) {
+        move(pos);
+        mouse({
+            .type = Events::MouseEvent::PRESS,
+            .pos = pos,
+            .buttons = Events::Button::LEFT,
+            .button = Events::Button::LEFT,
+        });
+        wait();
+        return mouse({
+            .type = Events::MouseEvent::RELEASE,
+            .pos = pos,
+            .button = Events::Button::LEFT,
+        });
+    }
+
+    Script &scroll(Math::Vec2i pos, Math::Vec2f notches) {
+        return mouse({
+            .type = Events::MouseEvent::SCROLL,
+            .pos = pos,
+            .scroll = notches,
+        });
+    }
+
+    Script &key(Events::Key k) {
+        then([k](Host &host) {
+            event<Events::KeyboardEvent>(host, Events::KeyboardEvent::PRESS, k);
+        });
+        return then([k](Host &host) {
+            event<Events::KeyboardEvent>(host, Events::KeyboardEvent::RELEASE, k);
+        });
+    }
+
+    Script &type(Str text) {
+        for (auto r : iterRunes(text)) {
+            then([r](Host &host) {
+                event<Events::TypedEvent>(host, r);
+            });
+        }
+        return *this;
+    }
+
+    Script &capture(Url::Url url) {
+        return then([url](Host &host) {
+            if (auto res = Media::saveImage(host.pixels(), url); not res)
+                logError("Could not save the frame to '{}': {}", url, res.none().msg());
+        });
+    }
+
+    // Pokes at an app it knows nothing about: hovers and clicks all
+    // over it, scrolls, tabs around, and lets animations settle
+    // in between. Clicks stay clear of the titlebar.
+    static Script explore(Math::Vec2i size) {
+        static constexpr isize TITLEBAR = 64;
+        static constexpr isize STEPS = 8;
+
+        Script s;
+        s.wait(30);
+
+        for (isize y = 0; y < STEPS; y++)
+            for (isize x = 0; x < STEPS; x++)
+                s.move({size.x * x / STEPS, size.y * y / STEPS}).wait();
+
+        Math::Vec2i center = {size.x / 2, size.y / 2};
+        for (usize i = 0; i < 20; i++)
+            s.scroll(center, {0, -1}).wait();
+        for (usize i = 0; i < 20; i++)
+            s.scroll(center, {0, 1}).wait();
+
+        for (isize y = 0; y < STEPS; y++) {
+            for (isize x = 0; x < STEPS; x++) {
+                isize py = TITLEBAR + (size.y - TITLEBAR) * y / STEPS;
+                s.click({size.x * x / STEPS + 8, py + 8}).wait(4);
+            }
+        }
+
+        for (usize i = 0; i < 8; i++)
+            s.key(Events::Key::TAB).wait();
+        s.key(Events::Key::DOWN).key(Events::Key::ENTER);
+        s.wait(60);
+
+        return s;
+    }
+};
+
+/* --- Headless Host -------------------------------------------------------- */
+
+// What a frame of a headless run cost.
+struct FrameReport {
+    FrameStats stats;
+    isize nodes;
+};
+
+// Renders into an image instead of a window, and plays a script
+// instead of waiting for input. Its clock moves by exactly one
+// frame each time it waits, so runs are reproducible.
+struct HeadlessHost : public Host {
+    Media::Image _image;
+    Script _script;
+    usize _nextAction = 0;
+    usize _frame = 0;
+    TimeStamp _now = TimeStamp::epoch();
+    Vec<FrameReport> _reports;
+
+    HeadlessHost(Child root, Math::Vec2i size, Script script = {})
+        : Host(root),
+          _image(Media::Image::alloc(size, Gfx::BGRA8888)),
+          _script(std::move(script)) {}
+
+    Gfx::MutPixels mutPixels() override {
+        return _image.mutPixels();
+    }
+
+    void flip(Slice<Math::Recti>) override {}
+
+    TimeStamp clock() override {
+        return _now;
+    }
+
+    void _endFrame() {
+        _reports.pushBack({_perf._stats, debugNodeCount});
+        _perf._stats = {};
+    }
+
+    void pump() override {
+        while (_nextAction < _script._actions.len() and
+               _script._actions[_nextAction].car <= _frame) {
+            _script._actions[_nextAction++].cdr(*this);
+        }
+
+        if (_frame >= _script.len())
+            bubble<Events::ExitEvent>(*this, Ok());
+    }
+
+    void wait(TimeSpan) override {
+        _endFrame();
+        _frame++;
+        _now = _now + TimeSpan::fromUSecs((usize)(FRAME_TIME * 1000000));
+    }
+
+    Res<> play() {
+        auto res = run();
+        _endFrame();
+        return res;
+    }
+
+    /* --- Report ----------------------------------------------------------- */
+
+    struct _Summary {
+        usize mean;
+        usize p95;
+        usize max;
+    };
+
+    _Summary _summarize(auto get) const {
+        Vec<usize> us;
+        usize total = 0;
+        for (auto &r : _reports) {
+            us.pushBack(get(r.stats).toUSecs());
+            total += last(us);
+        }
+
+        if (us.len() == 0)
+            return {};
+
+        sort(us);
+        return {
+            total / us.len(),
+            us[us.len() * 95 / 100],
+            last(us),
+        };
+    }
+
+    void summarize(Str name) const {
+        auto animate = _summarize([](auto &s) { return s.animate; });
+        auto layout = _summarize([](auto &s) { return s.layout; });
+        auto paint = _summarize([](auto &s) { return s.paint; });
+        auto present = _summarize([](auto &s) { return s.present; });
+
+        isize nodes = 0;
+        for (auto &r : _reports)
+            nodes = max(nodes, r.nodes);
+
+        logInfo(
+            "{}: {} frames, at most {} nodes, mean/p95/max in us: "
+            "animate {}/{}/{}, layout {}/{}/{}, paint {}/{}/{}, present {}/{}/{}",
+            name, _reports.len(), nodes,
+            animate.mean, animate.p95, animate.max,
+            layout.mean, layout.p95, layout.max,
+            paint.mean, paint.p95, paint.max,
+            present.mean, present.p95, present.max
+        );
+    }
+
+    // One line per frame, to be compared between runs.
+    Res<> saveReport(Url::Url url) const {
+        Io::StringWriter writer;
+        Io::Emit e{writer};
+        e.ln("frame,ticked,animate,layout,paint,present,nodes");
+        for (usize i = 0; i < _reports.len(); i++) {
+            auto &[stats, nodes] = _reports[i];
+            e.ln(
+                "{},{},{},{},{},{},{}",
+                i, stats.ticked,
+                stats.animate.toUSecs(), stats.layout.toUSecs(),
+                stats.paint.toUSecs(), stats.present.toUSecs(),
+                nodes
+            );
+        }
+        try$(e._error);
+
+        auto csv = writer.take();
+        auto file = try$(Sys::File::create(url));
+        try$(file.write(bytes(csv)));
+        try$(file.flush());
+        return Ok();
+    }
+};
+
+} // namespace Karm::Ui
@@ -4,17 +4,25 @@
 #include <karm-sys/time.h>
 
 #include "node.h"
+#include "tiles.h"
+#include "trace.h"
 
 namespace Karm::Ui {
 
 static constexpr auto FRAME_RATE = 60;
 static constexpr auto FRAME_TIME = 1.0 / FRAME_RATE;
 
+// Frames are paced on a monotonic clock, the wall clock can jump around.
+inline TimeStamp frameClock() {
+    return TimeStamp::epoch() + Sys::uptime();
+}
+
 enum struct PerfEvent {
     NONE,
     PAINT,
     LAYOUT,
     INPUT,
+    ANIMATE,
 };
 
 struct PerfRecord {
@@ -33,6 +41,9 @@ struct PerfRecord {
         case PerfEvent::INPUT:
             return Gfx::BLUE;
 
+        case PerfEvent::ANIMATE:
+            return Gfx::YELLOW;
+
         default:
             return Gfx::BLACK;
         }
@@ -43,17 +54,27 @@ struct PerfRecord {
     }
 };
 
+// What the last frame was made of.
+struct FrameStats {
+    usize ticked = 0;
+    TimeSpan animate{};
+    TimeSpan layout{};
+    TimeSpan paint{};
+    TimeSpan present{};
+};
+
 struct PerfGraph {
     usize _index{};
     Array<PerfRecord, 256> _records{};
     f64 _frameTime = 0;
+    FrameStats _stats{};
 
     void record(PerfEvent e) {
-        _records[_index % 256] = PerfRecord{e, Sys::now(), 0};
+        _records[_index % 256] = PerfRecord{e, frameClock(), 0};
     }
 
     auto end() {
-        auto n = Sys::now();
+        auto n = frameClock();
         auto rec = _records[_index % 256];
         auto elapsed = n - rec.start;
         _records[_index++ % 256].end = n;
@@ -95,6 +116,9 @@ struct PerfGraph {
         g.fillStyle(Gfx::WHITE);
         g.fill({8, 16}, text);
 
+        auto stats = Fmt::format("Ticked: {} Anim: {}us Paint: {}us", _stats.ticked, _stats.animate.toUSecs(), _stats.paint.toUSecs()).take();
+        g.fill({8, 32}, stats);
+
         g.restore();
     }
 };
@@ -106,8 +130,25 @@ struct Host : public Node {
     Vec<Math::Recti> _dirty;
     PerfGraph _perf;
 
+    // Large repaints are recorded once and rasterized tile by tile
+    // on all the cores, small ones are cheaper to paint directly.
+    bool _tiled = true;
+
+    // Whether the last frame could have been replayed over tiles, it
+    // couldn't if it used layers or filters, which tend to stay around.
+    bool _replayable = true;
+    Gfx::DisplayList _list;
+    Vec<Math::Recti> _tiles;
+    Opt<Strong<TileRaster>> _raster;
+
     bool _shouldLayout{};
-    bool _shouldAnimate{};
+
+    // Nodes that are animating, the rest of the tree isn't
+    // visited when frames are ticked.
+    Ticker _ticker;
+    bool _ticking = false;
+    TimeStamp _lastTick{};
+    TimeStamp _nextFrame{};
 
     Host(Child root) : _root(root) {
         _root->attach(this);
@@ -129,6 +170,12 @@ struct Host : public Node {
 
     virtual void wait(TimeSpan) = 0;
 
+    // What animations are paced on, hosts that don't run in
+    // real time can step it themselves.
+    virtual TimeStamp clock() {
+        return frameClock();
+    }
+
     bool alive() {
         return not _res;
     }
@@ -143,7 +190,10 @@ struct Host : public Node {
         g.clear(r, GRAY950);
         g.fillStyle(GRAY50);
 
-        _root->paint(g, r);
+        {
+            TraceScope trace{TraceKind::PAINT, *_root};
+            _root->paint(g, r);
+        }
 
         if (debugShowRepaintBounds) {
             g.fillStyle(Gfx::randomColor().withOpacity(0.25));
@@ -153,6 +203,58 @@ struct Host : public Node {
         g.restore();
     }
 
+    bool _paintTiled() {
+        static constexpr isize MIN_AREA = TILE_SIZE * TILE_SIZE * 16;
+
+        // NOTE: A recording that can't be replayed has to be painted
+        //       again directly, walking the tree and running the side
+        //       effects of painting twice, only try once it could be.
+        if (not _tiled or not _replayable)
+            return false;
+
+        isize area = 0;
+        for (auto &d : _dirty)
+            area += d.width * d.height;
+
+        if (area < MIN_AREA)
+            return false;
+
+        if (not _raster) {
+            auto raster = TileRaster::create();
+            if (not raster or raster.unwrap()->len() == 0) {
+                logWarn("Tiled repaint not available, falling back to direct painting");
+                _tiled = false;
+                return false;
+            }
+            _raster = raster.take();
+        }
+
+        _tiles.clear();
+        auto region = collectTiles(bound(), _dirty, _tiles);
+
+        _list.clear();
+        _g.record(_list);
+        paint(_g, region);
+        _g.stopRecording();
+
+        // Layers and filters read back what's under them and
+        // can't be split across tiles, the next frames are painted
+        // directly until they are gone.
+        if (not _list.replayable()) {
+            _replayable = false;
+            return false;
+        }
+
+        {
+            TraceScope trace{TraceKind::RASTER, "tiles"};
+            (*_raster)->render(_list, mutPixels(), _tiles);
+        }
+
+        _dirty.clear();
+        _dirty.pushBack(region);
+        return true;
+    }
+
     void paint() {
         if (debugShowPerfGraph)
             _dirty.pushBack({0, 0, 256, 100});
@@ -160,10 +262,15 @@ struct Host : public Node {
         _g.begin(mutPixels());
 
         _perf.record(PerfEvent::PAINT);
-        for (auto &d : _dirty) {
-            paint(_g, d);
+        if (not _paintTiled()) {
+            TraceScope trace{TraceKind::RASTER, "direct"};
+            for (auto &d : _dirty) {
+                paint(_g, d);
+            }
+            _replayable = not _g._readBack;
         }
         auto elapsed = _perf.end();
+        _perf._stats.paint = elapsed;
 
         if (elapsed.toMSecs() > 32) {
             logWarn("Paint took {} ms for {} nodes alive", elapsed.toMSecs(), debugNodeCount);
@@ -174,11 +281,17 @@ struct Host : public Node {
 
         _g.end();
 
-        flip(_dirty);
+        {
+            TraceScope trace{TraceKind::BLIT};
+            auto start = frameClock();
+            flip(_dirty);
+            _perf._stats.present = frameClock() - start;
+        }
         _dirty.clear();
     }
 
     void event(Async::Event &e) override {
+        TraceScope trace{TraceKind::INPUT};
         _perf.record(PerfEvent::INPUT);
         _root->event(e);
         auto elapsed = _perf.end();
@@ -188,18 +301,50 @@ struct Host : public Node {
         }
     }
 
+    // Past this many dirty rects, repainting their bounding box is
+    // cheaper than keeping track of each of them.
+    static constexpr usize MAX_DIRTY = 64;
+
+    // Relayouts report every node that moved, most of them
+    // are inside of another one that is already dirty.
+    void _invalidate(Math::Recti r) {
+        if (r.empty())
+            return;
+
+        if (_dirty.len() >= MAX_DIRTY) {
+            for (auto &d : _dirty)
+                r = r.mergeWith(d);
+            _dirty.clear();
+            _dirty.pushBack(r);
+            return;
+        }
+
+        for (auto &d : _dirty)
+            if (d.contains(r))
+                return;
+
+        for (usize i = 0; i < _dirty.len();) {
+            if (r.contains(_dirty[i]))
+                _dirty.removeAt(i);
+            else
+                i++;
+        }
+
+        _dirty.pushBack(r);
+    }
+
     void bubble(Async::Event &event) override {
         event
             .handle<Node::PaintEvent>([this](auto &e) {
-                _dirty.pushBack(e.bound);
+                _invalidate(e.bound);
                 return true;
             })
             .handle<Node::LayoutEvent>([this](auto &) {
                 _shouldLayout = true;
                 return true;
             })
-            .handle<Node::AnimateEvent>([this](auto &) {
-                _shouldAnimate = true;
+            .handle<Node::AnimateEvent>([this](auto &e) {
+                _subscribe(*e.node);
                 return true;
             })
             .handle<Events::ExitEvent>([this](auto &e) {
@@ -210,19 +355,72 @@ struct Host : public Node {
 
     void layout(Math::Recti r) override {
         _perf.record(PerfEvent::LAYOUT);
-        _root->layout(r);
+        _root->relayout(r);
         auto elapsed = _perf.end();
+        _perf._stats.layout = elapsed;
         if (elapsed.toMSecs() > 1) {
             logWarn("Layout took {}ms", elapsed.toMSecs());
             logDebug("There is {} nodes alive", debugNodeCount);
         }
     }
 
+    // Only the nodes that changed or moved are repainted, they
+    // report it while being laid out.
     void doLayout() {
         layout(bound());
         _shouldLayout = false;
-        _shouldAnimate = true;
-        _dirty.pushBack(bound());
+        _adoptOrphans();
+    }
+
+    void _subscribe(Node &n) {
+        // Animations starting after the host was idle get
+        // a single frame worth of time on their first tick.
+        if (not _ticking and not _ticker.any()) {
+            _lastTick = clock() - TimeSpan::fromUSecs((usize)(FRAME_TIME * 1000000));
+            _nextFrame = _lastTick;
+        }
+        _ticker.subscribe(n);
+    }
+
+    // Nodes that asked for frames before they were attached
+    // to the host, and are now part of its tree.
+    void _adoptOrphans() {
+        auto &orphans = Ticker::orphans();
+        for (auto *n = orphans._head; n;) {
+            auto *next = n->_nextTick;
+
+            Node *root = n;
+            while (root->parent())
+                root = root->parent();
+            if (root == this)
+                _subscribe(*n);
+
+            n = next;
+        }
+    }
+
+    bool shouldAnimate() {
+        return _ticker.any();
+    }
+
+    void doAnimate() {
+        auto now = clock();
+        f64 dt = (now - _lastTick).toUSecs() / 1000000.0;
+        _lastTick = now;
+
+        // Like vsync, frames keep to a fixed rate and the ones that
+        // were missed are dropped instead of being rushed out.
+        auto frame = TimeSpan::fromUSecs((usize)(FRAME_TIME * 1000000));
+        _nextFrame = _nextFrame + frame;
+        if (_nextFrame <= now)
+            _nextFrame = now + frame;
+
+        TraceScope trace{TraceKind::ANIMATE};
+        _perf.record(PerfEvent::ANIMATE);
+        _ticking = true;
+        _perf._stats.ticked = _ticker.tick(min(dt, FRAME_TIME * 4));
+        _ticking = false;
+        _perf._stats.animate = _perf.end();
     }
 
     void doPaint() {
@@ -234,26 +432,26 @@ struct Host : public Node {
         doLayout();
         doPaint();
 
-        auto lastFrame = Sys::now();
         while (not _res) {
             isize waitTime = -1;
-            if (_shouldAnimate) {
-                auto elapsed = Sys::now() - lastFrame;
-                waitTime = ((FRAME_TIME * 1000) - elapsed.toMSecs());
-                if (waitTime < 0)
-                    waitTime = 0;
+            if (shouldAnimate()) {
+                // NOTE: Round up, waking up before the frame is due
+                //       would only go back to waiting for nothing.
+                auto now = clock();
+                waitTime = now < _nextFrame ? ((_nextFrame - now).toUSecs() + 999) / 1000 : 0;
             }
 
             wait(TimeSpan::fromMSecs(waitTime));
-            lastFrame = Sys::now();
 
-            if (_shouldAnimate) {
-                _shouldAnimate = false;
-                auto e = Async::makeEvent<Node::AnimateEvent>(Async::Propagation::DOWN, FRAME_TIME);
-                event(*e);
-            }
+            TraceScope trace{TraceKind::FRAME};
+
+            // Input can wake us up early, animations are only
+            // ticked once the frame is due.
+            if (shouldAnimate() and clock() >= _nextFrame)
+                doAnimate();
 
             pump();
+            _adoptOrphans();
 
             if (_shouldLayout) {
                 doLayout();
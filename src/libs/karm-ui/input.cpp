@@ -176,8 +176,12 @@ struct Button : public _Box<Button> {
           _onPress(std::move(onPress)),
           _buttonStyle(style) {}
 
-    void reconcile(Button &o) override {
-        _buttonStyle = o._buttonStyle;
+    bool reconcile(Button &o) override {
+        bool changed = reconcileProp(_buttonStyle, o._buttonStyle);
+
+        // Callbacks can't be compared, but whether the button is
+        // enabled changes how it looks.
+        changed |= _onPress.has() != o._onPress.has();
         _onPress = std::move(o._onPress);
 
         if (!_onPress) {
@@ -185,7 +189,7 @@ struct Button : public _Box<Button> {
             _mouseListener = {};
         }
 
-        _Box<Button>::reconcile(o);
+        return _Box<Button>::reconcile(o) or changed;
     }
 
     BoxStyle &boxStyle() override {
@@ -272,9 +276,11 @@ struct Input : public View<Input> {
     Input(TextStyle style, String text, OnChange<String> onChange)
         : _style(style), _text(text), _onChange(std::move(onChange)) {}
 
-    void reconcile(Input &o) override {
-        _text = o._text;
+    bool reconcile(Input &o) override {
+        if (not reconcileProp(_text, o._text))
+            return false;
         _mesure = NONE;
+        return true;
     }
     // additional var's to store text buffer
     Str buffstr="";
@@ -373,9 +379,9 @@ struct Toggle : public View<Toggle> {
         : _value(value), _onChange(std::move(onChange)) {
     }
 
-    void reconcile(Toggle &o) override {
-        _value = o._value;
+    bool reconcile(Toggle &o) override {
         _onChange = std::move(o._onChange);
+        return reconcileProp(_value, o._value);
     }
 
     void paint(Gfx::Context &g, Math::Recti) override {
@@ -437,9 +443,9 @@ struct Checkbox : public View<Checkbox> {
         : _value(value), _onChange(std::move(onChange)) {
     }
 
-    void reconcile(Checkbox &o) override {
-        _value = o._value;
+    bool reconcile(Checkbox &o) override {
         _onChange = std::move(o._onChange);
+        return reconcileProp(_value, o._value);
     }
 
     void paint(Gfx::Context &g, Math::Recti) override {
@@ -496,9 +502,9 @@ struct Radio : public View<Radio> {
         : _value(value), _onChange(std::move(onChange)) {
     }
 
-    void reconcile(Radio &o) override {
-        _value = o._value;
+    bool reconcile(Radio &o) override {
         _onChange = std::move(o._onChange);
+        return reconcileProp(_value, o._value);
     }
 
     void paint(Gfx::Context &g, Math::Recti) override {
@@ -611,10 +617,11 @@ struct Slider : public View<Slider> {
         : _style(style), _value(value), _onChange(std::move(onChange)) {
     }
 
-    void reconcile(Slider &o) override {
-        _style = o._style;
-        _value = o._value;
+    bool reconcile(Slider &o) override {
+        bool changed = reconcileProp(_style, o._style);
+        changed |= reconcileProp(_value, o._value);
         _onChange = std::move(o._onChange);
+        return changed;
     }
 
     auto thumbRadius() {
@@ -686,16 +693,16 @@ struct Slider2 : public ProxyNode<Slider2> {
         : ProxyNode<Slider2>(std::move(child)), _value(value), _onChange(std::move(onChange)) {
     }
 
-    void reconcile(Slider2 &o) override {
-        _value = o._value;
+    bool reconcile(Slider2 &o) override {
+        bool changed = reconcileProp(_value, o._value);
         _onChange = o._onChange;
 
-        ProxyNode<Slider2>::reconcile(o);
+        return ProxyNode<Slider2>::reconcile(o) or changed;
     }
 
     void layout(Math::Recti r) override {
         _bound = r;
-        child().layout(_bound.hsplit(((r.width - r.height) * _value) + r.height).car);
+        child().relayout(_bound.hsplit(((r.width - r.height) * _value) + r.height).car);
     }
 
     Math::Recti bound() override {
@@ -712,7 +719,7 @@ struct Slider2 : public ProxyNode<Slider2> {
                 if (_onChange) {
                     _onChange(*this, _value);
                 } else {
-                    child().layout(_bound.hsplit(((_bound.width - _bound.height) * _value) + _bound.height).car);
+                    child().relayout(_bound.hsplit(((_bound.width - _bound.height) * _value) + _bound.height).car);
                     shouldRepaint(*this);
                 }
             }
@@ -119,6 +119,8 @@ struct ButtonStyle {
     ButtonStyle withPadding(Layout::Spacingi spacing) const;
 
     ButtonStyle withMargin(Layout::Spacingi spacing) const;
+
+    bool operator==(ButtonStyle const &) const = default;
 };
 
 using OnPress = Opt<Func<void(Node &)>>;
@@ -184,6 +186,8 @@ struct SliderStyle {
     static SliderStyle hsv();
 
     static SliderStyle gradiant(Gfx::Color from, Gfx::Color to);
+
+    bool operator==(SliderStyle const &) const = default;
 };
 
 Child slider(SliderStyle style, f64 value, OnChange<f64> onChange);
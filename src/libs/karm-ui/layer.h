@@ -0,0 +1,133 @@
+#pragma once
+
+#include <karm-gfx/context.h>
+#include <karm-math/funcs.h>
+#include <karm-media/image.h>
+
+namespace Karm::Ui {
+
+// A cached rendering of some content, so that moving it around costs
+// a blit instead of painting it all over again. Only the parts that
+// were damaged since are painted again into the cache.
+struct Layer {
+    Opt<Media::Image> _image;
+
+    // What the image covers, in the coordinates of the content.
+    Math::Recti _bound{};
+
+    // What has to be painted again before the next use.
+    Math::Recti _damage{};
+
+    bool cached() const {
+        return (bool)_image;
+    }
+
+    void drop() {
+        _image = NONE;
+        _damage = {};
+    }
+
+    void invalidate(Math::Recti r) {
+        if (not _image)
+            return;
+
+        r = r.clipTo(_bound);
+        if (r.empty())
+            return;
+
+        _damage = _damage.empty() ? r : _damage.mergeWith(r);
+    }
+
+    void invalidate() {
+        invalidate(_bound);
+    }
+
+    // Moves the cached pixels by the given amount, what gets
+    // uncovered has to be painted again.
+    void shift(Math::Vec2i delta) {
+        if (not _image or delta == Math::Vec2i{})
+            return;
+
+        auto pixels = _image->mutPixels();
+        auto size = pixels.size();
+        if (Math::abs(delta.x) >= size.x or Math::abs(delta.y) >= size.y) {
+            invalidate();
+            return;
+        }
+
+        usize bpp = pixels.fmt().bpp();
+        usize len = (size.x - Math::abs(delta.x)) * bpp;
+        isize srcX = max(0, -delta.x);
+        isize destX = max(0, delta.x);
+
+        auto moveRow = [&](isize y) {
+            if (y + delta.y < 0 or y + delta.y >= size.y)
+                return;
+            memmove(
+                pixels.pixelUnsafe({destX, y + delta.y}),
+                pixels.pixelUnsafe({srcX, y}),
+                len
+            );
+        };
+
+        // Rows are moved away from where they are going, so
+        // that they are not overwritten before being moved.
+        if (delta.y > 0) {
+            for (isize y = size.y - 1; y >= 0; y--)
+                moveRow(y);
+        } else {
+            for (isize y = 0; y < size.y; y++)
+                moveRow(y);
+        }
+
+        if (delta.y > 0)
+            invalidate(Math::Recti{0, 0, size.x, delta.y}.offset(_bound.xy));
+        else if (delta.y < 0)
+            invalidate(Math::Recti{0, size.y + delta.y, size.x, -delta.y}.offset(_bound.xy));
+
+        if (delta.x > 0)
+            invalidate(Math::Recti{0, 0, delta.x, size.y}.offset(_bound.xy));
+        else if (delta.x < 0)
+            invalidate(Math::Recti{size.x + delta.x, 0, -delta.x, size.y}.offset(_bound.xy));
+    }
+
+    // Brings the cache up to date, it is painted whole when the
+    // content moved or changed size.
+    void update(Math::Recti bound, Gfx::Fmt fmt, auto paint) {
+        if (bound.empty()) {
+            drop();
+            return;
+        }
+
+        if (not _image or _bound.wh != bound.wh) {
+            _image = Media::Image::alloc(bound.wh, fmt);
+            _bound = bound;
+            _damage = bound;
+        } else if (_bound.xy != bound.xy) {
+            _bound = bound;
+            _damage = bound;
+        }
+
+        if (_damage.empty())
+            return;
+
+        Gfx::Context g;
+        g.begin(_image->mutPixels());
+        g.origin(-_bound.xy);
+        g.clip(_damage);
+        g.clear(_damage, Gfx::ALPHA);
+        paint(g, _damage);
+        g.end();
+
+        _damage = {};
+    }
+
+    // Draws the cache where the content is, moved by the given offset.
+    void paint(Gfx::Context &g, Math::Vec2i offset = {}) {
+        if (not _image)
+            return;
+        g.blit(_bound.xy + offset, _image->pixels());
+    }
+};
+
+} // namespace Karm::Ui
@@ -14,8 +14,8 @@ struct Empty : public View<Empty> {
     Empty(Math::Vec2i size)
         : _size(size) {}
 
-    void reconcile(Empty &o) override {
-        _size = o._size;
+    bool reconcile(Empty &o) override {
+        return reconcileProp(_size, o._size);
     }
 
     Math::Vec2i size(Math::Vec2i, Layout::Hint) override {
@@ -58,11 +58,11 @@ struct Bound : public ProxyNode<Bound> {
 
     void layout(Math::Recti bound) override {
         _bound = bound;
-        child().layout(bound);
+        child().relayout(bound);
     }
 
     Math::Vec2i size(Math::Vec2i s, Layout::Hint hint) override {
-        return child().size(s, hint);
+        return child().measure(s, hint);
     }
 };
 
@@ -97,16 +97,16 @@ struct Align : public ProxyNode<Align> {
     Align(Layout::Align align, Child child) : ProxyNode(child), _align(align) {}
 
     void layout(Math::Recti bound) override {
-        auto childSize = child().size(bound.size(), _child.is<Grow>() ? Layout::Hint::MAX : Layout::Hint::MIN);
+        auto childSize = child().measure(bound.size(), _child.is<Grow>() ? Layout::Hint::MAX : Layout::Hint::MIN);
         child()
-            .layout(_align.apply<isize>(
+            .relayout(_align.apply<isize>(
                 Layout::Flow::LEFT_TO_RIGHT,
                 childSize,
                 bound));
     };
 
     Math::Vec2i size(Math::Vec2i s, Layout::Hint hint) override {
-        return _align.size(child().size(s, hint), s, hint);
+        return _align.size(child().measure(s, hint), s, hint);
     }
 };
 
@@ -166,11 +166,11 @@ struct Sizing : public ProxyNode<Sizing> {
 
     void layout(Math::Recti bound) override {
         _rect = bound;
-        child().layout(bound);
+        child().relayout(bound);
     }
 
     Math::Vec2i size(Math::Vec2i s, Layout::Hint hint) override {
-        auto result = child().size(s, hint);
+        auto result = child().measure(s, hint);
 
         if (_min.x != UNCONSTRAINED) {
             result.x = max(result.x, _min.x);
@@ -228,9 +228,9 @@ struct Spacing : public ProxyNode<Spacing> {
     Spacing(Layout::Spacingi spacing, Child child)
         : ProxyNode(child), _spacing(spacing) {}
 
-    void reconcile(Spacing &o) override {
-        _spacing = o._spacing;
-        ProxyNode<Spacing>::reconcile(o);
+    bool reconcile(Spacing &o) override {
+        bool changed = reconcileProp(_spacing, o._spacing);
+        return ProxyNode<Spacing>::reconcile(o) or changed;
     }
 
     void paint(Gfx::Context &g, Math::Recti r) override {
@@ -241,11 +241,11 @@ struct Spacing : public ProxyNode<Spacing> {
     }
 
     void layout(Math::Recti rect) override {
-        child().layout(_spacing.shrink(Layout::Flow::LEFT_TO_RIGHT, rect));
+        child().relayout(_spacing.shrink(Layout::Flow::LEFT_TO_RIGHT, rect));
     }
 
     Math::Vec2i size(Math::Vec2i s, Layout::Hint hint) override {
-        return child().size(s - _spacing.all(), hint) + _spacing.all();
+        return child().measure(s - _spacing.all(), hint) + _spacing.all();
     }
 
     Math::Recti bound() override {
@@ -265,9 +265,9 @@ struct AspectRatio : public ProxyNode<AspectRatio> {
     AspectRatio(f64 ratio, Child child)
         : ProxyNode(child), _ratio(ratio) {}
 
-    void reconcile(AspectRatio &o) override {
-        _ratio = o._ratio;
-        ProxyNode<AspectRatio>::reconcile(o);
+    bool reconcile(AspectRatio &o) override {
+        bool changed = reconcileProp(_ratio, o._ratio);
+        return ProxyNode<AspectRatio>::reconcile(o) or changed;
     }
 
     void paint(Gfx::Context &g, Math::Recti r) override {
@@ -278,7 +278,7 @@ struct AspectRatio : public ProxyNode<AspectRatio> {
     }
 
     void layout(Math::Recti rect) override {
-        child().layout(rect);
+        child().relayout(rect);
     }
 
     Math::Vec2i size(Math::Vec2i s, Layout::Hint) override {
@@ -305,7 +305,7 @@ struct StackLayout : public GroupNode<StackLayout> {
     void layout(Math::Recti r) override {
         _bound = r;
         for (auto &child : children()) {
-            child->layout(r);
+            child->relayout(r);
         }
     }
 
@@ -372,8 +372,8 @@ struct DockLayout : public GroupNode<DockLayout> {
         auto outer = bound;
 
         for (auto &child : children()) {
-            Math::Recti inner = child->size(outer.size(), Layout::Hint::MIN);
-            child->layout(getDock(child).apply(inner, outer));
+            Math::Recti inner = child->measure(outer.size(), Layout::Hint::MIN);
+            child->relayout(getDock(child).apply(inner, outer));
         }
     }
 
@@ -401,7 +401,7 @@ struct DockLayout : public GroupNode<DockLayout> {
     Math::Vec2i size(Math::Vec2i s, Layout::Hint hint) override {
         Math::Vec2i currentSize{};
         for (auto &child : mutIterRev(children())) {
-            currentSize = apply(getDock(child).orien(), child->size(currentSize, Layout::Hint::MIN), currentSize);
+            currentSize = apply(getDock(child).orien(), child->measure(currentSize, Layout::Hint::MIN), currentSize);
         }
 
         if (hint == Layout::Hint::MAX) {
@@ -458,9 +458,9 @@ struct FlowLayout : public GroupNode<FlowLayout> {
     FlowLayout(FlowStyle style, Children children)
         : GroupNode(children), _style(style) {}
 
-    void reconcile(FlowLayout &o) override {
-        _style = o._style;
-        GroupNode::reconcile(o);
+    bool reconcile(FlowLayout &o) override {
+        bool changed = reconcileProp(_style, o._style);
+        return GroupNode::reconcile(o) or changed;
     }
 
     f64 computeGrowUnit(Math::Recti r) {
@@ -471,7 +471,7 @@ struct FlowLayout : public GroupNode<FlowLayout> {
             if (child.is<Grow>()) {
                 grows += child.unwrap<Grow>().grow();
             } else {
-                total += _style.flow.getX(child->size(r.size(), Layout::Hint::MIN));
+                total += _style.flow.getX(child->measure(r.size(), Layout::Hint::MIN));
             }
         }
 
@@ -488,7 +488,7 @@ struct FlowLayout : public GroupNode<FlowLayout> {
 
         for (auto &child : children()) {
             Math::Recti inner = {};
-            auto childSize = child->size(r.size(), Layout::Hint::MIN);
+            auto childSize = child->measure(r.size(), Layout::Hint::MIN);
 
             inner = _style.flow.setStart(inner, (isize)start);
             if (child.is<Grow>()) {
@@ -500,7 +500,7 @@ struct FlowLayout : public GroupNode<FlowLayout> {
             inner = _style.flow.setTop(inner, _style.flow.getTop(r));
             inner = _style.flow.setBottom(inner, _style.flow.getBottom(r));
 
-            child->layout(_style.align.apply(_style.flow, Math::Recti{childSize}, inner));
+            child->relayout(_style.align.apply(_style.flow, Math::Recti{childSize}, inner));
             start += _style.flow.getWidth(inner) + _style.gaps;
         }
     }
@@ -514,7 +514,7 @@ struct FlowLayout : public GroupNode<FlowLayout> {
             if (child.is<Grow>())
                 grow = true;
 
-            auto childSize = child->size(s, Layout::Hint::MIN);
+            auto childSize = child->measure(s, Layout::Hint::MIN);
             w += _style.flow.getX(childSize);
             h = max(h, _style.flow.getY(childSize));
         }
@@ -638,7 +638,7 @@ struct GridLayout : public GroupNode<GridLayout> {
             endRow.end() - startRow.start,
         };
 
-        child->layout(childRect);
+        child->relayout(childRect);
     }
 
     void layout(Math::Recti r) override {
@@ -284,6 +284,8 @@ struct FlowStyle {
     static FlowStyle vertical(isize gaps = 0, Layout::Align align = Layout::Align::FILL) {
         return FlowStyle{Layout::Flow::TOP_TO_BOTTOM, align, gaps};
     }
+
+    bool operator==(FlowStyle const &) const = default;
 };
 
 Child flow(FlowStyle style, Children children);
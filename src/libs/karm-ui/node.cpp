@@ -1,3 +1,4 @@
+#include <karm-ui/funcs.h>
 #include <karm-ui/node.h>
 
 namespace Karm::Ui {
@@ -9,4 +10,243 @@ bool debugShowScrollBounds = false;
 bool debugShowPerfGraph = false;
 int debugNodeCount = 0;
 
+/* --- Ticker --------------------------------------------------------------- */
+
+Ticker &Ticker::orphans() {
+    static Ticker orphans;
+    return orphans;
+}
+
+/* --- Incremental Layout --------------------------------------------------- */
+
+Math::Vec2i Node::measure(Math::Vec2i s, Layout::Hint hint) {
+    for (usize i = 0; i < min(_measured, MEASURES); i++) {
+        auto &m = _measures[i];
+        if (m.s == s and m.hint == hint)
+            return m.result;
+    }
+
+    TraceScope trace{TraceKind::SIZE, *this};
+    auto result = size(s, hint);
+    _measures[_measured++ % MEASURES] = {s, hint, result};
+    return result;
+}
+
+// How many of the nodes being laid out are going to be repainted
+// as a whole, their descendants don't have to ask for it again.
+static usize _repainting = 0;
+
+void Node::relayout(Math::Recti r) {
+    if (not _needsLayout and r == _laidOut)
+        return;
+
+    TraceScope trace{TraceKind::LAYOUT, *this};
+
+    bool covered = _repainting > 0;
+    bool changed = _changed;
+    auto old = bound();
+
+    _repainting += changed;
+    layout(r);
+    _repainting -= changed;
+
+    _changed = false;
+    _needsLayout = false;
+    _laidOut = r;
+
+    if (covered)
+        return;
+
+    // NOTE: The parent might not use the same coordinates as its
+    //       children (eg. scroll), so repaints go through it.
+    auto now = bound();
+    Node &from = parent() ? *parent() : *this;
+    if (changed or now != old) {
+        shouldRepaint(from, old);
+        if (now != old)
+            shouldRepaint(from, now);
+    }
+}
+
+/* --- Reconciliation ------------------------------------------------------- */
+
+static constexpr usize NIL = ~0uz;
+
+// Marks the longest run of children whose old indices are increasing,
+// they kept their relative order, all the other reused ones moved.
+static void _markStable(Slice<usize> sources, MutSlice<bool> stable) {
+    // tails[l] is the child ending the smallest run of length l + 1.
+    Vec<usize> tails;
+    Vec<usize> prev;
+    prev.resize(sources.len(), NIL);
+
+    for (usize i = 0; i < sources.len(); i++) {
+        if (sources[i] == NIL)
+            continue;
+
+        usize lo = 0, hi = tails.len();
+        while (lo < hi) {
+            usize mid = (lo + hi) / 2;
+            if (sources[tails[mid]] < sources[i])
+                lo = mid + 1;
+            else
+                hi = mid;
+        }
+
+        if (lo > 0)
+            prev[i] = tails[lo - 1];
+
+        if (lo == tails.len())
+            tails.pushBack(i);
+        else
+            tails[lo] = i;
+    }
+
+    if (tails.len() == 0)
+        return;
+
+    for (usize i = last(tails); i != NIL; i = prev[i])
+        stable[i] = true;
+}
+
+// Finds which old child each new one reuses, or NIL for the new ones.
+static void _matchChildren(Children &us, Children &them, Vec<usize> &sources) {
+    // Keyed children are looked up by key, the others are
+    // matched in order.
+    Vec<Cons<Hash, usize>> keyed;
+    Vec<usize> unkeyed;
+    for (usize i = 0; i < us.len(); i++) {
+        if (auto key = us[i]->key())
+            keyed.pushBack({*key, i});
+        else
+            unkeyed.pushBack(i);
+    }
+
+    sort(keyed, [](auto const &a, auto const &b) {
+        if (a.car != b.car)
+            return a.car <=> b.car;
+        return a.cdr <=> b.cdr;
+    });
+
+    Vec<bool> used;
+    used.resize(us.len(), false);
+    usize nextUnkeyed = 0;
+
+    for (auto &child : them) {
+        usize source = NIL;
+
+        if (auto key = child->key()) {
+            usize lo = 0, hi = keyed.len();
+            while (lo < hi) {
+                usize mid = (lo + hi) / 2;
+                if (keyed[mid].car < *key)
+                    lo = mid + 1;
+                else
+                    hi = mid;
+            }
+
+            // Duplicated keys are reused in the order they come.
+            for (; lo < keyed.len() and keyed[lo].car == *key; lo++) {
+                if (not used[keyed[lo].cdr]) {
+                    source = keyed[lo].cdr;
+                    break;
+                }
+            }
+        } else if (nextUnkeyed < unkeyed.len()) {
+            source = unkeyed[nextUnkeyed++];
+        }
+
+        if (source != NIL)
+            used[source] = true;
+        sources.pushBack(source);
+    }
+}
+
+static bool _anyNeedsLayout(Children &children) {
+    for (auto &c : children)
+        if (c->_needsLayout)
+            return true;
+    return false;
+}
+
+bool reconcileChildren(Node &parent, Children &us, Children &them) {
+    bool keyed = false;
+    for (auto &c : us)
+        keyed = keyed or c->key().has();
+    for (auto &c : them)
+        keyed = keyed or c->key().has();
+
+    // Without keys, children are matched by position and none of them moves.
+    if (not keyed) {
+        for (usize i = 0; i < them.len(); i++) {
+            if (i < us.len()) {
+                if (auto fresh = us[i]->reconcile(them[i])) {
+                    shouldRepaint(parent, us[i]->bound());
+                    us[i]->detach(&parent);
+                    us.replace(i, *fresh);
+                }
+            } else {
+                us.insert(i, them[i]);
+            }
+            us[i]->attach(&parent);
+        }
+
+        bool removed = us.len() > them.len();
+        for (usize i = them.len(); i < us.len(); i++) {
+            shouldRepaint(parent, us[i]->bound());
+            us[i]->detach(&parent);
+        }
+        us.truncate(them.len());
+        return removed or _anyNeedsLayout(us);
+    }
+
+    Vec<usize> sources;
+    _matchChildren(us, them, sources);
+
+    Vec<bool> stable;
+    stable.resize(them.len(), false);
+    _markStable(sources, stable);
+
+    Vec<bool> used;
+    used.resize(us.len(), false);
+
+    Children result;
+    result.ensure(them.len());
+    for (usize i = 0; i < them.len(); i++) {
+        if (sources[i] == NIL) {
+            result.pushBack(them[i]);
+        } else {
+            auto &old = us[sources[i]];
+            used[sources[i]] = true;
+
+            if (auto fresh = old->reconcile(them[i])) {
+                shouldRepaint(parent, old->bound());
+                old->detach(&parent);
+                result.pushBack(*fresh);
+            } else {
+                // Moved children are repainted where they were, their
+                // new place is repainted once they are laid out.
+                if (not stable[i]) {
+                    shouldRepaint(parent, old->bound());
+                    old->invalidate();
+                }
+                result.pushBack(old);
+            }
+        }
+        last(result)->attach(&parent);
+    }
+
+    bool removed = false;
+    for (usize i = 0; i < us.len(); i++) {
+        if (used[i])
+            continue;
+        shouldRepaint(parent, us[i]->bound());
+        us[i]->detach(&parent);
+        removed = true;
+    }
+
+    us = std::move(result);
+    return removed or _anyNeedsLayout(us);
+}
+
 } // namespace Karm::Ui
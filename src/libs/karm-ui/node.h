@@ -4,12 +4,14 @@
 #include <karm-base/checked.h>
 #include <karm-base/func.h>
 #include <karm-base/hash.h>
+#include <karm-base/reflect.h>
 #include <karm-events/events.h>
 #include <karm-gfx/context.h>
 #include <karm-layout/size.h>
 #include <karm-logger/logger.h>
 
 #include "theme.h"
+#include "trace.h"
 
 namespace Karm::Ui {
 
@@ -43,6 +45,30 @@ inline bool match(Key lhs, Key rhs) {
 struct Node : public Meta::Static {
     Key _key = NONE;
 
+    struct _Measure {
+        Math::Vec2i s;
+        Layout::Hint hint;
+        Math::Vec2i result;
+    };
+
+    static constexpr usize MEASURES = 4;
+
+    // The node itself changed since it was last laid out, it gets
+    // repainted after its next layout even if it didn't move.
+    bool _changed = true;
+
+    // The node or one of its descendants has to be laid out again.
+    bool _needsLayout = true;
+    Math::Recti _laidOut{};
+
+    // Recent results of size(), until the layout is invalidated.
+    Array<_Measure, MEASURES> _measures{};
+    usize _measured = 0;
+
+    // Links of the node in the ticker it subscribed to, if any.
+    Node *_nextTick = nullptr;
+    Node **_prevTick = nullptr;
+
     struct PaintEvent {
         Math::Recti bound;
     };
@@ -50,22 +76,28 @@ struct Node : public Meta::Static {
     struct LayoutEvent {
     };
 
+    // Asks the host to tick the node on the next frame.
     struct AnimateEvent {
-        f64 dt;
+        Node *node;
     };
 
     Node() {
         debugNodeCount++;
+        debugNodeCreated++;
     }
 
     virtual ~Node() {
         debugNodeCount--;
+        _unlinkTick();
     }
 
     Key key() const {
         return _key;
     }
 
+    // What the node shows up as in traces.
+    virtual Str typeName() const { return "Node"; }
+
     virtual Opt<Child> reconcile(Child other) { return other; }
 
     virtual void paint(Gfx::Context &, Math::Recti) {}
@@ -76,6 +108,10 @@ struct Node : public Meta::Static {
 
     virtual void layout(Math::Recti) {}
 
+    // Moves the animations of the node forward by dt seconds, called
+    // once per frame for as long as the node asks for it.
+    virtual void tick(f64) {}
+
     virtual Math::Vec2i size(Math::Vec2i s, Layout::Hint) { return s; }
 
     virtual Math::Recti bound() { return {}; }
@@ -85,6 +121,88 @@ struct Node : public Meta::Static {
     virtual void attach(Node *) {}
 
     virtual void detach(Node *) {}
+
+    /* --- Incremental Layout --- */
+
+    void invalidateLayout() {
+        _needsLayout = true;
+        _measured = 0;
+    }
+
+    void invalidate() {
+        _changed = true;
+        invalidateLayout();
+    }
+
+    void _unlinkTick() {
+        if (not _prevTick)
+            return;
+
+        *_prevTick = _nextTick;
+        if (_nextTick)
+            _nextTick->_prevTick = _prevTick;
+
+        _nextTick = nullptr;
+        _prevTick = nullptr;
+    }
+
+    // Same as size(), but remembers the result for the
+    // given constraint until the layout is invalidated.
+    Math::Vec2i measure(Math::Vec2i s, Layout::Hint hint);
+
+    // Same as layout(), but does nothing if the node didn't change since
+    // it was laid out in the same rect. Repaints the node if it changed
+    // or moved.
+    void relayout(Math::Recti r);
+};
+
+/* --- Ticker --------------------------------------------------------------- */
+
+// The nodes that asked to be ticked on the next frame, they are linked
+// together so that subscribing and unsubscribing is O(1), and nodes
+// that are destroyed remove themselves.
+struct Ticker : public Meta::Static {
+    Node *_head = nullptr;
+
+    // Nodes that asked for a frame before being attached to a host.
+    static Ticker &orphans();
+
+    ~Ticker() {
+        while (_head)
+            _head->_unlinkTick();
+    }
+
+    bool any() const {
+        return _head != nullptr;
+    }
+
+    void subscribe(Node &n) {
+        n._unlinkTick();
+
+        n._nextTick = _head;
+        if (_head)
+            _head->_prevTick = &n._nextTick;
+        n._prevTick = &_head;
+        _head = &n;
+    }
+
+    // Ticks all the nodes that subscribed, and unsubscribes them. The
+    // ones that are still animating subscribe again while being ticked.
+    usize tick(f64 dt) {
+        Node *pending = _head;
+        _head = nullptr;
+        if (pending)
+            pending->_prevTick = &pending;
+
+        usize ticked = 0;
+        while (pending) {
+            auto *n = pending;
+            n->_unlinkTick();
+            n->tick(dt);
+            ticked++;
+        }
+        return ticked;
+    }
 };
 
 inline auto key(Hashable auto const &key) {
@@ -115,13 +233,33 @@ ALWAYS_INLINE auto operator|(Decorator auto decorator, Decorator auto decorator2
 
 /* --- LeafNode ------------------------------------------------------------- */
 
+// Takes the value a property was rebuilt with, and tells if it differs
+// from the current one. Values that can't be compared always differ.
+template <typename T>
+bool reconcileProp(T &ours, T &theirs) {
+    if constexpr (Meta::Equatable<T>) {
+        if (ours == theirs)
+            return false;
+    }
+    ours = std::move(theirs);
+    return true;
+}
+
 template <typename Crtp>
 struct LeafNode : public Node {
     Node *_parent = nullptr;
 
-    virtual void reconcile(Crtp &) {}
+    // Takes the properties of the node it was rebuilt as, returns
+    // whether any of them changed, which repaints the node.
+    virtual bool reconcile(Crtp &) { return false; }
+
+    Str typeName() const override {
+        return nameOf<Crtp>();
+    }
 
     Opt<Child> reconcile(Child other) override {
+        TraceScope trace{TraceKind::RECONCILE, *this};
+
         if (this == &other.unwrap()) {
             debug("reconcile() called on self");
             return NONE;
@@ -130,7 +268,8 @@ struct LeafNode : public Node {
         if (not other.is<Crtp>())
             return other;
 
-        reconcile(other.unwrap<Crtp>());
+        if (reconcile(other.unwrap<Crtp>()))
+            this->invalidate();
         return NONE;
     }
 
@@ -155,6 +294,12 @@ struct LeafNode : public Node {
 
 /* --- GroupNode ------------------------------------------------------------ */
 
+// Reconciles the children of a group with the ones it was rebuilt with.
+// Children are matched by key when they have one and by position
+// otherwise, the ones that are reused keep their state. Returns whether
+// the group has to be laid out again.
+bool reconcileChildren(Node &parent, Children &us, Children &them);
+
 template <typename Crtp>
 struct GroupNode : public LeafNode<Crtp> {
     Children _children;
@@ -182,20 +327,17 @@ struct GroupNode : public LeafNode<Crtp> {
         return _children;
     }
 
-    void reconcile(Crtp &o) override {
-        auto &us = children();
-        auto &them = o.children();
-
-        for (usize i = 0; i < them.len(); i++) {
-            if (i < us.len()) {
-                us.replace(i, tryOr(us[i]->reconcile(them[i]), us[i]));
-            } else {
-                us.insert(i, them[i]);
-            }
-            us[i]->attach(this);
-        }
+    // Groups don't paint anything by themselves, only the children
+    // that changed or moved have to be repainted.
+    Opt<Child> reconcile(Child other) override {
+        bool changed = this->_changed;
+        auto res = LeafNode<Crtp>::reconcile(other);
+        this->_changed = changed;
+        return res;
+    }
 
-        us.truncate(them.len());
+    bool reconcile(Crtp &o) override {
+        return reconcileChildren(*this, children(), o.children());
     }
 
     void paint(Gfx::Context &g, Math::Recti r) override {
@@ -203,6 +345,7 @@ struct GroupNode : public LeafNode<Crtp> {
             if (not child->bound().colide(r))
                 continue;
 
+            TraceScope trace{TraceKind::PAINT, *child};
             child->paint(g, r);
         }
     }
@@ -222,7 +365,7 @@ struct GroupNode : public LeafNode<Crtp> {
         _bound = r;
 
         for (auto &child : children()) {
-            child->layout(r);
+            child->relayout(r);
         }
     }
 
@@ -253,13 +396,23 @@ struct ProxyNode : public LeafNode<Crtp> {
         return *_child;
     }
 
-    void reconcile(Crtp &o) override {
-        _child = tryOr(_child->reconcile(o._child), _child);
-        _child->attach(this);
-        LeafNode<Crtp>::reconcile(o);
+    bool reconcile(Crtp &o) override {
+        if (auto fresh = _child->reconcile(o._child)) {
+            _child->detach(this);
+            _child = *fresh;
+            _child->attach(this);
+            return true;
+        }
+
+        // The child repaints itself if it changed, the proxy only
+        // has to make room for it.
+        if (_child->_needsLayout)
+            this->invalidateLayout();
+        return false;
     }
 
     void paint(Gfx::Context &g, Math::Recti r) override {
+        TraceScope trace{TraceKind::PAINT, child()};
         child().paint(g, r);
     }
 
@@ -271,11 +424,11 @@ struct ProxyNode : public LeafNode<Crtp> {
     }
 
     void layout(Math::Recti r) override {
-        child().layout(r);
+        child().relayout(r);
     }
 
     Math::Vec2i size(Math::Vec2i s, Layout::Hint hint) override {
-        return child().size(s, hint);
+        return child().measure(s, hint);
     }
 
     Math::Recti bound() override {
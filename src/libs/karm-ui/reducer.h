@@ -64,16 +64,22 @@ struct Reducer :
 
     /* --- Build ------------------------------------------------------------ */
 
+    Child _buildChild() {
+        TraceScope trace{TraceKind::BUILD, *this};
+        return _build(_state);
+    }
+
     void rebuild() {
         if (_child) {
-            auto tmp = (*_child)->reconcile(_build(_state));
+            auto tmp = (*_child)->reconcile(_buildChild());
             if (tmp) {
+                shouldRepaint(*this, (*_child)->bound());
                 (*_child)->detach(this);
                 _child = tmp;
                 (*_child)->attach(this);
             }
         } else {
-            _child = _build(_state);
+            _child = _buildChild();
             (*_child)->attach(this);
         }
     }
@@ -87,9 +93,13 @@ struct Reducer :
 
     /* --- Node ------------------------------------------------------------- */
 
-    void reconcile(Reducer &o) override {
+    // The reducer doesn't paint anything by itself, what changed
+    // is found once it rebuilt its child.
+    bool reconcile(Reducer &o) override {
         _build = std::move(o._build);
         _rebuild = true;
+        this->invalidateLayout();
+        return false;
     }
 
     void paint(Gfx::Context &g, Math::Recti r) override {
@@ -109,7 +119,7 @@ struct Reducer :
             e.accept();
 
             _rebuild = true;
-            shouldLayout(*this);
+            shouldRelayout(*this);
         }
 
         LeafNode<Reducer<Model>>::bubble(e);
@@ -117,12 +127,12 @@ struct Reducer :
 
     void layout(Math::Recti r) override {
         ensureBuild();
-        (*_child)->layout(r);
+        (*_child)->relayout(r);
     }
 
     Math::Vec2i size(Math::Vec2i s, Layout::Hint hint) override {
         ensureBuild();
-        return (*_child)->size(s, hint);
+        return (*_child)->measure(s, hint);
     }
 
     Math::Recti bound() override {
@@ -1,9 +1,15 @@
+#include "layer.h"
 #include "scroll.h"
 
 namespace Karm::Ui {
 
 /* --- Scroll --------------------------------------------------------------- */
 
+// Sent by a scroll to its content with the part of it that is visible.
+struct ViewportEvent {
+    Math::Recti bound;
+};
+
 struct Scroll : public ProxyNode<Scroll> {
     bool _mouseIn = false;
     bool _animated = false;
@@ -12,16 +18,23 @@ struct Scroll : public ProxyNode<Scroll> {
     Math::Vec2f _scroll{};
     Math::Vec2f _targetScroll{};
 
+    Layer _layer;
+    Math::Vec2i _layerScroll{};
+
     Scroll(Child child, Layout::Orien orient)
         : ProxyNode(child), _orient(orient) {}
 
+    void viewport() {
+        Ui::event<ViewportEvent>(child(), Math::Recti{_bound.xy - _scroll.cast<isize>(), _bound.wh});
+    }
+
     void scroll(Math::Vec2i s) {
         auto childBound = child().bound();
         _targetScroll.x = clamp(s.x, -(childBound.width - min(childBound.width, bound().width)), 0);
         _targetScroll.y = clamp(s.y, -(childBound.height - min(childBound.height, bound().height)), 0);
     }
 
-    void paint(Gfx::Context &g, Math::Recti r) override {
+    void _paintContent(Gfx::Context &g, Math::Recti r) {
         g.save();
         g.clip(_bound);
         g.origin(_scroll.cast<isize>());
@@ -32,6 +45,28 @@ struct Scroll : public ProxyNode<Scroll> {
             g.debugRect(child().bound(), Gfx::PINK);
 
         g.restore();
+    }
+
+    void paint(Gfx::Context &g, Math::Recti r) override {
+        // While scrolling, what was already painted is moved along
+        // and only what came into view is painted.
+        if (_animated) {
+            auto scroll = _scroll.cast<isize>();
+            _layer.shift(scroll - _layerScroll);
+            _layerScroll = scroll;
+
+            _layer.update(_bound, g.pixels().fmt(), [&](Gfx::Context &lg, Math::Recti lr) {
+                _paintContent(lg, lr);
+            });
+
+            g.save();
+            g.clip(_bound);
+            _layer.paint(g);
+            g.restore();
+        } else {
+            _layer.drop();
+            _paintContent(g, r);
+        }
 
         if (debugShowScrollBounds)
             g.debugRect(_bound, Gfx::CYAN);
@@ -57,27 +92,36 @@ struct Scroll : public ProxyNode<Scroll> {
                 _mouseIn = false;
                 mouseLeave(*_child);
             }
-        } else if (e.is<Node::AnimateEvent>() and _animated) {
-            shouldRepaint(*parent(), bound());
+        } else if (e.is<ViewportEvent>()) {
+            // Only meant for the content of the scroll that sent it.
+        } else {
+            ProxyNode<Scroll>::event(e);
+        }
+    }
 
-            _scroll = _scroll + (_targetScroll - _scroll) * (e.unwrap<Node::AnimateEvent>().dt * 20);
+    void tick(f64 dt) override {
+        if (not _animated)
+            return;
 
-            if (_scroll.dist(_targetScroll) < 0.5) {
-                _scroll = _targetScroll;
-                _animated = false;
-            } else {
-                shouldAnimate(*this);
-            }
+        shouldRepaint(*parent(), bound());
+
+        _scroll = _scroll + (_targetScroll - _scroll) * min(dt * 20, 1.0);
 
+        if (_scroll.dist(_targetScroll) < 0.5) {
+            _scroll = _targetScroll;
+            _animated = false;
         } else {
-            ProxyNode<Scroll>::event(e);
+            shouldAnimate(*this);
         }
+
+        viewport();
     }
 
     void bubble(Async::Event &e) override {
         if (auto *pe = e.is<Node::PaintEvent>()) {
             pe->bound.xy = pe->bound.xy + _scroll.cast<isize>();
             pe->bound = pe->bound.clipTo(bound());
+            _layer.invalidate(pe->bound);
         }
 
         ProxyNode::bubble(e);
@@ -85,19 +129,24 @@ struct Scroll : public ProxyNode<Scroll> {
 
     void layout(Math::Recti r) override {
         _bound = r;
-        auto childSize = child().size(_bound.size(), Layout::Hint::MAX);
+        viewport();
+
+        auto childSize = child().measure(_bound.size(), Layout::Hint::MAX);
         if (_orient == Layout::Orien::HORIZONTAL) {
             childSize.height = r.height;
         } else if (_orient == Layout::Orien::VERTICAL) {
             childSize.width = r.width;
         }
         r.wh = childSize;
-        child().layout(r);
-        scroll(_scroll.cast<isize>());
+        child().relayout(r);
+
+        // NOTE: Lists lay themselves out again while being scrolled,
+        //       only clamp the target to the new size, don't stop there.
+        scroll(_targetScroll.cast<isize>());
     }
 
     Math::Vec2i size(Math::Vec2i s, Layout::Hint hint) override {
-        auto childSize = child().size(s, hint);
+        auto childSize = child().measure(s, hint);
 
         if (hint == Layout::Hint::MIN) {
             if (_orient == Layout::Orien::HORIZONTAL) {
@@ -129,4 +178,351 @@ Child vscroll(Child child) {
     return makeStrong<Scroll>(child, Layout::Orien::VERTICAL);
 }
 
+/* --- Virtual List --------------------------------------------------------- */
+
+// Sizes of the items of a list along its main axis. Either they all have
+// the same size or they are measured as they get built, and are kept in
+// a fenwick tree so that both the offset of an item and the item at an
+// offset can be found in O(log n).
+struct ListExtents {
+    usize _len = 0;
+    isize _fixed = 0;
+    isize _total = 0;
+    Vec<isize> _sizes;
+    Vec<isize> _tree;
+
+    ListExtents(usize len, isize fixed)
+        : _len(len), _fixed(fixed) {}
+
+    usize len() const {
+        return _len;
+    }
+
+    bool fixed() const {
+        return _fixed > 0;
+    }
+
+    bool ready() const {
+        return fixed() or _tree.len() == _len + 1;
+    }
+
+    // Gives all the items the same estimated size, until they are measured.
+    void reset(isize estimate) {
+        _sizes.clear();
+        _sizes.resize(_len, estimate);
+
+        _tree.clear();
+        _tree.resize(_len + 1, 0);
+        for (usize i = 1; i <= _len; i++) {
+            _tree[i] += estimate;
+            usize j = i + (i & -i);
+            if (j <= _len)
+                _tree[j] += _tree[i];
+        }
+
+        _total = estimate * (isize)_len;
+    }
+
+    isize size(usize index) const {
+        return fixed() ? _fixed : _sizes[index];
+    }
+
+    void update(usize index, isize size) {
+        isize delta = size - _sizes[index];
+        _sizes[index] = size;
+        _total += delta;
+        for (usize j = index + 1; j <= _len; j += j & -j)
+            _tree[j] += delta;
+    }
+
+    isize offset(usize index) const {
+        if (fixed())
+            return _fixed * (isize)index;
+
+        isize off = 0;
+        for (usize j = index; j > 0; j -= j & -j)
+            off += _tree[j];
+        return off;
+    }
+
+    // The item at the given offset, clamped to the list.
+    usize indexAt(isize off) const {
+        if (_len == 0 or off < 0)
+            return 0;
+
+        if (fixed())
+            return min((usize)(off / _fixed), _len - 1);
+
+        usize step = 1;
+        while (step * 2 <= _len)
+            step *= 2;
+
+        usize index = 0;
+        for (; step > 0; step /= 2) {
+            if (index + step <= _len and _tree[index + step] <= off) {
+                index += step;
+                off -= _tree[index];
+            }
+        }
+
+        return min(index, _len - 1);
+    }
+
+    isize total() const {
+        return fixed() ? _fixed * (isize)_len : _total;
+    }
+};
+
+struct VirtualList : public LeafNode<VirtualList> {
+    // Items built around the viewport, so they are already there
+    // when they scroll in.
+    static constexpr isize OVERSCAN = 256;
+
+    // Size given to the items that were not measured yet, until the
+    // first ones are.
+    static constexpr isize ESTIMATE = 32;
+
+    static constexpr usize POOL = 16;
+
+    struct _Item {
+        usize index;
+        Child node;
+    };
+
+    Layout::Orien _orien;
+    ListExtents _extents;
+    BuildItem _build;
+    bool _estimated = false;
+
+    Math::Recti _bound{};
+    Math::Recti _viewport{};
+    USizeRange _window{};
+    Vec<_Item> _items;
+    Vec<Child> _pool;
+
+    VirtualList(Layout::Orien orien, usize len, isize itemSize, BuildItem build)
+        : _orien(orien), _extents(len, itemSize), _build(std::move(build)) {}
+
+    ~VirtualList() {
+        for (auto &item : _items)
+            item.node->detach(this);
+    }
+
+    bool _vertical() const {
+        return _orien == Layout::Orien::VERTICAL;
+    }
+
+    isize _main(Math::Vec2i v) const {
+        return _vertical() ? v.y : v.x;
+    }
+
+    void _ensureExtents() {
+        if (not _extents.ready())
+            _extents.reset(ESTIMATE);
+    }
+
+    Math::Recti _itemBound(usize index) const {
+        auto off = _extents.offset(index);
+        auto size = _extents.size(index);
+
+        if (_vertical())
+            return {_bound.x, _bound.y + off, _bound.width, size};
+        return {_bound.x + off, _bound.y, size, _bound.height};
+    }
+
+    USizeRange _visible() const {
+        if (_extents.len() == 0)
+            return {};
+
+        isize start = _main(_viewport.xy - _bound.xy) - OVERSCAN;
+        isize end = start + _main(_viewport.wh) + OVERSCAN * 2;
+        return USizeRange::fromStartEnd(
+            _extents.indexAt(start),
+            _extents.indexAt(end) + 1
+        );
+    }
+
+    Child _buildAt(usize index) {
+        TraceScope trace{TraceKind::BUILD, *this};
+        return _build(index);
+    }
+
+    // Items that scrolled out are reused for the ones scrolling in when
+    // they are of the same kind, instead of keeping new nodes around.
+    Child _buildItem(usize index) {
+        auto node = _buildAt(index);
+        if (_pool.len() and match(last(_pool)->key(), node->key())) {
+            auto recycled = _pool.popBack();
+            if (not recycled->reconcile(node))
+                node = recycled;
+        }
+        node->attach(this);
+        return node;
+    }
+
+    void _recycle(Child node) {
+        node->detach(this);
+        if (_pool.len() < POOL)
+            _pool.pushBack(node);
+    }
+
+    // Keeps the items that are still in the window, recycles the others
+    // and builds the ones that came in.
+    void _sync(USizeRange window) {
+        Vec<_Item> items;
+        items.ensure(window.size);
+
+        usize j = 0;
+        for (usize i = window.start; i < window.end(); i++) {
+            while (j < _items.len() and _items[j].index < i)
+                _recycle(_items[j++].node);
+
+            if (j < _items.len() and _items[j].index == i)
+                items.pushBack(_items[j++]);
+            else
+                items.pushBack({i, _buildItem(i)});
+        }
+
+        while (j < _items.len())
+            _recycle(_items[j++].node);
+
+        _items = std::move(items);
+        _window = window;
+    }
+
+    // Measures the items that were built, they might push the ones
+    // after them out of the window, or pull new ones in.
+    void _measureItems() {
+        static constexpr usize PASSES = 8;
+
+        if (not _estimated and _items.len()) {
+            isize sum = 0;
+            for (auto &item : _items)
+                sum += _main(item.node->measure(_bound.size(), Layout::Hint::MIN));
+            _extents.reset(max(1, sum / (isize)_items.len()));
+            _estimated = true;
+        }
+
+        for (usize pass = 0; pass < PASSES; pass++) {
+            bool changed = false;
+            for (auto &item : _items) {
+                auto size = _main(item.node->measure(_bound.size(), Layout::Hint::MIN));
+                if (size != _extents.size(item.index)) {
+                    _extents.update(item.index, size);
+                    changed = true;
+                }
+            }
+
+            if (not changed)
+                return;
+
+            // The size of the list changed with them, so
+            // did the result of size().
+            _measured = 0;
+            _sync(_visible());
+        }
+    }
+
+    bool reconcile(VirtualList &o) override {
+        _build = std::move(o._build);
+
+        bool changed = false;
+        if (_extents.len() != o._extents.len() or _extents._fixed != o._extents._fixed) {
+            _extents = std::move(o._extents);
+            _estimated = false;
+            changed = true;
+        }
+
+        while (_items.len() and last(_items).index >= _extents.len())
+            _recycle(_items.popBack().node);
+
+        bool needsLayout = false;
+        for (auto &item : _items) {
+            if (auto fresh = item.node->reconcile(_buildAt(item.index))) {
+                item.node->detach(this);
+                item.node = *fresh;
+                item.node->attach(this);
+                changed = true;
+            }
+            needsLayout = needsLayout or item.node->_needsLayout;
+        }
+
+        _pool.clear();
+
+        // Items that changed in place repaint themselves.
+        if (needsLayout)
+            invalidateLayout();
+        return changed;
+    }
+
+    void paint(Gfx::Context &g, Math::Recti r) override {
+        for (auto &item : _items) {
+            if (not item.node->bound().colide(r))
+                continue;
+            item.node->paint(g, r);
+        }
+    }
+
+    void event(Async::Event &e) override {
+        if (auto *ve = e.is<ViewportEvent>()) {
+            _viewport = ve->bound;
+            _ensureExtents();
+
+            // Only lay the list out again when other items
+            // have to be shown.
+            auto window = _visible();
+            if (window.start != _window.start or window.size != _window.size)
+                shouldLayout(*this);
+            return;
+        }
+
+        for (auto &item : _items) {
+            item.node->event(e);
+            if (e.accepted())
+                return;
+        }
+    }
+
+    void layout(Math::Recti r) override {
+        _bound = r;
+        _ensureExtents();
+        _sync(_visible());
+
+        if (not _extents.fixed())
+            _measureItems();
+
+        for (auto &item : _items)
+            item.node->relayout(_itemBound(item.index));
+    }
+
+    Math::Vec2i size(Math::Vec2i s, Layout::Hint) override {
+        _ensureExtents();
+        if (_vertical())
+            return {s.x, _extents.total()};
+        return {_extents.total(), s.y};
+    }
+
+    Math::Recti bound() override {
+        if (_vertical())
+            return {_bound.x, _bound.y, _bound.width, _extents.total()};
+        return {_bound.x, _bound.y, _extents.total(), _bound.height};
+    }
+};
+
+Child hlist(usize len, BuildItem child) {
+    return hscroll(makeStrong<VirtualList>(Layout::Orien::HORIZONTAL, len, 0, std::move(child)));
+}
+
+Child hlist(usize len, isize itemSize, BuildItem child) {
+    return hscroll(makeStrong<VirtualList>(Layout::Orien::HORIZONTAL, len, itemSize, std::move(child)));
+}
+
+Child vlist(usize len, BuildItem child) {
+    return vscroll(makeStrong<VirtualList>(Layout::Orien::VERTICAL, len, 0, std::move(child)));
+}
+
+Child vlist(usize len, isize itemSize, BuildItem child) {
+    return vscroll(makeStrong<VirtualList>(Layout::Orien::VERTICAL, len, itemSize, std::move(child)));
+}
+
 } // namespace Karm::Ui
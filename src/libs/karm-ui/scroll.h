@@ -33,8 +33,15 @@ inline auto vscroll() {
 
 using BuildItem = Func<Child(usize)>;
 
+// Lists only build the items that are visible, items are measured as
+// they scroll in, or all have the same size when it is given.
+
 Child hlist(usize len, BuildItem child);
 
+Child hlist(usize len, isize itemSize, BuildItem child);
+
 Child vlist(usize len, BuildItem child);
 
+Child vlist(usize len, isize itemSize, BuildItem child);
+
 } // namespace Karm::Ui
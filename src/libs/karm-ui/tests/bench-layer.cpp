@@ -0,0 +1,50 @@
+#include <karm-test/macros.h>
+#include <karm-ui/layer.h>
+
+namespace Karm::Ui::Tests {
+
+static Math::Recti const VIEWPORT{0, 0, 800, 600};
+
+// Paints each row with its own color, like content would.
+static void _content(Gfx::Context &g, Math::Recti r) {
+    for (isize y = r.y; y < r.y + r.height; y++) {
+        g.fillStyle(Gfx::Color::fromRgb((u8)y, (u8)(255 - y), 128));
+        g.fill(Math::Recti{r.x, y, r.width, 1});
+    }
+}
+
+// Scrolling the viewport by painting it whole on every frame.
+bench$(layerScrollRepaint) {
+    auto dest = Media::Image::alloc(VIEWPORT.wh, Gfx::RGBA8888);
+    Gfx::Context g;
+    g.begin(dest.mutPixels());
+
+    b.bytes(VIEWPORT.width * VIEWPORT.height * 4);
+    b.run([&] {
+        _content(g, VIEWPORT);
+    });
+
+    g.end();
+}
+
+// Scrolling the viewport by 10px per frame, shifting the layer and
+// painting the new strip, then blitting it.
+bench$(layerScrollShift) {
+    auto dest = Media::Image::alloc(VIEWPORT.wh, Gfx::RGBA8888);
+    Gfx::Context g;
+    g.begin(dest.mutPixels());
+
+    Layer layer;
+    layer.update(VIEWPORT, Gfx::RGBA8888, _content);
+
+    b.bytes(VIEWPORT.width * VIEWPORT.height * 4);
+    b.run([&] {
+        layer.shift({0, -10});
+        layer.update(VIEWPORT, Gfx::RGBA8888, _content);
+        layer.paint(g);
+    });
+
+    g.end();
+}
+
+} // namespace Karm::Ui::Tests
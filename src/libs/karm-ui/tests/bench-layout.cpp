@@ -0,0 +1,112 @@
+#include <karm-test/macros.h>
+#include <karm-ui/layout.h>
+#include <karm-ui/reducer.h>
+
+namespace Karm::Ui::Tests {
+
+static constexpr isize ROWS = 120;
+static constexpr isize COLS = 20;
+
+static void _resizeCell(isize &width, isize action) {
+    width = action;
+}
+
+using BenchCell = Model<isize, isize, _resizeCell>;
+
+// 120 rows of 20 cells, each cell has its own state, about 5000
+// nodes total.
+static Child _grid(Vec<Child> &cells) {
+    Children rows;
+    for (isize y = 0; y < ROWS; y++) {
+        Children row;
+        for (isize x = 0; x < COLS; x++) {
+            auto cell = reducer<BenchCell>(10, [](isize const &w) {
+                return empty({w, 10});
+            });
+            cells.pushBack(cell);
+            row.pushBack(cell);
+        }
+        rows.pushBack(hflow(row));
+    }
+    return vflow(rows);
+}
+
+static Math::Recti const WINDOW{0, 0, COLS * 40, ROWS * 10};
+
+// Building the grid and laying all of it out, as on the first frame.
+bench$(layoutFirst) {
+    b.items(1);
+    b.run([] {
+        Vec<Child> cells;
+        auto root = _grid(cells);
+        root->relayout(WINDOW);
+        doNotOptimize(root->bound());
+    });
+}
+
+// Only the cell that changed and what it pushes around is laid out.
+bench$(layoutAction) {
+    Vec<Child> cells;
+    auto root = _grid(cells);
+    root->relayout(WINDOW);
+
+    usize i = 0;
+    b.items(1);
+    b.run([&] {
+        auto &cell = cells[(i * 7919) % cells.len()];
+        BenchCell::dispatch(*cell, 10 + (isize)(i % 3) * 10);
+        root->relayout(WINDOW);
+        i++;
+    });
+}
+
+struct BenchSetWidth {
+    usize index;
+    isize width;
+};
+
+static void _setWidth(Vec<isize> &widths, BenchSetWidth action) {
+    widths[action.index] = action.width;
+}
+
+using BenchSheet = Model<Vec<isize>, BenchSetWidth, _setWidth>;
+
+// Same grid, but all of its state lives in a single reducer at the
+// root, which rebuilds and reconciles the whole tree on each action.
+static Child _sheet(Vec<Node *> &cells) {
+    Vec<isize> widths;
+    widths.resize(ROWS * COLS, 10);
+
+    return reducer<BenchSheet>(widths, [&cells](Vec<isize> const &w) {
+        bool first = cells.len() == 0;
+        Children rows;
+        for (isize y = 0; y < ROWS; y++) {
+            Children row;
+            for (isize x = 0; x < COLS; x++) {
+                auto cell = empty({w[y * COLS + x], 10});
+                if (first)
+                    cells.pushBack(&cell.unwrap());
+                row.pushBack(cell);
+            }
+            rows.pushBack(hflow(row));
+        }
+        return vflow(rows);
+    });
+}
+
+bench$(layoutRootAction) {
+    Vec<Node *> cells;
+    auto root = _sheet(cells);
+    root->relayout(WINDOW);
+
+    usize i = 0;
+    b.items(1);
+    b.run([&] {
+        usize index = (i * 7919) % cells.len();
+        BenchSheet::dispatch(*cells[index], BenchSetWidth{index, 10 + (isize)(i % 3) * 10});
+        root->relayout(WINDOW);
+        i++;
+    });
+}
+
+} // namespace Karm::Ui::Tests
@@ -0,0 +1,80 @@
+#include <karm-test/macros.h>
+#include <karm-ui/host.h>
+#include <karm-ui/scroll.h>
+#include <karm-ui/view.h>
+
+namespace Karm::Ui::Tests {
+
+static constexpr usize ROWS = 1000000;
+
+struct BenchRow : public View<BenchRow> {
+    isize _size;
+
+    BenchRow(isize size)
+        : _size(size) {}
+
+    bool reconcile(BenchRow &o) override {
+        return reconcileProp(_size, o._size);
+    }
+
+    Math::Vec2i size(Math::Vec2i s, Layout::Hint) override {
+        return {s.x, _size};
+    }
+};
+
+// Scrolls ask for frames through their parent.
+struct BenchRoot : public Node {
+    Ticker _ticker;
+
+    void bubble(Async::Event &e) override {
+        if (auto *a = e.is<Node::AnimateEvent>()) {
+            _ticker.subscribe(*a->node);
+            e.accept();
+        }
+    }
+};
+
+// A million rows of different sizes.
+static Child _benchList() {
+    return vlist(ROWS, [](usize index) -> Child {
+        return makeStrong<BenchRow>(10 + (isize)(index % 3) * 10);
+    });
+}
+
+static Math::Recti const WINDOW{0, 0, 800, 600};
+
+bench$(listFirstLayout) {
+    b.items(1);
+    b.run([] {
+        BenchRoot root;
+        auto list = _benchList();
+        list->attach(&root);
+        list->relayout(WINDOW);
+        list->detach(&root);
+    });
+}
+
+// One notch and one frame per iteration, going down and back up
+// again every 64 frames.
+bench$(listScrollFrame) {
+    BenchRoot root;
+    auto list = _benchList();
+    list->attach(&root);
+    list->relayout(WINDOW);
+
+    usize frame = 0;
+    b.items(1);
+    b.run([&] {
+        Ui::event<Events::MouseEvent>(*list, Events::MouseEvent{
+            .type = Events::MouseEvent::SCROLL,
+            .pos = {10, 10},
+            .scroll = {0, (frame++ / 64) % 2 ? 1.0 : -1.0},
+        });
+        root._ticker.tick(FRAME_TIME);
+        list->relayout(WINDOW);
+    });
+
+    list->detach(&root);
+}
+
+} // namespace Karm::Ui::Tests
@@ -0,0 +1,94 @@
+#include <karm-test/macros.h>
+#include <karm-ui/funcs.h>
+#include <karm-ui/view.h>
+
+namespace Karm::Ui::Tests {
+
+static constexpr usize ITEMS = 10000;
+
+struct BenchItem : public View<BenchItem> {
+    usize _id;
+
+    BenchItem(usize id)
+        : _id(id) {}
+
+    bool reconcile(BenchItem &o) override {
+        return reconcileProp(_id, o._id);
+    }
+
+    Math::Vec2i size(Math::Vec2i, Layout::Hint) override {
+        return {100, 10};
+    }
+};
+
+struct BenchList : public GroupNode<BenchList> {
+    using GroupNode::GroupNode;
+};
+
+// Swallows the repaints of the list.
+struct BenchRoot : public Node {
+    void bubble(Async::Event &) override {}
+};
+
+static Child _benchList(Slice<usize> ids, bool keyed) {
+    Children children;
+    for (auto id : ids) {
+        Child item = makeStrong<BenchItem>(id);
+        children.pushBack(keyed ? item | key(id) : item);
+    }
+    return makeStrong<BenchList>(children);
+}
+
+// Reconciles a list of 10k items back and forth between two orders,
+// building the new list is part of each iteration.
+static void _benchReconcile(Bencher &b, bool keyed, Vec<usize> const &other) {
+    Vec<usize> ids;
+    for (usize i = 0; i < ITEMS; i++)
+        ids.pushBack(i);
+
+    BenchRoot root;
+    Child list = _benchList(ids, keyed);
+    list->attach(&root);
+
+    bool flip = false;
+    b.items(ITEMS);
+    b.run([&] {
+        flip = not flip;
+        (void)list->reconcile(_benchList(flip ? other : ids, keyed));
+    });
+
+    list->detach(&root);
+}
+
+static Vec<usize> _inserted() {
+    Vec<usize> ids;
+    ids.pushBack(ITEMS);
+    for (usize i = 0; i < ITEMS; i++)
+        ids.pushBack(i);
+    return ids;
+}
+
+static Vec<usize> _reversed() {
+    Vec<usize> ids;
+    for (usize i = ITEMS; i > 0; i--)
+        ids.pushBack(i - 1);
+    return ids;
+}
+
+bench$(reconcileInsertUnkeyed) {
+    _benchReconcile(b, false, _inserted());
+}
+
+bench$(reconcileInsertKeyed) {
+    _benchReconcile(b, true, _inserted());
+}
+
+bench$(reconcileReverseUnkeyed) {
+    _benchReconcile(b, false, _reversed());
+}
+
+bench$(reconcileReverseKeyed) {
+    _benchReconcile(b, true, _reversed());
+}
+
+} // namespace Karm::Ui::Tests
@@ -0,0 +1,46 @@
+#include <karm-test/macros.h>
+#include <karm-ui/layout.h>
+#include <karm-ui/reducer.h>
+#include <karm-ui/trace.h>
+
+namespace Karm::Ui::Tests {
+
+static void _benchNoop(usize &, usize) {}
+
+using BenchCounter = Model<usize, usize, _benchNoop>;
+
+// Builds and lays out about 5000 nodes from scratch.
+static void _layout() {
+    Children rows;
+    for (usize y = 0; y < 120; y++) {
+        Children row;
+        for (usize x = 0; x < 20; x++) {
+            row.pushBack(reducer<BenchCounter>(0uz, [](usize const &) {
+                return empty({10, 10});
+            }));
+        }
+        rows.pushBack(hflow(row));
+    }
+
+    auto root = vflow(rows);
+    root->relayout({0, 0, 800, 1200});
+}
+
+bench$(traceLayoutOff) {
+    b.items(1);
+    b.run(_layout);
+}
+
+bench$(traceLayoutOn) {
+    auto &tracer = Tracer::global();
+    tracer.clear();
+    debugTrace = true;
+
+    b.items(1);
+    b.run(_layout);
+
+    debugTrace = false;
+    tracer.clear();
+}
+
+} // namespace Karm::Ui::Tests
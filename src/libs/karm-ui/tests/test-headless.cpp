@@ -0,0 +1,87 @@
+#include <karm-test/macros.h>
+#include <karm-ui/anim.h>
+#include <karm-ui/headless.h>
+#include <karm-ui/view.h>
+
+namespace Karm::Ui::Tests {
+
+static usize _presses = 0;
+static Vec<f64> _dts;
+
+// Starts fading in when pressed, and remembers the time
+// steps it was ticked with.
+struct Fader : public View<Fader> {
+    Easedf _opacity{};
+
+    void event(Async::Event &e) override {
+        if (auto *m = e.is<Events::MouseEvent>()) {
+            if (m->type == Events::MouseEvent::PRESS) {
+                _presses++;
+                _opacity.animate(*this, 1.0, 0.25);
+            }
+        }
+    }
+
+    void tick(f64 dt) override {
+        _dts.pushBack(dt);
+        if (_opacity.tick(*this, dt))
+            shouldRepaint(*this);
+    }
+
+    void paint(Gfx::Context &g, Math::Recti) override {
+        g.fillStyle(Gfx::WHITE.withOpacity(_opacity.value()));
+        g.fill(bound());
+    }
+};
+
+static Script _script() {
+    Script s;
+    s.wait(2);
+    s.click({10, 10});
+    s.wait(30);
+    return s;
+}
+
+test$(headlessPlaysScript) {
+    auto script = _script();
+    usize frames = script.len();
+
+    _presses = 0;
+    _dts.clear();
+    HeadlessHost host{makeStrong<Fader>(), {64, 64}, std::move(script)};
+    try$(host.play());
+
+    // The first frame, then one per step of the script.
+    expectEq$(_presses, 1uz);
+    expectEq$(host._reports.len(), frames + 1);
+    expect$(_dts.len() > 0);
+
+    // Faded in by the end.
+    auto pixel = host.pixels().load({32, 32});
+    expectEq$(pixel.red, 255);
+
+    return Ok();
+}
+
+test$(headlessIsReproducible) {
+    _dts.clear();
+    HeadlessHost first{makeStrong<Fader>(), {64, 64}, _script()};
+    try$(first.play());
+    auto dts = _dts;
+
+    _dts.clear();
+    HeadlessHost second{makeStrong<Fader>(), {64, 64}, _script()};
+    try$(second.play());
+
+    // Time moves by whole frames, whatever the machine.
+    expectEq$(_dts.len(), dts.len());
+    for (usize i = 0; i < dts.len(); i++)
+        expectEq$(_dts[i], dts[i]);
+
+    for (usize i = 1; i < dts.len(); i++)
+        expect$(Math::epsilonEq(dts[i], FRAME_TIME, 0.0001));
+
+    return Ok();
+}
+
+} // namespace Karm::Ui::Tests
@@ -0,0 +1,137 @@
+#include <karm-test/macros.h>
+#include <karm-ui/anim.h>
+#include <karm-ui/host.h>
+#include <karm-ui/layer.h>
+#include <karm-ui/view.h>
+
+namespace Karm::Ui::Tests {
+
+static usize _painted = 0;
+static Math::Recti _lastDamage{};
+
+// Colors have no equality, their components do.
+static Math::Vec4u _rgba(Gfx::Color c) {
+    return c;
+}
+
+// Paints each row with its own color, so that they can be told apart.
+static void _stripes(Gfx::Context &g, Math::Recti r) {
+    _painted++;
+    _lastDamage = r;
+    for (isize y = r.y; y < r.y + r.height; y++) {
+        g.fillStyle(Gfx::Color::fromRgb((u8)y, (u8)(255 - y), 128));
+        g.fill(Math::Recti{r.x, y, r.width, 1});
+    }
+}
+
+test$(layerPaintsOnce) {
+    Layer layer;
+    Math::Recti bound{0, 0, 64, 64};
+
+    _painted = 0;
+    layer.update(bound, Gfx::RGBA8888, _stripes);
+    layer.update(bound, Gfx::RGBA8888, _stripes);
+    expectEq$(_painted, 1uz);
+
+    // Only what was damaged is painted again.
+    layer.invalidate({8, 8, 4, 4});
+    layer.update(bound, Gfx::RGBA8888, _stripes);
+    expectEq$(_painted, 2uz);
+    expectEq$(_lastDamage, Math::Recti(8, 8, 4, 4));
+
+    // Resizing paints it whole.
+    layer.update({0, 0, 64, 32}, Gfx::RGBA8888, _stripes);
+    expectEq$(_painted, 3uz);
+    expectEq$(_lastDamage, Math::Recti(0, 0, 64, 32));
+
+    return Ok();
+}
+
+test$(layerShift) {
+    Layer layer;
+    Math::Recti bound{0, 0, 64, 64};
+    layer.update(bound, Gfx::RGBA8888, _stripes);
+
+    auto before = layer._image->pixels().load({5, 10});
+
+    // Scrolling down moves the content up, the bottom
+    // strip is the only one left to paint.
+    layer.shift({0, -10});
+    expectEq$(_rgba(layer._image->pixels().load({5, 0})), _rgba(before));
+
+    layer.update(bound, Gfx::RGBA8888, _stripes);
+    expectEq$(_lastDamage, Math::Recti(0, 54, 64, 10));
+    expectEq$(_rgba(layer._image->pixels().load({5, 60})), _rgba(Gfx::Color::fromRgb(60, 195, 128)));
+
+    return Ok();
+}
+
+test$(layerBlit) {
+    Layer layer;
+    layer.update({0, 0, 16, 16}, Gfx::RGBA8888, _stripes);
+
+    auto dest = Media::Image::alloc({32, 32}, Gfx::RGBA8888);
+    Gfx::Context g;
+    g.begin(dest.mutPixels());
+    layer.paint(g, {8, 4});
+    g.end();
+
+    expectEq$(_rgba(dest.pixels().load({8, 4})), _rgba(Gfx::Color::fromRgb(0, 255, 128)));
+    expectEq$(_rgba(dest.pixels().load({10, 9})), _rgba(Gfx::Color::fromRgb(5, 250, 128)));
+    expectEq$(_rgba(dest.pixels().load({0, 0})), _rgba(Gfx::ALPHA));
+
+    return Ok();
+}
+
+// Counts how many times it gets painted.
+struct Painted : public View<Painted> {
+    void paint(Gfx::Context &g, Math::Recti) override {
+        _painted++;
+        g.fillStyle(Gfx::WHITE);
+        g.fill(bound());
+    }
+};
+
+// Ticks the nodes that ask for frames.
+struct Frames : public Node {
+    Ticker _ticker;
+
+    void bubble(Async::Event &e) override {
+        if (auto *a = e.is<Node::AnimateEvent>()) {
+            _ticker.subscribe(*a->node);
+            e.accept();
+        }
+    }
+};
+
+test$(slideInPaintsChildOnce) {
+    Frames root;
+    Math::Recti bound{0, 0, 64, 64};
+    auto slide = slideIn(SlideFrom::START, makeStrong<Painted>());
+    slide->attach(&root);
+    slide->relayout(bound);
+
+    auto dest = Media::Image::alloc(bound.wh, Gfx::RGBA8888);
+    Gfx::Context g;
+    g.begin(dest.mutPixels());
+
+    // The slide lasts a quarter of a second, the child is painted
+    // into the layer once and then only moved around.
+    _painted = 0;
+    usize frames = 0;
+    for (f64 t = 0; t < 0.2; t += FRAME_TIME) {
+        root._ticker.tick(FRAME_TIME);
+        slide->paint(g, bound);
+        frames++;
+    }
+
+    g.end();
+    slide->detach(&root);
+
+    expect$(frames > 1);
+    expectEq$(_painted, 1uz);
+
+    return Ok();
+}
+
+} // namespace Karm::Ui::Tests
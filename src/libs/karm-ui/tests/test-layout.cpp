@@ -0,0 +1,199 @@
+#include <karm-test/macros.h>
+#include <karm-ui/layout.h>
+#include <karm-ui/reducer.h>
+#include <karm-ui/view.h>
+
+namespace Karm::Ui::Tests {
+
+static usize _layouts = 0;
+static usize _sizes = 0;
+
+// A leaf that counts how many times it gets measured and laid out.
+struct Probe : public View<Probe> {
+    Math::Vec2i _size;
+
+    Probe(Math::Vec2i size)
+        : _size(size) {}
+
+    bool reconcile(Probe &o) override {
+        return reconcileProp(_size, o._size);
+    }
+
+    void layout(Math::Recti r) override {
+        _layouts++;
+        View<Probe>::layout(r);
+    }
+
+    Math::Vec2i size(Math::Vec2i, Layout::Hint) override {
+        _sizes++;
+        return _size;
+    }
+};
+
+static Child _probe(Math::Vec2i size) {
+    return makeStrong<Probe>(size);
+}
+
+static void _resize(isize &width, isize action) {
+    width = action;
+}
+
+using Cell = Model<isize, isize, _resize>;
+
+// A cell whose width follows its state.
+static Child _cell(isize width) {
+    return reducer<Cell>(width, [](isize const &w) {
+        return _probe({w, 10});
+    });
+}
+
+test$(layoutMeasureCache) {
+    auto probe = _probe({10, 20});
+
+    _sizes = 0;
+    expectEq$(probe->measure({100, 100}, Layout::Hint::MIN), Math::Vec2i(10, 20));
+    expectEq$(probe->measure({100, 100}, Layout::Hint::MIN), Math::Vec2i(10, 20));
+    expectEq$(_sizes, 1uz);
+
+    probe->measure({100, 100}, Layout::Hint::MAX);
+    probe->measure({50, 100}, Layout::Hint::MIN);
+    expectEq$(_sizes, 3uz);
+
+    shouldLayout(*probe);
+    probe->measure({100, 100}, Layout::Hint::MIN);
+    expectEq$(_sizes, 4uz);
+
+    return Ok();
+}
+
+test$(layoutOnlyDirtyNodes) {
+    auto a = _cell(10);
+    auto b = _cell(10);
+    auto root = hflow(a, b);
+
+    root->relayout({0, 0, 100, 10});
+    expectEq$(b->bound().x, 10);
+
+    // Nothing changed, nothing to do.
+    _layouts = 0;
+    root->relayout({0, 0, 100, 10});
+    expectEq$(_layouts, 0uz);
+
+    // Rebuilt the same, nothing changed either.
+    Cell::dispatch(*a, 10);
+    root->relayout({0, 0, 100, 10});
+    expectEq$(_layouts, 0uz);
+
+    // Growing pushes its sibling, which has to move.
+    _layouts = 0;
+    Cell::dispatch(*a, 30);
+    root->relayout({0, 0, 100, 10});
+    expectEq$(_layouts, 2uz);
+    expectEq$(b->bound().x, 30);
+
+    return Ok();
+}
+
+// Dispatching an action to a cell of a grid only lays out that
+// cell and what it pushes around, instead of the whole tree.
+test$(layoutGridActions) {
+    static constexpr isize ROWS = 12;
+    static constexpr isize COLS = 20;
+    static constexpr usize ACTIONS = 100;
+
+    Vec<Child> cells;
+    Children rows;
+    for (isize y = 0; y < ROWS; y++) {
+        Children row;
+        for (isize x = 0; x < COLS; x++) {
+            auto cell = _cell(10);
+            cells.pushBack(cell);
+            row.pushBack(cell);
+        }
+        rows.pushBack(hflow(row));
+    }
+    auto root = vflow(rows);
+    Math::Recti window{0, 0, COLS * 40, ROWS * 10};
+    root->relayout(window);
+
+    _layouts = _sizes = 0;
+    for (usize i = 0; i < ACTIONS; i++) {
+        auto &cell = cells[(i * 7919) % cells.len()];
+        Cell::dispatch(*cell, 10 + (isize)(i % 3) * 10);
+        root->relayout(window);
+    }
+
+    expect$(_layouts < ACTIONS * COLS);
+    expect$(_sizes < ACTIONS * COLS * 2);
+
+    return Ok();
+}
+
+struct SetWidth {
+    usize index;
+    isize width;
+};
+
+static void _setWidth(Vec<isize> &widths, SetWidth action) {
+    widths[action.index] = action.width;
+}
+
+using Sheet = Model<Vec<isize>, SetWidth, _setWidth>;
+
+// Collects what the tree asks to be repainted.
+struct Window : public Node {
+    Math::Recti _dirty{};
+
+    void bubble(Async::Event &e) override {
+        if (auto *p = e.is<Node::PaintEvent>()) {
+            _dirty = _dirty.empty() ? p->bound : _dirty.mergeWith(p->bound);
+            e.accept();
+        }
+    }
+};
+
+// The whole grid is rebuilt by a single reducer on each action, only
+// the cell that changed is laid out and repainted again.
+test$(layoutRootReducerActions) {
+    static constexpr isize ROWS = 12;
+    static constexpr isize COLS = 20;
+
+    Vec<isize> widths;
+    widths.resize(ROWS * COLS, 10);
+
+    Vec<Node *> cells;
+    auto root = reducer<Sheet>(widths, [&](Vec<isize> const &w) {
+        cells.clear();
+        Children rows;
+        for (isize y = 0; y < ROWS; y++) {
+            Children row;
+            for (isize x = 0; x < COLS; x++) {
+                auto cell = _probe({w[y * COLS + x], 10});
+                cells.pushBack(&cell.unwrap());
+                row.pushBack(cell);
+            }
+            rows.pushBack(hflow(row));
+        }
+        return vflow(rows);
+    });
+
+    Window window;
+    root->attach(&window);
+    root->relayout({0, 0, COLS * 40, ROWS * 10});
+
+    // Later builds are reconciled into the nodes of the first one.
+    auto kept = cells;
+
+    _layouts = 0;
+    window._dirty = {};
+    Sheet::dispatch(*kept[3 * COLS + COLS - 1], SetWidth{3 * COLS + COLS - 1, 20});
+    root->relayout({0, 0, COLS * 40, ROWS * 10});
+
+    expectEq$(_layouts, 1uz);
+    expectEq$(window._dirty, Math::Recti(190, 30, 20, 10));
+
+    root->detach(&window);
+    return Ok();
+}
+
+} // namespace Karm::Ui::Tests
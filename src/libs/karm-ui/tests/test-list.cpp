@@ -0,0 +1,157 @@
+#include <karm-test/macros.h>
+#include <karm-ui/host.h>
+#include <karm-ui/scroll.h>
+#include <karm-ui/view.h>
+
+namespace Karm::Ui::Tests {
+
+static usize _built = 0;
+static Vec<Cons<usize, Math::Recti>> _rows;
+
+// A row that reports where it gets laid out.
+struct Row : public View<Row> {
+    usize _index;
+    isize _size;
+
+    Row(usize index, isize size)
+        : _index(index), _size(size) {}
+
+    bool reconcile(Row &o) override {
+        bool changed = reconcileProp(_index, o._index);
+        changed |= reconcileProp(_size, o._size);
+        return changed;
+    }
+
+    void layout(Math::Recti r) override {
+        _rows.pushBack({_index, r});
+        View<Row>::layout(r);
+    }
+
+    Math::Vec2i size(Math::Vec2i s, Layout::Hint) override {
+        return {s.x, _size};
+    }
+};
+
+// Scrolls repaint and ask for frames through their parent.
+struct Root : public Node {
+    Ticker _ticker;
+
+    void bubble(Async::Event &e) override {
+        if (auto *a = e.is<Node::AnimateEvent>()) {
+            _ticker.subscribe(*a->node);
+            e.accept();
+        }
+    }
+};
+
+static isize _rowSize(usize index) {
+    return 10 + (isize)(index % 3) * 10;
+}
+
+static Child _fixedList(usize len) {
+    return vlist(len, 20, [](usize index) -> Child {
+        _built++;
+        return makeStrong<Row>(index, 20);
+    });
+}
+
+static Child _variableList(usize len) {
+    return vlist(len, [](usize index) -> Child {
+        _built++;
+        return makeStrong<Row>(index, _rowSize(index));
+    });
+}
+
+static void _scroll(Child &list, f64 notches) {
+    Ui::event<Events::MouseEvent>(*list, Events::MouseEvent{
+        .type = Events::MouseEvent::SCROLL,
+        .pos = {10, 10},
+        .scroll = {0, notches},
+    });
+}
+
+static void _frame(Root &root, Child &list, Math::Recti window) {
+    root._ticker.tick(FRAME_TIME);
+    list->relayout(window);
+}
+
+test$(listBuildsVisibleItems) {
+    Root root;
+    Math::Recti window{0, 0, 200, 400};
+    auto list = _fixedList(1000000);
+    list->attach(&root);
+
+    _built = 0;
+    _rows.clear();
+    list->relayout(window);
+
+    expect$(_built > 400 / 20);
+    expect$(_built < 1000 / 20);
+    for (auto &[index, bound] : _rows)
+        expectEq$(bound.y, (isize)index * 20);
+
+    // Scrolling down builds the rows coming in, and only them.
+    _rows.clear();
+    _scroll(list, -10);
+    for (usize i = 0; i < 60; i++)
+        _frame(root, list, window);
+
+    bool scrolled = false;
+    for (auto &[index, bound] : _rows)
+        scrolled = scrolled or index >= 1280 / 20;
+    expect$(scrolled);
+    expect$(_built < 200);
+
+    list->detach(&root);
+    return Ok();
+}
+
+test$(listMeasuresItems) {
+    Root root;
+    Math::Recti window{0, 0, 200, 400};
+    auto list = _variableList(1000);
+    list->attach(&root);
+
+    _rows.clear();
+    list->relayout(window);
+    expect$(_rows.len() > 0);
+
+    // Each row ends up after the ones before it, once measured.
+    for (auto &[index, bound] : _rows) {
+        isize y = 0;
+        for (usize i = 0; i < index; i++)
+            y += _rowSize(i);
+        expectEq$(bound.y, y);
+        expectEq$(bound.height, _rowSize(index));
+    }
+
+    list->detach(&root);
+    return Ok();
+}
+
+// Scrolling down a list of a million rows of different sizes, one
+// notch per frame, only builds the rows coming in.
+test$(listScrollsVariable) {
+    static constexpr usize FRAMES = 60;
+
+    Root root;
+    Math::Recti window{0, 0, 800, 600};
+    auto list = _variableList(1000000);
+    list->attach(&root);
+    list->relayout(window);
+
+    _built = 0;
+    for (usize i = 0; i < FRAMES; i++) {
+        _rows.clear();
+        _scroll(list, -1);
+        _frame(root, list, window);
+    }
+
+    expect$(_built > 0);
+    expect$(_built < FRAMES * 128 / 10);
+
+    list->detach(&root);
+    return Ok();
+}
+
+} // namespace Karm::Ui::Tests
@@ -0,0 +1,165 @@
+#include <karm-test/macros.h>
+#include <karm-ui/funcs.h>
+#include <karm-ui/view.h>
+
+namespace Karm::Ui::Tests {
+
+static usize _mismatched = 0;
+
+// A leaf that remembers which item it was built for, reconciling it
+// with another item means its state would be carried over to it.
+struct Item : public View<Item> {
+    usize _id;
+
+    Item(usize id)
+        : _id(id) {}
+
+    bool reconcile(Item &o) override {
+        if (o._id != _id)
+            _mismatched++;
+        return reconcileProp(_id, o._id);
+    }
+
+    Math::Vec2i size(Math::Vec2i, Layout::Hint) override {
+        return {100, 10};
+    }
+};
+
+struct List : public GroupNode<List> {
+    using GroupNode::GroupNode;
+};
+
+// Counts the repaints requested by its child.
+struct Root : public Node {
+    usize _repaints = 0;
+
+    void bubble(Async::Event &e) override {
+        if (e.is<Node::PaintEvent>())
+            _repaints++;
+    }
+};
+
+static Children _items(Slice<usize> ids, bool keyed) {
+    Children children;
+    for (auto id : ids) {
+        Child item = makeStrong<Item>(id);
+        children.pushBack(keyed ? item | key(id) : item);
+    }
+    return children;
+}
+
+static Vec<usize> _range(usize len) {
+    Vec<usize> ids;
+    for (usize i = 0; i < len; i++)
+        ids.pushBack(i);
+    return ids;
+}
+
+static List &_list(Child &list) {
+    return list.unwrap<List>();
+}
+
+test$(reconcileKeyedReuse) {
+    Root root;
+    auto ids = _range(4);
+    Child list = makeStrong<List>(_items(ids, true));
+    list->attach(&root);
+
+    Node *first = &_list(list).children()[0].unwrap();
+    Node *last = &_list(list).children()[3].unwrap();
+
+    // Inserting at the top keeps the existing items.
+    _mismatched = 0;
+    Vec<usize> inserted = {9, 0, 1, 2, 3};
+    expect$(not list->reconcile(makeStrong<List>(_items(inserted, true))));
+    expectEq$(_list(list).children().len(), 5uz);
+    expect$(&_list(list).children()[1].unwrap() == first);
+    expect$(&_list(list).children()[4].unwrap() == last);
+    expectEq$(_mismatched, 0uz);
+
+    // Removing one only repaints where it was.
+    root._repaints = 0;
+    Vec<usize> removed = {9, 0, 2, 3};
+    expect$(not list->reconcile(makeStrong<List>(_items(removed, true))));
+    expectEq$(_list(list).children().len(), 4uz);
+    expectEq$(root._repaints, 1uz);
+
+    // Swapping two items only moves one of them.
+    root._repaints = 0;
+    Vec<usize> swapped = {9, 2, 0, 3};
+    expect$(not list->reconcile(makeStrong<List>(_items(swapped, true))));
+    expect$(&_list(list).children()[2].unwrap() == first);
+    expectEq$(root._repaints, 1uz);
+    expectEq$(_mismatched, 0uz);
+
+    list->detach(&root);
+    return Ok();
+}
+
+test$(reconcileUnkeyed) {
+    Root root;
+    Vec<usize> ids = {0, 1, 2, 3};
+    Child list = makeStrong<List>(_items(ids, false));
+    list->attach(&root);
+
+    Node *first = &_list(list).children()[0].unwrap();
+
+    // Without keys, items are matched by position.
+    _mismatched = 0;
+    root._repaints = 0;
+    Vec<usize> shorter = {1, 2};
+    expect$(not list->reconcile(makeStrong<List>(_items(shorter, false))));
+    expectEq$(_list(list).children().len(), 2uz);
+    expect$(&_list(list).children()[0].unwrap() == first);
+    expectEq$(_mismatched, 2uz);
+    expectEq$(root._repaints, 2uz);
+
+    list->detach(&root);
+    return Ok();
+}
+
+// Insert at the top, remove from the middle and reverse a list,
+// with and without keys.
+test$(reconcileEdits) {
+    static constexpr usize ITEMS = 100;
+
+    for (bool keyed : {false, true}) {
+        Root root;
+        auto ids = _range(ITEMS);
+        Child list = makeStrong<List>(_items(ids, keyed));
+        list->attach(&root);
+
+        auto edit = [&](Vec<usize> const &next) {
+            _mismatched = 0;
+            (void)list->reconcile(makeStrong<List>(_items(next, keyed)));
+            return _mismatched;
+        };
+
+        auto inserted = _range(ITEMS);
+        inserted.insert(0, ITEMS);
+        auto insertMismatched = edit(inserted);
+
+        auto removed = inserted;
+        removed.removeAt(ITEMS / 2);
+        auto removeMismatched = edit(removed);
+
+        Vec<usize> reversed;
+        for (usize i = removed.len(); i > 0; i--)
+            reversed.pushBack(removed[i - 1]);
+        auto reverseMismatched = edit(reversed);
+
+        if (keyed) {
+            expectEq$(insertMismatched, 0uz);
+            expectEq$(removeMismatched, 0uz);
+            expectEq$(reverseMismatched, 0uz);
+        } else {
+            expectEq$(insertMismatched, ITEMS);
+        }
+
+        list->detach(&root);
+    }
+
+    return Ok();
+}
+
+} // namespace Karm::Ui::Tests
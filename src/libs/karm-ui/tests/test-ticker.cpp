@@ -0,0 +1,103 @@
+#include <karm-test/macros.h>
+#include <karm-ui/anim.h>
+#include <karm-ui/host.h>
+
+namespace Karm::Ui::Tests {
+
+// A leaf that counts how many times it got ticked.
+struct Spinner : public LeafNode<Spinner> {
+    Easedf _angle{};
+    usize _ticks = 0;
+
+    void start() {
+        _angle.animate(*this, 1.0, 0.105);
+    }
+
+    void tick(f64 dt) override {
+        _ticks++;
+        _angle.tick(*this, dt);
+    }
+};
+
+// Stands in for the host.
+struct Clock : public Node {
+    Ticker _ticker;
+
+    void bubble(Async::Event &e) override {
+        if (auto *a = e.is<Node::AnimateEvent>()) {
+            _ticker.subscribe(*a->node);
+            e.accept();
+        }
+    }
+};
+
+test$(tickerOnlyTicksAnimating) {
+    Clock clock;
+    Vec<Strong<Spinner>> spinners;
+    for (usize i = 0; i < 1000; i++) {
+        auto spinner = makeStrong<Spinner>();
+        spinner->attach(&clock);
+        spinners.pushBack(spinner);
+    }
+
+    spinners[42]->start();
+
+    usize frames = 0;
+    usize ticked = 0;
+    while (clock._ticker.any()) {
+        ticked += clock._ticker.tick(FRAME_TIME);
+        frames++;
+    }
+
+    // Ticked until the animation is done, and once more to notice it.
+    expectEq$(frames, 8uz);
+    expectEq$(ticked, 8uz);
+    expectEq$(spinners[42]->_ticks, 8uz);
+    expectEq$(spinners[41]->_ticks, 0uz);
+    expect$(spinners[42]->_angle.reached());
+
+    for (auto &s : spinners)
+        s->detach(&clock);
+
+    return Ok();
+}
+
+test$(tickerForgetsDestroyedNodes) {
+    Clock clock;
+    {
+        auto spinner = makeStrong<Spinner>();
+        spinner->attach(&clock);
+        spinner->start();
+        expect$(clock._ticker.any());
+        spinner->detach(&clock);
+    }
+
+    expect$(not clock._ticker.any());
+    expectEq$(clock._ticker.tick(FRAME_TIME), 0uz);
+
+    return Ok();
+}
+
+test$(tickerKeepsOrphans) {
+    {
+        auto spinner = makeStrong<Spinner>();
+        spinner->start();
+
+        // Nobody to tick it yet, it waits for a host to pick it up.
+        expect$(Ticker::orphans().any());
+
+        Clock clock;
+        spinner->attach(&clock);
+        clock._ticker.subscribe(*spinner);
+        expect$(not Ticker::orphans().any());
+        expectEq$(clock._ticker.tick(FRAME_TIME), 1uz);
+
+        spinner->detach(&clock);
+    }
+
+    expect$(not Ticker::orphans().any());
+
+    return Ok();
+}
+
+} // namespace Karm::Ui::Tests
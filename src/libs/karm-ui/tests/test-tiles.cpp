@@ -0,0 +1,120 @@
+#include <karm-test/macros.h>
+#include <karm-ui/box.h>
+#include <karm-ui/host.h>
+#include <karm-ui/view.h>
+
+namespace Karm::Ui::Tests {
+
+static Math::Vec2i const SIZE = {640, 480};
+
+// Paints into an image, as a window would on screen.
+struct ImageHost : public Host {
+    Media::Image _image;
+
+    ImageHost(Child root, bool tiled)
+        : Host(root), _image(Media::Image::alloc(SIZE, Gfx::RGBA8888)) {
+        // NOTE: Tiles are rasterized by workers even on a single core.
+        _tiled = tiled;
+        if (tiled)
+            _raster = TileRaster::create(2).unwrap();
+    }
+
+    Gfx::MutPixels mutPixels() override {
+        return _image.mutPixels();
+    }
+
+    void flip(Slice<Math::Recti>) override {}
+
+    void pump() override {}
+
+    void wait(TimeSpan) override {}
+
+    void repaintAll() {
+        _dirty.pushBack(bound());
+        doPaint();
+    }
+};
+
+static Child _shapes() {
+    Children cells;
+    for (isize i = 0; i < 48; i++) {
+        auto color = Gfx::Color::fromRgb((u8)(i * 5), (u8)(255 - i * 5), (u8)(i * 37));
+        cells.pushBack(
+            box(
+                {
+                    .margin = (i % 5) + 1,
+                    .borderRadius = (f64)(i % 7) * 3,
+                    .borderWidth = (f64)(i % 3),
+                    .borderPaint = Gfx::WHITE,
+                    .backgroundPaint = color,
+                },
+                empty({(i % 4) * 17 + 20, (i % 3) * 11 + 20})
+            )
+        );
+    }
+
+    cells.pushBack(canvas([](Gfx::Context &g, Math::Vec2i size) {
+        g.begin();
+        g.ellipse({size.cast<f64>() / 2, size.cast<f64>() / 2});
+        g.fill(Gfx::Color::fromRgba(255, 128, 0, 160));
+    }));
+
+    return flow({.flow = Layout::Flow::LEFT_TO_RIGHT, .gaps = 3}, cells);
+}
+
+// Rasterizing a recording tile by tile gives the same pixels as
+// painting the tree directly, including on the edges of the tiles.
+test$(tilesMatchDirect) {
+    ImageHost tiled{_shapes(), true};
+    ImageHost direct{_shapes(), false};
+
+    for (auto *h : {&tiled, &direct}) {
+        h->doLayout();
+        h->doPaint();
+        h->repaintAll();
+    }
+
+    expect$(tiled._tiled);
+
+    auto a = tiled._image.pixels();
+    auto b = direct._image.pixels();
+    usize differ = 0;
+    for (isize y = 0; y < SIZE.y; y++)
+        for (isize x = 0; x < SIZE.x; x++)
+            differ += a.load({x, y}) != b.load({x, y});
+    expectEq$(differ, 0uz);
+
+    return Ok();
+}
+
+static usize _painted = 0;
+
+// Blurs what's under it, which can't be split across tiles.
+static Child _blurred() {
+    return canvas([](Gfx::Context &g, Math::Vec2i size) {
+        _painted++;
+        g.fillStyle(Gfx::RED);
+        g.fill(Math::Recti{{}, size});
+        g.apply(Gfx::BlurFilter{4}, {{}, size});
+    });
+}
+
+// A tree that can't be replayed is only recorded for nothing once,
+// the frames after it are painted directly.
+test$(tilesRememberNotReplayable) {
+    ImageHost host{_blurred(), true};
+    host.doLayout();
+
+    _painted = 0;
+    host.doPaint();
+    expect$(_painted <= 2uz);
+
+    _painted = 0;
+    host.repaintAll();
+    host.repaintAll();
+    expectEq$(_painted, 2uz);
+
+    return Ok();
+}
+
+} // namespace Karm::Ui::Tests
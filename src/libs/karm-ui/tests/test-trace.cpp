@@ -0,0 +1,115 @@
+#include <karm-test/macros.h>
+#include <karm-ui/layout.h>
+#include <karm-ui/reducer.h>
+#include <karm-ui/view.h>
+
+namespace Karm::Ui::Tests {
+
+struct Dot : public View<Dot> {
+    Math::Vec2i size(Math::Vec2i, Layout::Hint) override {
+        return {10, 10};
+    }
+};
+
+static void _noop(usize &, usize) {}
+
+using Counter = Model<usize, usize, _noop>;
+
+static Child _counter() {
+    return reducer<Counter>(0uz, [](usize const &) -> Child {
+        return makeStrong<Dot>();
+    });
+}
+
+static bool _contains(Str hay, Str needle) {
+    for (usize i = 0; i + needle.len() <= hay.len(); i++)
+        if (sub(hay, i, i + needle.len()) == needle)
+            return true;
+    return false;
+}
+
+test$(traceRecordsNestedSpans) {
+    auto &tracer = Tracer::global();
+    tracer.clear();
+
+    auto root = hflow(_counter(), _counter());
+
+    debugTrace = true;
+    root->relayout({0, 0, 100, 10});
+    debugTrace = false;
+
+    expect$(tracer.len() > 0);
+    expect$(tracer[0].kind == TraceKind::LAYOUT);
+    expectEq$(tracer[0].depth, 0);
+
+    usize builds = 0;
+    bool named = false;
+    for (usize i = 0; i < tracer.len(); i++) {
+        auto &span = tracer[i];
+        expect$(span.done);
+        if (span.kind == TraceKind::BUILD) {
+            builds++;
+            expectEq$(span.allocs, 1uz);
+            expect$(span.depth > 0);
+        }
+        named = named or _contains(span.name, "Dot");
+    }
+    expectEq$(builds, 2uz);
+    expect$(named);
+
+    return Ok();
+}
+
+test$(traceOffRecordsNothing) {
+    auto &tracer = Tracer::global();
+    tracer.clear();
+
+    auto root = hflow(_counter(), _counter());
+    root->relayout({0, 0, 100, 10});
+
+    expectEq$(tracer.len(), 0uz);
+
+    return Ok();
+}
+
+test$(traceRingKeepsRecent) {
+    Tracer tracer;
+
+    // The outer span gets overwritten by the ones nested in it.
+    auto outer = tracer.begin(TraceKind::FRAME, "outer");
+    for (usize i = 0; i < Tracer::CAPACITY + 10; i++)
+        tracer.end(tracer.begin(TraceKind::PAINT, "inner"));
+    tracer.end(outer);
+
+    expectEq$(tracer.len(), Tracer::CAPACITY);
+    expectEq$(tracer._depth, 0);
+    for (usize i = 0; i < tracer.len(); i++) {
+        expect$(tracer[i].kind == TraceKind::PAINT);
+        expect$(tracer[i].done);
+    }
+
+    return Ok();
+}
+
+test$(traceExportChrome) {
+    Tracer tracer;
+    auto frame = tracer.begin(TraceKind::FRAME, "");
+    tracer.end(tracer.begin(TraceKind::PAINT, "Some\"Node"));
+    tracer.end(frame);
+
+    // Still running, left out.
+    tracer.begin(TraceKind::BLIT, "");
+
+    Io::StringWriter writer;
+    try$(tracer.exportChrome(writer));
+    auto json = writer.take();
+
+    expect$(_contains(json, "{\"traceEvents\":["));
+    expect$(_contains(json, "\"name\":\"frame\",\"cat\":\"frame\",\"ph\":\"X\""));
+    expect$(_contains(json, "\"name\":\"Some\\\"Node\",\"cat\":\"paint\""));
+    expect$(not _contains(json, "blit"));
+
+    return Ok();
+}
+
+} // namespace Karm::Ui::Tests
@@ -0,0 +1,154 @@
+#include "tiles.h"
+
+namespace Karm::Ui {
+
+Res<Strong<TileRaster>> TileRaster::create(usize workers) {
+    auto raster = makeStrong<TileRaster>(
+        try$(Sys::Mutex::create()),
+        try$(Sys::CondVar::create())
+    );
+
+    for (usize i = 0; i < workers; i++) {
+        auto *self = &raster.unwrap();
+        raster->_threads.pushBack(try$(Sys::Thread::spawn([self] {
+            self->_work();
+        })));
+    }
+
+    return Ok(raster);
+}
+
+TileRaster::~TileRaster() {
+    {
+        Sys::MutexScope scope(*_mutex);
+        _stop = true;
+        _cond->broadcast();
+    }
+
+    for (auto &t : _threads)
+        (void)t->join();
+}
+
+static u64 _pack(usize frame, usize i) {
+    return (u64)(u32)frame << 32 | (u32)i;
+}
+
+void TileRaster::render(Gfx::DisplayList const &list, Gfx::MutPixels pixels, Slice<Math::Recti> tiles) {
+    // NOTE: Workers that woke up too late for the previous frame can't
+    //       claim anything from it, but let them leave before starting.
+    while (_active.load() > 0)
+        ::Karm::_Embed::relaxe();
+
+    usize frame;
+    {
+        Sys::MutexScope scope(*_mutex);
+        frame = ++_frame;
+        _list = &list;
+        _pixels = pixels;
+        _tiles = tiles;
+        _next.store(_pack(frame, 0));
+        _done.store(0);
+        _active.inc();
+        _cond->broadcast();
+    }
+
+    _drain(_g, {frame, &list, pixels, tiles});
+
+    // NOTE: The caller reuses the buffer and the tiles once this returns,
+    //       wait for the workers still drawing into them.
+    while (_done.load() < tiles.len() or _active.load() > 0)
+        ::Karm::_Embed::relaxe();
+}
+
+bool TileRaster::_claim(_Job const &job, usize &i) {
+    while (true) {
+        u64 next = _next.load();
+        if (next >> 32 != (u32)job.frame)
+            return false;
+
+        i = next & 0xffffffff;
+        if (i >= job.tiles.len())
+            return false;
+
+        if (_next.cmpxchg(next, next + 1))
+            return true;
+    }
+}
+
+void TileRaster::_drain(Gfx::Context &g, _Job const &job) {
+    usize i;
+    if (_claim(job, i)) {
+        g.begin(job.pixels);
+        do {
+            job.list->replay(g, job.tiles[i]);
+            _done.inc();
+        } while (_claim(job, i));
+        g.end();
+    }
+
+    _active.dec();
+}
+
+void TileRaster::_work() {
+    Gfx::Context g;
+    usize seen = 0;
+
+    while (true) {
+        Opt<_Job> job = NONE;
+        {
+            Sys::MutexScope scope(*_mutex);
+            while (_frame == seen and not _stop)
+                _cond->wait(*_mutex);
+
+            if (_stop)
+                return;
+
+            seen = _frame;
+            _active.inc();
+            job = _Job{_frame, _list, *_pixels, _tiles};
+        }
+
+        _drain(g, *job);
+    }
+}
+
+Math::Recti collectTiles(Math::Recti bound, Slice<Math::Recti> regions, Vec<Math::Recti> &tiles) {
+    isize cols = (bound.width + TILE_SIZE - 1) / TILE_SIZE;
+    isize rows = (bound.height + TILE_SIZE - 1) / TILE_SIZE;
+
+    Vec<bool> marked;
+    marked.resize(cols * rows, false);
+
+    for (auto r : regions) {
+        r = r.clipTo(bound);
+        if (r.width <= 0 or r.height <= 0)
+            continue;
+
+        for (isize y = (r.y - bound.y) / TILE_SIZE; y <= (r.bottom() - bound.y - 1) / TILE_SIZE; y++)
+            for (isize x = (r.x - bound.x) / TILE_SIZE; x <= (r.end() - bound.x - 1) / TILE_SIZE; x++)
+                marked[y * cols + x] = true;
+    }
+
+    Opt<Math::Recti> res;
+    for (isize y = 0; y < rows; y++) {
+        for (isize x = 0; x < cols; x++) {
+            if (not marked[y * cols + x])
+                continue;
+
+            Math::Recti tile = {
+                bound.x + x * TILE_SIZE,
+                bound.y + y * TILE_SIZE,
+                TILE_SIZE,
+                TILE_SIZE,
+            };
+            tile = tile.clipTo(bound);
+
+            tiles.pushBack(tile);
+            res = res ? res->mergeWith(tile) : tile;
+        }
+    }
+
+    return tryOr(res, {});
+}
+
+} // namespace Karm::Ui
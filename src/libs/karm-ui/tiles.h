@@ -0,0 +1,71 @@
+#pragma once
+
+#include <karm-base/atomic.h>
+#include <karm-base/rc.h>
+#include <karm-base/vec.h>
+#include <karm-gfx/context.h>
+#include <karm-sys/mutex.h>
+#include <karm-sys/thread.h>
+
+namespace Karm::Ui {
+
+static constexpr isize TILE_SIZE = 64;
+
+// Rasterizes a display list tile by tile on a set of worker threads,
+// each with its own context, the calling thread takes part in the work.
+struct TileRaster : Meta::Static {
+    Vec<Strong<Sys::Thread>> _threads;
+    Strong<Sys::Mutex> _mutex;
+    Strong<Sys::CondVar> _cond;
+
+    // A frame as seen by whoever rasterizes it, copied under the
+    // mutex so that it stays the same while draining.
+    struct _Job {
+        usize frame;
+        Gfx::DisplayList const *list;
+        Gfx::MutPixels pixels;
+        Slice<Math::Recti> tiles;
+    };
+
+    // Written under the mutex.
+    usize _frame = 0;
+    bool _stop = false;
+    Gfx::DisplayList const *_list = nullptr;
+    Opt<Gfx::MutPixels> _pixels = NONE;
+    Slice<Math::Recti> _tiles{};
+
+    // The frame in the upper half and the next tile in the lower one,
+    // a worker still on a previous frame can't claim any tile.
+    Atomic<u64> _next{};
+    Atomic<usize> _done{};
+    Atomic<usize> _active{};
+
+    Gfx::Context _g;
+
+    static Res<Strong<TileRaster>> create(usize workers = max(Sys::cpuCount(), 1uz) - 1);
+
+    TileRaster(Strong<Sys::Mutex> mutex, Strong<Sys::CondVar> cond)
+        : _mutex(mutex), _cond(cond) {}
+
+    ~TileRaster();
+
+    usize len() const {
+        return _threads.len();
+    }
+
+    // Replay the list over each of the tiles, returns once all of them
+    // have been rasterized.
+    void render(Gfx::DisplayList const &list, Gfx::MutPixels pixels, Slice<Math::Recti> tiles);
+
+    bool _claim(_Job const &job, usize &i);
+
+    void _drain(Gfx::Context &g, _Job const &job);
+
+    void _work();
+};
+
+// Collect the tiles of the grid covering the bound that intersect
+// any of the regions, returns the bound of these tiles.
+Math::Recti collectTiles(Math::Recti bound, Slice<Math::Recti> regions, Vec<Math::Recti> &tiles);
+
+} // namespace Karm::Ui
@@ -0,0 +1,140 @@
+#include <karm-io/emit.h>
+#include <karm-sys/file.h>
+
+#include "trace.h"
+
+namespace Karm::Ui {
+
+bool debugTrace = false;
+usize debugNodeCreated = 0;
+
+Str toStr(TraceKind kind) {
+    switch (kind) {
+    case TraceKind::FRAME:
+        return "frame";
+    case TraceKind::INPUT:
+        return "input";
+    case TraceKind::ANIMATE:
+        return "animate";
+    case TraceKind::BUILD:
+        return "build";
+    case TraceKind::RECONCILE:
+        return "reconcile";
+    case TraceKind::LAYOUT:
+        return "layout";
+    case TraceKind::SIZE:
+        return "size";
+    case TraceKind::PAINT:
+        return "paint";
+    case TraceKind::RASTER:
+        return "raster";
+    case TraceKind::BLIT:
+        return "blit";
+    default:
+        return "unknown";
+    }
+}
+
+/* --- Tracer --------------------------------------------------------------- */
+
+Tracer &Tracer::global() {
+    static Tracer tracer;
+    return tracer;
+}
+
+usize Tracer::begin(TraceKind kind, Str name) {
+    if (_spans.len() == 0)
+        _spans.resize(CAPACITY);
+
+    usize seq = _next++;
+    _spans[seq % CAPACITY] = {
+        .seq = seq,
+        .kind = kind,
+        .depth = _depth++,
+        .name = name.len() ? name : toStr(kind),
+        .start = Sys::uptime(),
+        .duration = {},
+        .allocs = debugNodeCreated,
+        .done = false,
+    };
+    return seq;
+}
+
+void Tracer::end(usize seq) {
+    _depth--;
+
+    // The spans nested in it were so many that it got overwritten.
+    auto &span = _spans[seq % CAPACITY];
+    if (span.seq != seq)
+        return;
+
+    span.duration = Sys::uptime() - span.start;
+    span.allocs = debugNodeCreated - span.allocs;
+    span.done = true;
+}
+
+void Tracer::clear() {
+    _next = 0;
+    _depth = 0;
+}
+
+/* --- Export --------------------------------------------------------------- */
+
+static void _emitStr(Io::Emit &e, Str str) {
+    e('"');
+    for (auto c : str) {
+        if (c == '"' or c == '\\')
+            e('\\');
+        e((Rune)c);
+    }
+    e('"');
+}
+
+Res<> Tracer::exportChrome(Io::TextWriter &writer) const {
+    Io::Emit e{writer};
+    e(Str{"{\"traceEvents\":["});
+
+    bool first = true;
+    for (usize i = 0; i < len(); i++) {
+        auto &span = (*this)[i];
+
+        // Still running, or was overwritten while it was.
+        if (not span.done)
+            continue;
+
+        if (not first)
+            e(',');
+        first = false;
+
+        e('\n');
+        e(Str{"{\"name\":"});
+        _emitStr(e, span.name);
+        e(Str{",\"cat\":"});
+        _emitStr(e, toStr(span.kind));
+        e(",\"ph\":\"X\",\"pid\":1,\"tid\":1,\"ts\":{},\"dur\":{}", span.start.toUSecs(), span.duration.toUSecs());
+        e(",\"args\":");
+        e('{');
+        e("\"allocs\":{},\"depth\":{}", span.allocs, span.depth);
+        e(Str{"}}"});
+    }
+
+    e('\n');
+    e(Str{"],\"displayTimeUnit\":\"ms\"}"});
+    e('\n');
+
+    return e._error;
+}
+
+Res<> Tracer::save(Url::Url url) const {
+    Io::StringWriter writer;
+    try$(exportChrome(writer));
+    auto json = writer.take();
+
+    auto file = try$(Sys::File::create(url));
+    try$(file.write(bytes(json)));
+    try$(file.flush());
+
+    return Ok();
+}
+
+} // namespace Karm::Ui
@@ -0,0 +1,105 @@
+#pragma once
+
+#include <karm-base/vec.h>
+#include <karm-io/traits.h>
+#include <karm-meta/nocopy.h>
+#include <karm-sys/time.h>
+#include <url/url.h>
+
+namespace Karm::Ui {
+
+// Recording is off unless asked for, a trace scope then
+// costs a single branch.
+extern bool debugTrace;
+
+// Nodes created since startup, the difference between the start
+// and the end of a span is how many were allocated during it.
+extern usize debugNodeCreated;
+
+enum struct TraceKind : u8 {
+    FRAME,
+    INPUT,
+    ANIMATE,
+    BUILD,
+    RECONCILE,
+    LAYOUT,
+    SIZE,
+    PAINT,
+    RASTER,
+    BLIT,
+
+    _LEN,
+};
+
+Str toStr(TraceKind kind);
+
+struct TraceSpan {
+    usize seq;
+    TraceKind kind;
+    u16 depth;
+    Str name;
+    TimeSpan start;
+    TimeSpan duration;
+    usize allocs;
+    bool done;
+};
+
+// Keeps the most recent spans in a ring, they are written when they
+// start and completed when they end. Only the UI thread records.
+struct Tracer {
+    static constexpr usize CAPACITY = 1 << 16;
+
+    Vec<TraceSpan> _spans;
+    usize _next = 0;
+    u16 _depth = 0;
+
+    static Tracer &global();
+
+    usize begin(TraceKind kind, Str name);
+
+    void end(usize seq);
+
+    void clear();
+
+    usize len() const {
+        return min(_next, CAPACITY);
+    }
+
+    // Oldest first.
+    TraceSpan const &operator[](usize i) const {
+        return _spans[(_next - len() + i) % CAPACITY];
+    }
+
+    // Writes the spans as Chrome trace events, they can be
+    // opened in chrome://tracing or ui.perfetto.dev.
+    Res<> exportChrome(Io::TextWriter &writer) const;
+
+    Res<> save(Url::Url url) const;
+};
+
+struct TraceScope : Meta::Static {
+    static constexpr usize NONE_SEQ = ~0uz;
+
+    usize _seq = NONE_SEQ;
+
+    ALWAYS_INLINE TraceScope(TraceKind kind, Str name = "") {
+        if (debugTrace) [[unlikely]]
+            _seq = Tracer::global().begin(kind, name);
+    }
+
+    // Nodes are named after their type, which is only
+    // looked up while recording.
+    ALWAYS_INLINE TraceScope(TraceKind kind, auto const &node)
+        requires requires { node.typeName(); }
+    {
+        if (debugTrace) [[unlikely]]
+            _seq = Tracer::global().begin(kind, node.typeName());
+    }
+
+    ALWAYS_INLINE ~TraceScope() {
+        if (_seq != NONE_SEQ) [[unlikely]]
+            Tracer::global().end(_seq);
+    }
+};
+
+} // namespace Karm::Ui
@@ -178,9 +178,11 @@ struct Text : public View<Text> {
     Text(TextStyle style, String text)
         : _style(style), _text(text) {}
 
-    void reconcile(Text &o) override {
-        _text = o._text;
+    bool reconcile(Text &o) override {
+        if (not reconcileProp(_text, o._text))
+            return false;
         _mesure = NONE;
+        return true;
     }
 
     Media::FontMesure mesure() {
@@ -261,9 +263,10 @@ struct Icon : public View<Icon> {
     Icon(Media::Icon icon, Opt<Gfx::Color> color)
         : _icon(icon), _color(color) {}
 
-    void reconcile(Icon &o) override {
-        _icon = o._icon;
-        _color = o._color;
+    bool reconcile(Icon &o) override {
+        bool changed = reconcileProp(_icon, o._icon);
+        changed |= reconcileProp(_color, o._color);
+        return changed;
     }
 
     void paint(Gfx::Context &g, Math::Recti) override {
@@ -334,9 +337,9 @@ struct Canvas : public View<Canvas> {
     Canvas(OnPaint onPaint)
         : _onPaint(std::move(onPaint)) {}
 
-    void reconcile(Canvas &o) override {
-        _onPaint = std::move(o._onPaint);
-        View<Canvas>::reconcile(o);
+    bool reconcile(Canvas &o) override {
+        // What gets painted can't be compared, it always changed.
+        return reconcileProp(_onPaint, o._onPaint);
     }
 
     void paint(Gfx::Context &g, Math::Recti) override {
@@ -369,9 +372,9 @@ struct BackgroundFilter : public ProxyNode<BackgroundFilter> {
         : ProxyNode<BackgroundFilter>(std::move(child)),
           _filter(radius) {}
 
-    void reconcile(BackgroundFilter &o) override {
-        _filter = o._filter;
-        ProxyNode<BackgroundFilter>::reconcile(o);
+    bool reconcile(BackgroundFilter &o) override {
+        bool changed = reconcileProp(_filter, o._filter);
+        return ProxyNode<BackgroundFilter>::reconcile(o) or changed;
     }
 
     void paint(Gfx::Context &g, Math::Recti r) override {
@@ -391,9 +394,9 @@ struct ForegroundFilter : public ProxyNode<ForegroundFilter> {
         : ProxyNode<ForegroundFilter>(std::move(child)),
           _filter(radius) {}
 
-    void reconcile(ForegroundFilter &o) override {
-        _filter = o._filter;
-        ProxyNode<ForegroundFilter>::reconcile(o);
+    bool reconcile(ForegroundFilter &o) override {
+        bool changed = reconcileProp(_filter, o._filter);
+        return ProxyNode<ForegroundFilter>::reconcile(o) or changed;
     }
 
     void paint(Gfx::Context &g, Math::Recti r) override {
@@ -0,0 +1,213 @@
+#pragma once
+
+// Copying, filling and scanning kernels behind string.c. They are kept
+// apart from the public names so that they can be tested side by side
+// with the host C library.
+
+#include <stdc-base/prelude.h>
+#include <stddef.h>
+#include <stdint.h>
+
+STDC_BEGIN_HEADER
+
+typedef size_t __attribute__((__may_alias__)) _StdcWord;
+typedef size_t __attribute__((__may_alias__, __aligned__(1))) _StdcUWord;
+
+#define _STDC_WORD sizeof(_StdcWord)
+#define _STDC_ONES ((size_t)-1 / 0xff)
+#define _STDC_HIGHS (_STDC_ONES * 0x80)
+
+// Non-zero if any byte of the word is zero.
+#define _STDC_HAS_ZERO(X) (((X) - _STDC_ONES) & ~(X) & _STDC_HIGHS)
+
+// Below this, setting up a string instruction costs more than it saves.
+#define _STDC_REP_THRESHOLD 512
+
+// Word-at-a-time scans read whole aligned words. Those never cross
+// a page, but they may go past the end of the object.
+#if defined(__clang__) || defined(__GNUC__)
+#    define _STDC_WORD_SCAN __attribute__((__no_sanitize_address__))
+#else
+#    define _STDC_WORD_SCAN
+#endif
+
+#ifdef __SSE2__
+typedef char __attribute__((__vector_size__(16), __may_alias__, __aligned__(1))) _StdcVec;
+#endif
+
+/* --- Copying -------------------------------------------------------------- */
+
+static inline void _stdc_copyForward(unsigned char *d, unsigned char const *s, size_t n) {
+    // Align the destination, the source might stay unaligned.
+    while (n && ((uintptr_t)d & (_STDC_WORD - 1))) {
+        *d++ = *s++;
+        n--;
+    }
+
+#ifdef __SSE2__
+    for (; n >= 64; n -= 64, d += 64, s += 64) {
+        _StdcVec a = ((_StdcVec const *)s)[0];
+        _StdcVec b = ((_StdcVec const *)s)[1];
+        _StdcVec c = ((_StdcVec const *)s)[2];
+        _StdcVec e = ((_StdcVec const *)s)[3];
+        ((_StdcVec *)d)[0] = a;
+        ((_StdcVec *)d)[1] = b;
+        ((_StdcVec *)d)[2] = c;
+        ((_StdcVec *)d)[3] = e;
+    }
+#endif
+
+    for (; n >= _STDC_WORD; n -= _STDC_WORD, d += _STDC_WORD, s += _STDC_WORD)
+        *(_StdcWord *)d = *(_StdcUWord const *)s;
+
+    while (n--)
+        *d++ = *s++;
+}
+
+// NOTE: Each word is read before the one below it is written, so the
+//       destination may overlap the end of the source.
+static inline void _stdc_copyBackward(unsigned char *d, unsigned char const *s, size_t n) {
+    d += n;
+    s += n;
+
+    while (n && ((uintptr_t)d & (_STDC_WORD - 1))) {
+        *--d = *--s;
+        n--;
+    }
+
+    for (; n >= _STDC_WORD; n -= _STDC_WORD) {
+        d -= _STDC_WORD;
+        s -= _STDC_WORD;
+        *(_StdcWord *)d = *(_StdcUWord const *)s;
+    }
+
+    while (n--)
+        *--d = *--s;
+}
+
+static inline void *_stdc_memcpy(void *STDC_RESTRICT s1, void const *STDC_RESTRICT s2, size_t n) {
+    unsigned char *d = (unsigned char *)s1;
+    unsigned char const *s = (unsigned char const *)s2;
+
+#ifdef __x86_64__
+    // Fast strings microcode moves whole cache lines at a time.
+    if (n >= _STDC_REP_THRESHOLD) {
+        __asm__ volatile("rep movsb"
+                         : "+D"(d), "+S"(s), "+c"(n)
+                         :
+                         : "memory");
+        return s1;
+    }
+#endif
+
+    _stdc_copyForward(d, s, n);
+    return s1;
+}
+
+static inline void *_stdc_memmove(void *s1, void const *s2, size_t n) {
+    unsigned char *d = (unsigned char *)s1;
+    unsigned char const *s = (unsigned char const *)s2;
+
+    if (d == s || n == 0)
+        return s1;
+
+    // Copying forward is fine as long as we don't write over the part
+    // of the source that wasn't read yet, that is unless the destination
+    // starts inside of the source.
+    if ((uintptr_t)d - (uintptr_t)s >= n) {
+#ifdef __x86_64__
+        if (n >= _STDC_REP_THRESHOLD) {
+            __asm__ volatile("rep movsb"
+                             : "+D"(d), "+S"(s), "+c"(n)
+                             :
+                             : "memory");
+            return s1;
+        }
+#endif
+        _stdc_copyForward(d, s, n);
+    } else {
+        _stdc_copyBackward(d, s, n);
+    }
+
+    return s1;
+}
+
+/* --- Filling -------------------------------------------------------------- */
+
+static inline void *_stdc_memset(void *s, int c, size_t n) {
+    unsigned char *d = (unsigned char *)s;
+
+#ifdef __x86_64__
+    if (n >= _STDC_REP_THRESHOLD) {
+        __asm__ volatile("rep stosb"
+                         : "+D"(d), "+c"(n)
+                         : "a"(c)
+                         : "memory");
+        return s;
+    }
+#endif
+
+    while (n && ((uintptr_t)d & (_STDC_WORD - 1))) {
+        *d++ = (unsigned char)c;
+        n--;
+    }
+
+    size_t word = _STDC_ONES * (unsigned char)c;
+    for (; n >= _STDC_WORD; n -= _STDC_WORD, d += _STDC_WORD)
+        *(_StdcWord *)d = word;
+
+    while (n--)
+        *d++ = (unsigned char)c;
+
+    return s;
+}
+
+/* --- Scanning ------------------------------------------------------------- */
+
+_STDC_WORD_SCAN static inline size_t _stdc_strlen(char const *s) {
+    char const *p = s;
+
+    while ((uintptr_t)p & (_STDC_WORD - 1)) {
+        if (*p == '\0')
+            return p - s;
+        p++;
+    }
+
+    _StdcWord const *w = (_StdcWord const *)p;
+    while (!_STDC_HAS_ZERO(*w))
+        w++;
+
+    p = (char const *)w;
+    while (*p)
+        p++;
+
+    return p - s;
+}
+
+_STDC_WORD_SCAN static inline void *_stdc_memchr(void const *s, int c, size_t n) {
+    unsigned char const *p = (unsigned char const *)s;
+    unsigned char b = (unsigned char)c;
+
+    while (n && ((uintptr_t)p & (_STDC_WORD - 1))) {
+        if (*p == b)
+            return (void *)p;
+        p++;
+        n--;
+    }
+
+    // A byte equal to c is a zero byte once xored with c in every lane.
+    size_t pattern = _STDC_ONES * b;
+    for (; n >= _STDC_WORD; n -= _STDC_WORD, p += _STDC_WORD) {
+        size_t x = *(_StdcWord const *)p ^ pattern;
+        if (_STDC_HAS_ZERO(x))
+            break;
+    }
+
+    for (; n; n--, p++)
+        if (*p == b)
+            return (void *)p;
+
+    return NULL;
+}
+
+STDC_END_HEADER
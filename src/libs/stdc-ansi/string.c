@@ -1,31 +1,16 @@
 #include <stdc-base/prelude.h>
 #include <string.h>
 
+#include "_string.h"
+
 /* --- 7.24.2 - Copying functions ------------------------------------------- */
 
 void *memcpy(void *STDC_RESTRICT s1, void const *STDC_RESTRICT s2, size_t n) {
-    char *STDC_RESTRICT p1 = (char *STDC_RESTRICT)s1;
-    char const *STDC_RESTRICT p2 = (char const *STDC_RESTRICT)s2;
-    while (n--)
-        *p1++ = *p2++;
-    return s1;
+    return _stdc_memcpy(s1, s2, n);
 }
 
 void *memmove(void *s1, void const *s2, size_t n) {
-    char const *usrc = (char const *)s2;
-    char *udest = (char *)s1;
-
-    if (udest < usrc) {
-        for (size_t i = 0; i < n; i++) {
-            udest[i] = usrc[i];
-        }
-    } else if (udest > usrc) {
-        for (size_t i = n; i > 0; i--) {
-            udest[i - 1] = usrc[i - 1];
-        }
-    }
-
-    return s1;
+    return _stdc_memmove(s1, s2, n);
 }
 
 char *strcpy(char *STDC_RESTRICT s1, char const *STDC_RESTRICT s2) {
@@ -82,8 +67,11 @@ char *strncat(char *STDC_RESTRICT s1, char const *STDC_RESTRICT s2, size_t n) {
 /* --- 7.24.4 - Comparison functions ---------------------------------------- */
 
 int memcmp(void const *s1, void const *s2, size_t n) {
+    unsigned char const *p1 = (unsigned char const *)s1;
+    unsigned char const *p2 = (unsigned char const *)s2;
+
     for (size_t i = 0; i < n; i++) {
-        int diff = *(char *)s1 - *(char *)s2;
+        int diff = p1[i] - p2[i];
         if (diff != 0) {
             return diff;
         }
@@ -121,7 +109,9 @@ int strncmp(char const *s1, char const *s2, size_t n) {
 
 /* --- 7.24.5 - Search functions -------------------------------------------- */
 
-// void *memchr(void const *s, int c, size_t n) {}
+void *memchr(void const *s, int c, size_t n) {
+    return _stdc_memchr(s, c, n);
+}
 
 char *strchr(char const *s, int c) {
     size_t len = strlen(s);
@@ -161,20 +151,11 @@ char *strrchr(char const *s, int c) {
 /* --- 7.24.6 - Miscellaneous functions ------------------------------------- */
 
 void *memset(void *s, int c, size_t n) {
-    char *p = (char *)s;
-    while (n--) {
-        *p++ = c;
-    }
-    return s;
+    return _stdc_memset(s, c, n);
 }
 
 // char *strerror(int errnum) { }
 
 size_t strlen(char const *s) {
-    size_t i = 0;
-
-    while (s[i++] != '\0')
-        ;
-
-    return i;
+    return _stdc_strlen(s);
 }
@@ -0,0 +1,99 @@
+#include <karm-base/buf.h>
+#include <karm-test/macros.h>
+#include <stdc-ansi/_string.h>
+#include <string.h>
+
+// The kernels behind stdc-ansi, next to the C library of the host.
+
+namespace StdcAnsi::Tests {
+
+/* --- memcpy --------------------------------------------------------------- */
+
+// Copies from an unaligned source, into a destination the
+// compiler must assume is read afterward.
+static void _benchMemcpy(Bencher &b, usize n, auto copy) {
+    auto src = Buf<u8>::init(n + 1, 1);
+    auto dst = Buf<u8>::init(n, 0);
+
+    b.bytes(n);
+    b.run([&] {
+        copy(dst.buf(), src.buf() + 1, n);
+        clobber();
+    });
+}
+
+static void _byteCopy(u8 *d, u8 const *s, usize n) {
+    auto *vd = (u8 volatile *)d;
+    while (n--)
+        *vd++ = *s++;
+}
+
+static void _stdcCopy(u8 *d, u8 const *s, usize n) {
+    _stdc_memcpy(d, s, n);
+}
+
+static void _hostCopy(u8 *d, u8 const *s, usize n) {
+    memcpy(d, s, n);
+}
+
+bench$(memcpyBytes1K) {
+    _benchMemcpy(b, 1 << 10, _byteCopy);
+}
+
+bench$(memcpyStdc64) {
+    _benchMemcpy(b, 64, _stdcCopy);
+}
+
+bench$(memcpyStdc1K) {
+    _benchMemcpy(b, 1 << 10, _stdcCopy);
+}
+
+bench$(memcpyStdc16K) {
+    _benchMemcpy(b, 16 << 10, _stdcCopy);
+}
+
+bench$(memcpyStdc1M) {
+    _benchMemcpy(b, 1 << 20, _stdcCopy);
+}
+
+bench$(memcpyHost64) {
+    _benchMemcpy(b, 64, _hostCopy);
+}
+
+bench$(memcpyHost1K) {
+    _benchMemcpy(b, 1 << 10, _hostCopy);
+}
+
+bench$(memcpyHost16K) {
+    _benchMemcpy(b, 16 << 10, _hostCopy);
+}
+
+bench$(memcpyHost1M) {
+    _benchMemcpy(b, 1 << 20, _hostCopy);
+}
+
+/* --- strlen --------------------------------------------------------------- */
+
+// Starting at a different offset each time, so
+// that the calls can't be hoisted out of the loop.
+static void _benchStrlen(Bencher &b, auto len) {
+    auto buf = Buf<u8>::init(1 << 16, 'a');
+    buf[buf.len() - 1] = 0;
+    auto *s = (char const *)buf.buf();
+
+    usize round = 0;
+    b.bytes(buf.len());
+    b.run([&] {
+        doNotOptimize(len(s + round++ % 8));
+    });
+}
+
+bench$(strlenStdc64K) {
+    _benchStrlen(b, _stdc_strlen);
+}
+
+bench$(strlenHost64K) {
+    _benchStrlen(b, strlen);
+}
+
+} // namespace StdcAnsi::Tests
@@ -0,0 +1,122 @@
+#include <karm-base/buf.h>
+#include <karm-math/rand.h>
+#include <karm-test/macros.h>
+#include <stdc-ansi/_string.h>
+#include <string.h>
+
+// Checks the kernels behind stdc-ansi against the C library of the host.
+
+namespace StdcAnsi::Tests {
+
+static constexpr usize SIZE = 4096;
+static constexpr usize ROUNDS = 20000;
+
+static void _randomize(Math::Rand &rand, Buf<u8> &buf) {
+    for (auto &b : buf)
+        b = rand.nextU8();
+}
+
+test$(stdcMemcpy) {
+    Math::Rand rand{0x1234};
+    auto src = Buf<u8>::init(SIZE, 0);
+    auto got = Buf<u8>::init(SIZE, 0);
+    auto want = Buf<u8>::init(SIZE, 0);
+
+    for (usize i = 0; i < ROUNDS; i++) {
+        _randomize(rand, src);
+        _randomize(rand, got);
+        memcpy(want.buf(), got.buf(), SIZE);
+
+        // Mostly small copies, with every alignment, sometimes big ones.
+        usize so = rand.nextInt(16);
+        usize d = rand.nextInt(16);
+        usize n = rand.nextInt(i % 8 ? 128 : SIZE - 16);
+
+        expect$(_stdc_memcpy(got.buf() + d, src.buf() + so, n) == got.buf() + d);
+        memcpy(want.buf() + d, src.buf() + so, n);
+        expectEq$(memcmp(got.buf(), want.buf(), SIZE), 0);
+    }
+
+    return Ok();
+}
+
+test$(stdcMemmove) {
+    Math::Rand rand{0x5678};
+    auto got = Buf<u8>::init(SIZE, 0);
+    auto want = Buf<u8>::init(SIZE, 0);
+
+    for (usize i = 0; i < ROUNDS; i++) {
+        _randomize(rand, got);
+        memcpy(want.buf(), got.buf(), SIZE);
+
+        // Overlapping both ways, and not at all.
+        usize n = rand.nextInt(i % 8 ? 128 : SIZE / 2);
+        usize s = rand.nextInt(SIZE - n);
+        usize d = rand.nextInt(SIZE - n);
+
+        expect$(_stdc_memmove(got.buf() + d, got.buf() + s, n) == got.buf() + d);
+        memmove(want.buf() + d, want.buf() + s, n);
+        expectEq$(memcmp(got.buf(), want.buf(), SIZE), 0);
+    }
+
+    return Ok();
+}
+
+test$(stdcMemset) {
+    Math::Rand rand{0x9abc};
+    auto got = Buf<u8>::init(SIZE, 0);
+    auto want = Buf<u8>::init(SIZE, 0);
+
+    for (usize i = 0; i < ROUNDS; i++) {
+        usize d = rand.nextInt(16);
+        usize n = rand.nextInt(i % 8 ? 128 : SIZE - 16);
+        int c = rand.nextInt(256);
+
+        expect$(_stdc_memset(got.buf() + d, c, n) == got.buf() + d);
+        memset(want.buf() + d, c, n);
+        expectEq$(memcmp(got.buf(), want.buf(), SIZE), 0);
+    }
+
+    return Ok();
+}
+
+test$(stdcStrlen) {
+    Math::Rand rand{0xdef0};
+    auto buf = Buf<u8>::init(SIZE, 0);
+
+    for (usize i = 0; i < ROUNDS; i++) {
+        for (auto &b : buf)
+            b = 1 + rand.nextInt(255);
+
+        usize start = rand.nextInt(16);
+        usize end = start + rand.nextInt(i % 8 ? 64 : SIZE - 32);
+        buf[end] = 0;
+
+        auto *s = (char const *)buf.buf() + start;
+        expectEq$(_stdc_strlen(s), strlen(s));
+    }
+
+    return Ok();
+}
+
+test$(stdcMemchr) {
+    Math::Rand rand{0x1357};
+    auto buf = Buf<u8>::init(SIZE, 0);
+
+    for (usize i = 0; i < ROUNDS; i++) {
+        // Few distinct values, so that the byte is often found.
+        for (auto &b : buf)
+            b = rand.nextInt(i % 2 ? 4 : 256);
+
+        usize start = rand.nextInt(16);
+        usize n = rand.nextInt(i % 8 ? 128 : SIZE - 16);
+        int c = rand.nextInt(i % 2 ? 4 : 256);
+
+        auto *s = buf.buf() + start;
+        expect$(_stdc_memchr(s, c, n) == memchr(s, c, n));
+    }
+
+    return Ok();
+}
+
+} // namespace StdcAnsi::Tests
@@ -7,15 +7,66 @@
 //  - http://www.ece.ualberta.ca/~elliott/ee552/studentAppNotes/2003_w/misc/bmp_file_format/bmp_file_format.htm
 //  - http://www.martinreddy.net/gfx/2d/BMP.txt
 
+#include <karm-base/align.h>
+#include <karm-base/array.h>
+#include <karm-base/bits.h>
 #include <karm-base/vec.h>
 #include <karm-gfx/buffer.h>
+#include <karm-gfx/colors.h>
 #include <karm-io/bscan.h>
 #include <karm-io/emit.h>
 #include <karm-logger/logger.h>
 
 namespace Bmp {
 
+/* --- Rows ----------------------------------------------------------------- */
+
+// Rows are converted straight into the destination scanlines, pixels
+// are written as a little endian u32 in the order of its format.
+
+#if __has_builtin(__builtin_shufflevector)
+#    define _BMP_SIMD
+typedef u8 __attribute__((__vector_size__(16), __may_alias__, __aligned__(1))) _BmpVec;
+#endif
+
+ALWAYS_INLINE static inline u32 _pack(u8 r, u8 g, u8 b, u8 a, bool bgra) {
+    if (bgra)
+        return b | g << 8 | r << 16 | (u32)a << 24;
+    return r | g << 8 | b << 16 | (u32)a << 24;
+}
+
+ALWAYS_INLINE static inline void _store(u8 *dst, u32 pixel) {
+    __builtin_memcpy(dst, &pixel, 4);
+}
+
+// A color channel described by a bit mask, scaled to 8 bits.
+struct Channel {
+    u32 mask = 0;
+    u32 shift = 0;
+    u64 scale = 0;
+
+    static Channel fromMask(u32 mask) {
+        if (mask == 0)
+            return {};
+        u32 shift = ctz(mask);
+        u64 max = mask >> shift;
+        return {mask, shift, ((255ull << 24) + max - 1) / max};
+    }
+
+    ALWAYS_INLINE u8 extract(u32 pixel, u8 fallback) const {
+        if (not mask)
+            return fallback;
+        return ((pixel & mask) >> shift) * scale >> 24;
+    }
+};
+
+/* --- Image ---------------------------------------------------------------- */
+
 struct Image {
+    // Larger images are rejected before anything gets allocated for them.
+    static constexpr usize MAX_PIXELS = 1uz << 28;
+
+    using Row = void (*)(u8 *dst, u8 const *src, usize width, Image const &image);
 
     /* --- Loading ---------------------------------------------------------- */
 
@@ -52,11 +103,12 @@ struct Image {
         s.skip(2); // signature
         s.skip(4); // file size
         s.skip(4); // reserved
-        _dataOffset = s.nextI32le();
+        _dataOffset = s.nextU32le();
 
         return Ok();
     }
 
+    usize _headerSize;
     isize _width;
     isize _height;
     isize _bpp;
@@ -69,42 +121,106 @@ struct Image {
         return Math::abs(_height);
     }
 
+    // Rows are stored bottom up, unless the height is negative.
+    bool topDown() const {
+        return _height < 0;
+    }
+
     enum Compression {
         RGB = 0,
         RLE8 = 1,
         RLE4 = 2,
+        BITFIELDS = 3,
+        ALPHABITFIELDS = 6,
     } _compression;
 
     usize _numsColors;
 
+    Channel _red;
+    Channel _green;
+    Channel _blue;
+    Channel _alpha;
+
     Res<> readInfoHeader(Io::BScan &s) {
-        s.skip(4); // header size
+        _headerSize = s.nextU32le();
+        if (_headerSize < 40 or s.rem() < _headerSize - 4) {
+            return Error::invalidData("invalid info header");
+        }
+
         _width = s.nextI32le();
         _height = s.nextI32le();
+        if (_width <= 0 or _height == 0) {
+            return Error::invalidData("invalid size");
+        }
+
+        if ((usize)width() * (usize)height() > MAX_PIXELS) {
+            return Error::invalidData("image too large");
+        }
 
         auto planes = s.nextI16le();
-        logDebug("planes: {}", planes);
         if (planes != 1) {
             return Error::invalidData("invalid number of planes");
         }
 
-        _bpp = s.nextI16le();
+        _bpp = s.nextU16le();
+        if (_bpp != 1 and _bpp != 4 and _bpp != 8 and
+            _bpp != 16 and _bpp != 24 and _bpp != 32) {
+            return Error::invalidData("invalid bpp");
+        }
 
-        auto comporession = s.nextI32le();
-        if (comporession != RGB and comporession != RLE8 and comporession != RLE4) {
+        auto compression = s.nextU32le();
+        if (compression != RGB and compression != RLE8 and compression != RLE4 and
+            compression != BITFIELDS and compression != ALPHABITFIELDS) {
             return Error::invalidData("invalid compression");
         }
 
+        _compression = (Compression)compression;
+        bool masked = _compression == BITFIELDS or _compression == ALPHABITFIELDS;
+        if (not(_compression == RGB or
+                (_compression == RLE8 and _bpp == 8) or
+                (_compression == RLE4 and _bpp == 4) or
+                (masked and (_bpp == 16 or _bpp == 32)))) {
+            return Error::invalidData("invalid compression");
+        }
+
+        if (topDown() and (_compression == RLE8 or _compression == RLE4)) {
+            return Error::invalidData("compressed images can't be top down");
+        }
+
         s.skip(4); // image size
         s.skip(4); // x pixels per meter
         s.skip(4); // y pixels per meter
-        _numsColors = s.nextI32le();
+        _numsColors = s.nextU32le();
         if (_numsColors == 0 and _bpp <= 8) {
             _numsColors = 1 << _bpp;
         }
 
+        if (_bpp <= 8 and _numsColors > (1uz << _bpp)) {
+            return Error::invalidData("invalid number of colors");
+        }
+
         s.skip(4); // important colors
 
+        // Past the original info header, or right after it.
+        if (masked) {
+            usize count = _compression == ALPHABITFIELDS or _headerSize >= 56 ? 4 : 3;
+            if (s.rem() < count * 4) {
+                return Error::invalidData("missing color masks");
+            }
+
+            _red = Channel::fromMask(s.nextU32le());
+            _green = Channel::fromMask(s.nextU32le());
+            _blue = Channel::fromMask(s.nextU32le());
+            if (count == 4)
+                _alpha = Channel::fromMask(s.nextU32le());
+        } else if (_bpp == 16) {
+            _red = Channel::fromMask(0x7C00);
+            _green = Channel::fromMask(0x03E0);
+            _blue = Channel::fromMask(0x001F);
+        }
+
+        s.seek(max(s.tell(), 14 + _headerSize));
+
         return Ok();
     }
 
@@ -113,6 +229,15 @@ struct Image {
     Vec<Gfx::Color> _palette;
 
     Res<> readPalette(Io::BScan &s) {
+        // Optional past 8 bits per pixel, and of no use.
+        if (_bpp > 8) {
+            return Ok();
+        }
+
+        if (s.rem() < _numsColors * 4) {
+            return Error::invalidData("palette too small");
+        }
+
         for (usize i = 0; i < _numsColors; ++i) {
             auto b = s.nextU8le();
             auto g = s.nextU8le();
@@ -130,70 +255,243 @@ struct Image {
     Bytes _pixels;
 
     Res<> readPixels(Io::BScan &s) {
+        if (_dataOffset < s.tell() or _dataOffset >= s.tell() + s.rem()) {
+            return Error::invalidData("invalid data offset");
+        }
+
         s.seek(_dataOffset);
         _pixels = s.restBytes();
         return Ok();
     }
 
+    /* --- Row Converters --------------------------------------------------- */
+
+    // The palette, packed for the destination and padded to 256 entries,
+    // indices past its end are black.
+    Array<u32, 256> _lut{};
+
+    void _buildLut(bool bgra) {
+        for (usize i = 0; i < _lut.len(); i++) {
+            auto c = i < _palette.len() ? _palette[i] : Gfx::BLACK;
+            _lut[i] = _pack(c.red, c.green, c.blue, 255, bgra);
+        }
+    }
+
+    static void _row1(u8 *dst, u8 const *src, usize width, Image const &image) {
+        for (usize x = 0; x < width; x++)
+            _store(dst + x * 4, image._lut[(src[x / 8] >> (7 - x % 8)) & 1]);
+    }
+
+    static void _row4(u8 *dst, u8 const *src, usize width, Image const &image) {
+        usize x = 0;
+        for (; x + 2 <= width; x += 2) {
+            u8 b = src[x / 2];
+            _store(dst + x * 4, image._lut[b >> 4]);
+            _store(dst + x * 4 + 4, image._lut[b & 0xF]);
+        }
+        if (x < width)
+            _store(dst + x * 4, image._lut[src[x / 2] >> 4]);
+    }
+
+    static void _row8(u8 *dst, u8 const *src, usize width, Image const &image) {
+        for (usize x = 0; x < width; x++)
+            _store(dst + x * 4, image._lut[src[x]]);
+    }
+
+    template <bool BGRA>
+    static void _row24(u8 *dst, u8 const *src, usize width, Image const &) {
+        usize x = 0;
+
+#ifdef _BMP_SIMD
+        _BmpVec const alpha = {0, 0, 0, 255, 0, 0, 0, 255, 0, 0, 0, 255, 0, 0, 0, 255};
+
+        // Four pixels at a time, the load reads a few bytes past
+        // them, which are still part of the row.
+        for (; x + 6 <= width; x += 4) {
+            _BmpVec v = *(_BmpVec const *)(src + x * 3);
+            if constexpr (BGRA)
+                v = __builtin_shufflevector(v, v, 0, 1, 2, -1, 3, 4, 5, -1, 6, 7, 8, -1, 9, 10, 11, -1);
+            else
+                v = __builtin_shufflevector(v, v, 2, 1, 0, -1, 5, 4, 3, -1, 8, 7, 6, -1, 11, 10, 9, -1);
+            *(_BmpVec *)(dst + x * 4) = v | alpha;
+        }
+#endif
+
+        for (; x < width; x++) {
+            u8 const *p = src + x * 3;
+            _store(dst + x * 4, _pack(p[2], p[1], p[0], 255, BGRA));
+        }
+    }
+
+    // Blue, green, red, and alpha when KEEP_ALPHA, otherwise
+    // the last byte is unused and the pixel is opaque.
+    template <bool BGRA, bool KEEP_ALPHA>
+    static void _row32(u8 *dst, u8 const *src, usize width, Image const &) {
+        usize x = 0;
+
+#ifdef _BMP_SIMD
+        _BmpVec const alpha = {0, 0, 0, 255, 0, 0, 0, 255, 0, 0, 0, 255, 0, 0, 0, 255};
+
+        for (; x + 4 <= width; x += 4) {
+            _BmpVec v = *(_BmpVec const *)(src + x * 4);
+            if constexpr (not BGRA)
+                v = __builtin_shufflevector(v, v, 2, 1, 0, 3, 6, 5, 4, 7, 10, 9, 8, 11, 14, 13, 12, 15);
+            if constexpr (not KEEP_ALPHA)
+                v |= alpha;
+            *(_BmpVec *)(dst + x * 4) = v;
+        }
+#endif
+
+        for (; x < width; x++) {
+            u8 const *p = src + x * 4;
+            _store(dst + x * 4, _pack(p[2], p[1], p[0], KEEP_ALPHA ? p[3] : 255, BGRA));
+        }
+    }
+
+    template <bool BGRA, usize BYTES>
+    static void _rowMasks(u8 *dst, u8 const *src, usize width, Image const &image) {
+        for (usize x = 0; x < width; x++) {
+            u32 pixel = 0;
+            __builtin_memcpy(&pixel, src + x * BYTES, BYTES);
+
+            _store(
+                dst + x * 4,
+                _pack(
+                    image._red.extract(pixel, 0),
+                    image._green.extract(pixel, 0),
+                    image._blue.extract(pixel, 0),
+                    image._alpha.extract(pixel, 255),
+                    BGRA
+                )
+            );
+        }
+    }
+
+    // Picks the converter once for the whole image.
+    template <bool BGRA>
+    Row _rowFor() const {
+        switch (_bpp) {
+        case 1:
+            return _row1;
+        case 4:
+            return _row4;
+        case 8:
+            return _row8;
+        case 16:
+            return _rowMasks<BGRA, 2>;
+        case 24:
+            return _row24<BGRA>;
+        default:
+            break;
+        }
+
+        bool plain = _red.mask == 0xFF0000 and
+                     _green.mask == 0xFF00 and
+                     _blue.mask == 0xFF;
+
+        if (_compression == RGB or (plain and _alpha.mask == 0))
+            return _row32<BGRA, false>;
+
+        if (plain and _alpha.mask == 0xFF000000)
+            return _row32<BGRA, true>;
+
+        return _rowMasks<BGRA, 4>;
+    }
+
     /* --- Decoding --------------------------------------------------------- */
 
-    Res<> decode(Gfx::MutPixels pixels) {
-        Io::BScan s{_pixels};
+    u8 *_scanline(Gfx::MutPixels pixels, isize y) const {
+        return static_cast<u8 *>(pixels.scanline(topDown() ? y : height() - y - 1));
+    }
+
+    Res<> _decodeRows(Gfx::MutPixels pixels, Row row) {
+        usize stride = alignUp(width() * _bpp, 32) / 8;
+        usize last = (width() * _bpp + 7) / 8;
+        if (_pixels.len() < stride * (height() - 1) + last) {
+            return Error::invalidData("pixel data too small");
+        }
+
+        for (isize y = 0; y < height(); ++y)
+            row(_scanline(pixels, y), _pixels.buf() + y * stride, width(), *this);
+
+        return Ok();
+    }
+
+    // Runs of a color, runs of literal colors, and jumps over pixels
+    // that are left transparent. Anything out of the image is dropped.
+    Res<> _decodeRle(Gfx::MutPixels pixels) {
+        bool rle4 = _compression == RLE4;
 
         for (isize y = 0; y < height(); ++y) {
-            for (isize x = 0; x < width(); ++x) {
-                auto color = Gfx::Color{};
-                if (_bpp == 1) {
-                    auto bit = s.nextBitbe();
-                    color = _palette[bit];
-                } else if (_bpp == 8) {
-                    auto index = s.nextU8le();
-                    if (index >= _palette.len()) {
-                        return Error::invalidData("invalid palette index");
-                    }
-                    color = _palette[index];
-                } else if (_bpp == 16) {
-                    auto pixel = s.nextU16le();
-                    color.blue = (pixel & 0x1F) << 3;
-                    color.green = ((pixel >> 5) & 0x1F) << 3;
-                    color.red = ((pixel >> 10) & 0x1F) << 3;
-                    color.alpha = 255;
-                } else if (_bpp == 24) {
-                    color.blue = s.nextU8le();
-                    color.green = s.nextU8le();
-                    color.red = s.nextU8le();
-                    color.alpha = 255;
-                } else if (_bpp == 32) {
-                    color.blue = s.nextU8le();
-                    color.green = s.nextU8le();
-                    color.red = s.nextU8le();
-                    color.alpha = 255 - s.nextU8le();
-                } else {
-                    return Error::invalidData("invalid bpp");
-                }
+            u8 *dst = _scanline(pixels, y);
+            for (isize x = 0; x < width(); ++x)
+                _store(dst + x * 4, 0);
+        }
 
-                Math::Vec2i pos{x, y};
+        Io::BScan s{_pixels};
+        isize x = 0, y = 0;
 
-                // if _width is negative, flip horizontally.
-                if (_width < 0) {
-                    pos.x = width() - x - 1;
-                }
+        auto put = [&](u8 index) {
+            if (x < width() and y < height())
+                _store(_scanline(pixels, y) + x * 4, _lut[index]);
+            x++;
+        };
 
-                // if _height is negative, flip vertically.
-                if (not(_height < 0)) {
-                    pos.y = height() - y - 1;
+        while (y < height()) {
+            if (s.rem() < 2) {
+                return Error::invalidData("unexpected end of data");
+            }
+
+            usize count = s.nextU8le();
+            u8 value = s.nextU8le();
+
+            if (count) {
+                for (usize i = 0; i < count; ++i)
+                    put(not rle4 ? value : i & 1 ? value & 0xF : value >> 4);
+            } else if (value == 0) {
+                // End of line.
+                x = 0;
+                y++;
+            } else if (value == 1) {
+                // End of bitmap.
+                break;
+            } else if (value == 2) {
+                if (s.rem() < 2) {
+                    return Error::invalidData("unexpected end of data");
+                }
+                x += s.nextU8le();
+                y += s.nextU8le();
+            } else {
+                // Literal run, padded to 16 bits.
+                usize len = rle4 ? (value + 1) / 2 : value;
+                if (s.rem() < len) {
+                    return Error::invalidData("unexpected end of data");
                 }
 
-                pixels.store(pos, color);
+                auto literal = s.nextBytes(len);
+                for (usize i = 0; i < value; ++i)
+                    put(not rle4 ? literal[i] : i & 1 ? literal[i / 2] & 0xF : literal[i / 2] >> 4);
+                s.skip(len & 1);
             }
-
-            // Skip padding.
-            s.skip((4 - (_width * _bpp / 8) % 4) % 4);
         }
 
         return Ok();
     }
 
+    Res<> decode(Gfx::MutPixels pixels) {
+        if (pixels.width() < width() or pixels.height() < height()) {
+            return Error::invalidInput("destination too small");
+        }
+
+        bool bgra = pixels._fmt.is<Gfx::Bgra8888>();
+        _buildLut(bgra);
+
+        if (_compression == RLE8 or _compression == RLE4)
+            return _decodeRle(pixels);
+
+        return _decodeRows(pixels, bgra ? _rowFor<true>() : _rowFor<false>());
+    }
+
     /* --- Dumping ---------------------------------------------------------- */
 
     void dump(Io::Emit &e) {
@@ -207,11 +505,13 @@ struct Image {
 
         e("Info header");
         e.indentNewline();
+        e.ln("header size: {}", _headerSize);
         e.ln("width: {}", _width);
         e.ln("height: {}", _height);
         e.ln("bpp: {}", _bpp);
         e.ln("compression: {}", (usize)_compression);
         e.ln("numsColors: {}", _numsColors);
+        e.ln("masks: {x} {x} {x} {x}", _red.mask, _green.mask, _blue.mask, _alpha.mask);
         e.deindent();
 
         e("palette:");
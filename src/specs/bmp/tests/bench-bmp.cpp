@@ -0,0 +1,47 @@
+#include <bmp/spec.h>
+#include <karm-media/image.h>
+#include <karm-sys/file.h>
+#include <karm-sys/mmap.h>
+#include <karm-test/macros.h>
+
+namespace Bmp::Tests {
+
+// Decodes the file over and over into the same image, so only
+// the decoder is measured, not loading or allocating.
+static void _benchDecode(Bencher &b, Str name) {
+    auto url = "bundle://bmp-spec-tests/bmpsuite/valid"_url;
+    url.append(name);
+
+    auto file = Sys::File::open(url).unwrap();
+    auto map = Sys::mmap().map(file).unwrap();
+    auto bmp = Image::load(map.bytes()).unwrap();
+    auto img = Media::Image::alloc({bmp.width(), bmp.height()});
+
+    b.bytes(bmp.width() * bmp.height() * 4);
+    b.run([&] {
+        bmp.decode(img).unwrap();
+        clobber();
+    });
+}
+
+bench$(bmpDecode24) {
+    _benchDecode(b, "24bpp-320x240.bmp");
+}
+
+bench$(bmpDecode32) {
+    _benchDecode(b, "32bpp-320x240.bmp");
+}
+
+bench$(bmpDecode565) {
+    _benchDecode(b, "565-320x240.bmp");
+}
+
+bench$(bmpDecode8) {
+    _benchDecode(b, "8bpp-320x240.bmp");
+}
+
+bench$(bmpDecodeRle8) {
+    _benchDecode(b, "rle8-encoded-320x240.bmp");
+}
+
+} // namespace Bmp::Tests
@@ -0,0 +1,102 @@
+#include <bmp/spec.h>
+#include <karm-media/image.h>
+#include <karm-sys/file.h>
+#include <karm-sys/mmap.h>
+#include <karm-test/macros.h>
+
+namespace Bmp::Tests {
+
+static Res<Media::Image> _load(Str name, Gfx::Fmt fmt = Gfx::RGBA8888) {
+    auto url = "bundle://bmp-spec-tests/bmpsuite"_url;
+    url.append(name);
+
+    auto file = try$(Sys::File::open(url));
+    auto map = try$(Sys::mmap().map(file));
+    auto bmp = try$(Image::load(map.bytes()));
+    auto img = Media::Image::alloc({bmp.width(), bmp.height()}, fmt);
+    try$(bmp.decode(img));
+    return Ok(std::move(img));
+}
+
+static bool _same(Gfx::Pixels a, Gfx::Pixels b) {
+    if (a.width() != b.width() or a.height() != b.height())
+        return false;
+
+    for (isize y = 0; y < a.height(); y++) {
+        for (isize x = 0; x < a.width(); x++) {
+            auto pa = a.load({x, y});
+            auto pb = b.load({x, y});
+            if (pa.red != pb.red or pa.green != pb.green or
+                pa.blue != pb.blue or pa.alpha != pb.alpha)
+                return false;
+        }
+    }
+
+    return true;
+}
+
+// The same picture, stored in all the ways the format allows.
+static Str const _VARIANTS[] = {
+    "valid/32bpp-320x240.bmp",
+    "valid/24bpp-topdown-320x240.bmp",
+    "valid/32bpp-topdown-320x240.bmp",
+    "valid/32bpp-101110-320x240.bmp",
+    "valid/555-320x240.bmp",
+    "valid/565-320x240.bmp",
+    "valid/8bpp-320x240.bmp",
+    "valid/8bpp-topdown-320x240.bmp",
+    "valid/8bpp-colorsused-zero.bmp",
+    "valid/4bpp-320x240.bmp",
+    "valid/rle8-encoded-320x240.bmp",
+    "valid/rle8-absolute-320x240.bmp",
+    "valid/rle4-encoded-320x240.bmp",
+    "valid/rle4-absolute-320x240.bmp",
+};
+
+test$(bmpDecodeVariants) {
+    auto ref = try$(_load("valid/24bpp-320x240.bmp"));
+
+    for (auto name : _VARIANTS) {
+        auto img = try$(_load(name));
+        expect$(_same(img, ref));
+    }
+
+    return Ok();
+}
+
+test$(bmpDecodeBgra) {
+    for (auto name : _VARIANTS) {
+        auto rgba = try$(_load(name));
+        auto bgra = try$(_load(name, Gfx::BGRA8888));
+        expect$(_same(rgba, bgra));
+    }
+
+    return Ok();
+}
+
+test$(bmpDecodeOddWidth) {
+    auto img = try$(_load("valid/24bpp-323x240.bmp"));
+    expectEq$(img.width(), 323);
+    expectEq$(img.height(), 240);
+    return Ok();
+}
+
+test$(bmpRejectCorrupt) {
+    Str const names[] = {
+        "corrupt/bitdepth-zero.bmp",
+        "corrupt/compression-unknown.bmp",
+        "corrupt/compression-bad-rle4-for-8bpp.bmp",
+        "corrupt/compression-bad-rle8-for-4bpp.bmp",
+        "corrupt/width-negative.bmp",
+        "corrupt/height-zero.bmp",
+        "corrupt/offbits-negative.bmp",
+        "corrupt/pixeldata-missing.bmp",
+    };
+
+    for (auto name : names)
+        expect$(not _load(name));
+
+    return Ok();
+}
+
+} // namespace Bmp::Tests
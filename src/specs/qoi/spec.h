@@ -69,7 +69,7 @@ struct Image : public Io::BChunk {
         MASK = 0b11000000,
     };
 
-    usize hash(Gfx::Color c) {
+    static usize hash(Gfx::Color c) {
         return c.red * 3 + c.green * 5 + c.blue * 7 + c.alpha * 11;
     }
 
@@ -133,4 +133,89 @@ struct Image : public Io::BChunk {
     }
 };
 
+static inline bool _same(Gfx::Color a, Gfx::Color b) {
+    return a.red == b.red and
+           a.green == b.green and
+           a.blue == b.blue and
+           a.alpha == b.alpha;
+}
+
+// Encodes the pixels as a 4 channels, sRGB image.
+[[gnu::flatten]] static inline void encode(Gfx::Pixels pixels, Io::BEmit &e) {
+    using Chunk = Image::Chunk;
+
+    e.writeBytes(bytes(Image::MAGIC));
+    e.writeU32be(pixels.width());
+    e.writeU32be(pixels.height());
+    e.writeU8be(4);
+    e.writeU8be(0);
+
+    usize run = 0;
+    Array<Gfx::Color, 64> index{};
+    Gfx::Color prev = Gfx::BLACK;
+
+    auto flushRun = [&] {
+        if (run > 0) {
+            e.writeU8be((u8)(Chunk::RUN | (run - 1)));
+            run = 0;
+        }
+    };
+
+    for (isize y = 0; y < pixels.height(); y++) {
+        for (isize x = 0; x < pixels.width(); x++) {
+            auto pixel = pixels.load({x, y});
+
+            if (_same(pixel, prev)) {
+                run++;
+                if (run == 62)
+                    flushRun();
+                continue;
+            }
+
+            flushRun();
+
+            auto i = Image::hash(pixel) % index.len();
+            if (_same(index[i], pixel)) {
+                e.writeU8be((u8)(Chunk::INDEX | i));
+                prev = pixel;
+                continue;
+            }
+            index[i] = pixel;
+
+            if (pixel.alpha != prev.alpha) {
+                e.writeU8be(Chunk::RGBA);
+                e.writeU8be(pixel.red);
+                e.writeU8be(pixel.green);
+                e.writeU8be(pixel.blue);
+                e.writeU8be(pixel.alpha);
+                prev = pixel;
+                continue;
+            }
+
+            i8 vr = (i8)(pixel.red - prev.red);
+            i8 vg = (i8)(pixel.green - prev.green);
+            i8 vb = (i8)(pixel.blue - prev.blue);
+            i8 vgr = (i8)(vr - vg);
+            i8 vgb = (i8)(vb - vg);
+
+            if (vr >= -2 and vr <= 1 and vg >= -2 and vg <= 1 and vb >= -2 and vb <= 1) {
+                e.writeU8be((u8)(Chunk::DIFF | (vr + 2) << 4 | (vg + 2) << 2 | (vb + 2)));
+            } else if (vg >= -32 and vg <= 31 and vgr >= -8 and vgr <= 7 and vgb >= -8 and vgb <= 7) {
+                e.writeU8be((u8)(Chunk::LUMA | (vg + 32)));
+                e.writeU8be((u8)((vgr + 8) << 4 | (vgb + 8)));
+            } else {
+                e.writeU8be(Chunk::RGB);
+                e.writeU8be(pixel.red);
+                e.writeU8be(pixel.green);
+                e.writeU8be(pixel.blue);
+            }
+
+            prev = pixel;
+        }
+    }
+
+    flushRun();
+    e.writeBytes(bytes(Image::END));
+}
+
 } // namespace Qoi
@@ -0,0 +1,66 @@
+#include <hjert-api/api.h>
+#include <karm-base/buf.h>
+#include <karm-base/size.h>
+#include <karm-logger/logger.h>
+#include <karm-main/main.h>
+
+namespace Grund::Bench {
+
+static constexpr usize PIPE_SIZE = mib(1);
+static constexpr usize CHUNK_SIZE = kib(64);
+static constexpr usize TOTAL = mib(256);
+
+// Entry point of the consumer task, it shares our address space
+// and reads everything that comes through the pipe.
+[[noreturn]] static void _consumer(Hj::Arg vmo) {
+    auto pipe = Hj::Pipe::open(Hj::Vmo{Hj::Cap{vmo}}).unwrap("failed to open pipe");
+    auto chunk = Buf<u8>::init(CHUNK_SIZE);
+
+    while (pipe.readSome(mutSub(chunk)).unwrap() != 0)
+        ;
+
+    Hj::Task::self().ret().unwrap();
+    while (true)
+        ;
+}
+
+} // namespace Grund::Bench
+
+using namespace Grund::Bench;
+
+Res<> entryPoint(Ctx &) {
+    try$(Hj::Task::self().label("grund-bench"));
+
+    auto pipe = try$(Hj::Pipe::create(PIPE_SIZE));
+    auto vmo = try$(Hj::Domain::self().attach(pipe._vmo));
+
+    logInfo("bench: starting the consumer...");
+    auto stackVmo = try$(Hj::Vmo::create(Hj::ROOT, 0, kib(64), Hj::VmoFlags::UPPER));
+    try$(stackVmo.label("stack"));
+    auto stack = try$(Hj::map(stackVmo, Hj::MapFlags::READ | Hj::MapFlags::WRITE));
+
+    auto consumer = try$(Hj::create<Hj::Task>(Hj::ROOT, Hj::ROOT, Hj::ROOT));
+    try$(consumer.label("grund-bench-consumer"));
+
+    auto listener = try$(Hj::Listener::create(Hj::ROOT));
+    try$(listener.listen(consumer, Hj::Sigs::EXITED, Hj::Sigs::NONE));
+
+    // NOTE: Leave room for a return address, as if _consumer was called.
+    try$(consumer.start((usize)_consumer, stack.range().end() - 8, {vmo.raw()}));
+
+    logInfo("bench: sending {}MiB in {}KiB chunks...", TOTAL / mib(1), CHUNK_SIZE / kib(1));
+    auto chunk = Buf<u8>::init(CHUNK_SIZE, 0x55);
+    auto start = try$(Hj::now());
+
+    for (usize sent = 0; sent < TOTAL; sent += CHUNK_SIZE)
+        try$(pipe.writeAll(sub(chunk)));
+    try$(pipe.close());
+
+    try$(listener.poll(TimeStamp::endOfTime()));
+    auto elapsed = try$(Hj::now()) - start;
+
+    auto usecs = max(elapsed.toUSecs(), 1uz);
+    logInfo("bench: {}MiB in {}ms, {}MiB/s", TOTAL / mib(1), elapsed.toMSecs(), (TOTAL / mib(1)) * 1000000 / usecs);
+
+    return Ok();
+}
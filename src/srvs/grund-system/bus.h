@@ -46,27 +46,45 @@ struct Bus {
         return Ok();
     }
 
-    Res<> broadcast(Hj::Cap from, Hj::Msg const &msg) {
-        for (auto &unit : _units)
-            if (unit->_out.cap() != from)
-                try$(unit->_in.send(msg, _domain));
+    Res<> broadcast(Hj::Cap from, Slice<Hj::Msg> msgs) {
+        for (auto &unit : _units) {
+            if (unit->_out.cap() == from)
+                continue;
+
+            if (try$(unit->_in.sendBatch(msgs, _domain)) != msgs.len())
+                return Error::wouldBlock("unit channel full");
+        }
 
         return Ok();
     }
 
+    // Receives everything that is waiting on the channel, the listener
+    // is edge triggered so it won't tell us about it again.
+    Res<> drain(Hj::Cap from) {
+        Array<Hj::Msg, 16> msgs;
+        Vec<Hj::Msg> broadcasts;
+
+        while (true) {
+            usize len = 0;
+            try$(Hj::_recvBatch(from, msgs.buf(), msgs.len(), &len, _domain));
+            if (len == 0)
+                return Ok();
+
+            broadcasts.clear();
+            for (usize i = 0; i < len; i++)
+                if (msgs[i].label == IBus::broadcast_UID)
+                    broadcasts.pushBack(msgs[i]);
+
+            if (broadcasts.len())
+                try$(broadcast(from, broadcasts));
+        }
+    }
+
     Res<> run() {
         while (true) {
             try$(_listener.poll(TimeStamp::endOfTime()));
-            auto ev = _listener.next();
-            while (ev) {
-                try$(Hj::_signal(ev->cap, Hj::Sigs::NONE, Hj::Sigs::READABLE));
-                Hj::Msg msg;
-                try$(Hj::_recv(ev->cap, &msg, _domain));
-                if (msg.label == IBus::broadcast_UID) {
-                    try$(broadcast(ev->cap, msg));
-                }
-                ev = _listener.next();
-            }
+            while (auto ev = _listener.next())
+                try$(drain(ev->cap));
         }
     }
 };